@@ -28,6 +28,7 @@
 class FAIMA2FStreamContextProvider;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogACEA2FCommon, Log, All);
+DECLARE_STATS_GROUP(TEXT("ACE"), STATGROUP_ACE, STATCAT_Advanced);
 
 class FA2FCommonModule : public IModuleInterface
 {
@@ -49,9 +49,24 @@ static TAutoConsoleVariable<bool> CVarDumpA2F(
 	ECVF_Default);
 #endif
 
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("A2F-3D Instance Wait Total (ms)"), STAT_ACEA2FInstanceWait, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("A2F-3D Instance Waits"), STAT_ACEA2FInstanceWaits, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("A2F-3D Streams Queued"), STAT_ACEA2FStreamsQueued, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("A2F-3D Contexts Live"), STAT_ACEA2FContextsLive, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("A2F-3D Contexts Free"), STAT_ACEA2FContextsFree, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("A2F-3D Contexts High Water"), STAT_ACEA2FContextsHighWater, STATGROUP_ACE);
+
 ////////////////////////////
 // FAIMInferenceInstanceRef
 
+FAIMInferenceInstanceRef::FAIMInferenceInstanceRef(FAIMInferenceInstance* InInstance) : RawInstance(InInstance)
+{
+	if (RawInstance != nullptr)
+	{
+		++RawInstance->NumRefs;
+	}
+}
+
 void FAIMInferenceInstanceRef::Reset()
 {
 	if (bOwned)
@@ -62,14 +77,24 @@ void FAIMInferenceInstanceRef::Reset()
 		}
 		bOwned = false;
 	}
+	if (RawInstance != nullptr)
+	{
+		--RawInstance->NumRefs;
+	}
 	RawInstance = nullptr;
 }
 
 FAIMInferenceInstanceRef& FAIMInferenceInstanceRef::operator=(FAIMInferenceInstanceRef&& Other)
 {
-	Reset();
-	RawInstance = MoveTemp(Other.RawInstance);
-	bOwned = MoveTemp(Other.bOwned);
+	if (this != &Other)
+	{
+		Reset();
+		RawInstance = Other.RawInstance;
+		bOwned = Other.bOwned;
+		// Other no longer refers to the instance, so it mustn't release it when it's destroyed
+		Other.RawInstance = nullptr;
+		Other.bOwned = false;
+	}
 	return *this;
 }
 
@@ -82,7 +107,20 @@ FAIMInferenceInstanceRef::operator nvaim::InferenceInstance* ()
 
 	if (!bOwned)
 	{
-		RawInstance->Guard.Lock();
+		if (!RawInstance->Guard.TryLock())
+		{
+			// Another stream is using this instance, so we have to queue up behind it. Track how long that takes so
+			// that it's visible when a provider needs more instances.
+			INC_DWORD_STAT(STAT_ACEA2FStreamsQueued);
+			const double WaitStartTime = FPlatformTime::Seconds();
+			RawInstance->Guard.Lock();
+			const double WaitSeconds = FPlatformTime::Seconds() - WaitStartTime;
+			DEC_DWORD_STAT(STAT_ACEA2FStreamsQueued);
+			INC_DWORD_STAT(STAT_ACEA2FInstanceWaits);
+			INC_FLOAT_STAT_BY(STAT_ACEA2FInstanceWait, static_cast<float>(WaitSeconds * 1000.0));
+			UE_LOG(LogACEA2FCommon, Verbose, TEXT("waited %.1f ms for a busy A2F-3D inference instance (%d streams assigned to it)"),
+				WaitSeconds * 1000.0, RawInstance->NumRefs.load());
+		}
 		bOwned = true;
 	}
 
@@ -149,7 +187,7 @@ FAIMA2FStreamContextProvider* FAIMA2FStreamContextProvider::Get()
 }
 
 FAIMA2FStreamContext* FAIMA2FStreamContextProvider::CreateA2FContext(FName ProviderName, IACEAnimDataConsumer* CallbackObject,
-	FAIMInferenceInstance& InInstance, TOptional<TMap<FString, float>> InDefaultFaceParams)
+	TArrayView<FAIMInferenceInstance* const> InInstances, TOptional<TMap<FString, float>> InDefaultFaceParams)
 {
 	FAnimDataConsumerRegistry* Registry = FAnimDataConsumerRegistry::Get();
 	if (Registry == nullptr)
@@ -159,28 +197,52 @@ FAIMA2FStreamContext* FAIMA2FStreamContextProvider::CreateA2FContext(FName Provi
 
 	UE::TScopeLock Lock(ContextArrayGuard);
 
-	// first look for an available entry to reuse
-	for (FAIMA2FStreamContext &Context : Contexts)
+	// Assign the instance with the fewest streams already assigned to it, so that concurrent streams spread out over the
+	// provider's pool instead of queuing behind each other. Every new reference to an instance is created while holding
+	// ContextArrayGuard, so the counts can't change from under us between choosing an instance and allocating the context.
+	FAIMInferenceInstance* LeastLoadedInstance = nullptr;
+	for (FAIMInferenceInstance* Instance : InInstances)
 	{
-		if (Context.TryAllocate(ProviderName, CallbackObject, InInstance, InDefaultFaceParams))
+		if ((Instance != nullptr) && ((LeastLoadedInstance == nullptr) || (Instance->GetNumRefs() < LeastLoadedInstance->GetNumRefs())))
 		{
-			return &Context;
+			LeastLoadedInstance = Instance;
 		}
 	}
+	if (!ensure(LeastLoadedInstance != nullptr))
+	{
+		return nullptr;
+	}
+	FAIMInferenceInstance& InInstance = *LeastLoadedInstance;
 
-	// no suitable entry, so create a new one
-	int32 NewIdx = Contexts.Add();
-	FAIMA2FStreamContext &Context = Contexts[NewIdx];
-	if (ensure(Context.TryAllocate(ProviderName, CallbackObject, InInstance, InDefaultFaceParams)))
+	// first look for an available entry to reuse
+	FAIMA2FStreamContext* Context = PopFreeContext();
+	if (Context == nullptr)
 	{
-		return &Context;
+		// no available entry, so create a new one
+		int32 NewIdx = Contexts.Add();
+		Context = &Contexts[NewIdx];
+		Context->Owner = this;
+
+		UE::TScopeLock FreeListLock(FreeListGuard);
+		++NumContexts;
+		HighWaterLiveContexts = FMath::Max(HighWaterLiveContexts, NumContexts - FreeContexts.Num());
+		UpdateContextStats();
 	}
 
+	if (ensure(Context->TryAllocate(ProviderName, CallbackObject, InInstance, InDefaultFaceParams)))
+	{
+		return Context;
+	}
+
+	// still available, so put it back
+	ReleaseContext(Context);
 	return nullptr;
 }
 
 void FAIMA2FStreamContextProvider::KillAllActiveContexts(FName ProviderName)
 {
+	// Only happens when a provider shuts down, so it's fine to visit every context. Killed contexts return themselves
+	// to the free list.
 	UE::TScopeLock Lock(ContextArrayGuard);
 	for (FAIMA2FStreamContext &Context : Contexts)
 	{
@@ -188,6 +250,58 @@ void FAIMA2FStreamContextProvider::KillAllActiveContexts(FName ProviderName)
 	}
 }
 
+int32 FAIMA2FStreamContextProvider::GetNumLiveContexts() const
+{
+	UE::TScopeLock FreeListLock(FreeListGuard);
+	return NumContexts - FreeContexts.Num();
+}
+
+int32 FAIMA2FStreamContextProvider::GetNumFreeContexts() const
+{
+	UE::TScopeLock FreeListLock(FreeListGuard);
+	return FreeContexts.Num();
+}
+
+int32 FAIMA2FStreamContextProvider::GetHighWaterLiveContexts() const
+{
+	UE::TScopeLock FreeListLock(FreeListGuard);
+	return HighWaterLiveContexts;
+}
+
+FAIMA2FStreamContext* FAIMA2FStreamContextProvider::PopFreeContext()
+{
+	UE::TScopeLock FreeListLock(FreeListGuard);
+	if (FreeContexts.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	FAIMA2FStreamContext* Context = FreeContexts.Pop();
+	Context->bOnFreeList = false;
+	HighWaterLiveContexts = FMath::Max(HighWaterLiveContexts, NumContexts - FreeContexts.Num());
+	UpdateContextStats();
+	return Context;
+}
+
+void FAIMA2FStreamContextProvider::ReleaseContext(FAIMA2FStreamContext* Context)
+{
+	UE::TScopeLock FreeListLock(FreeListGuard);
+	if (!Context->bOnFreeList)
+	{
+		Context->bOnFreeList = true;
+		FreeContexts.Push(Context);
+		UpdateContextStats();
+	}
+}
+
+void FAIMA2FStreamContextProvider::UpdateContextStats() const
+{
+	// note: FreeListGuard must be locked when calling this function
+	SET_DWORD_STAT(STAT_ACEA2FContextsLive, NumContexts - FreeContexts.Num());
+	SET_DWORD_STAT(STAT_ACEA2FContextsFree, FreeContexts.Num());
+	SET_DWORD_STAT(STAT_ACEA2FContextsHighWater, HighWaterLiveContexts);
+}
+
 
 //////////////////
 // FAIMA2FStreamContext
@@ -217,6 +331,19 @@ void FAIMA2FStreamContext::EnqueueOriginalSamples(TArrayView<const uint8> InOrig
 	FScopeLock Lock(&CS);
 	if (Denominator != 0)
 	{
+		// Drop audio the consumer already has. No chunk can be referencing it since we hold CS. We only compact once at
+		// least half the window is stale, so the cost of moving the remaining bytes is amortized over the bytes dropped
+		// and the allocation settles at around twice the audio in flight.
+		const int32 NumReleased = static_cast<int32>(OriginalSamplesReleased - OriginalSamplesStart);
+		if ((NumReleased > 0) && (NumReleased >= OriginalSamples.Num() / 2))
+		{
+#if UE_VERSION_OLDER_THAN(5,4,0)
+			OriginalSamples.RemoveAt(0, NumReleased, false);
+#else
+			OriginalSamples.RemoveAt(0, NumReleased, EAllowShrinking::No);
+#endif
+			OriginalSamplesStart += NumReleased;
+		}
 		OriginalSamples.Append(InOriginalSamples);
 	}
 }
@@ -508,6 +635,8 @@ void FAIMA2FStreamContext::Reset(EState NewState)
 {
 	// note: CS must be locked when calling this function
 	OriginalSamples.Empty();
+	OriginalSamplesStart = 0;
+	OriginalSamplesReleased = 0;
 	ReceivedAudioSampleCount = 0;
 	Numerator = 0;
 	Denominator = 0;
@@ -593,6 +722,12 @@ void FAIMA2FStreamContext::Reset(EState NewState)
 		bSentCompleteAudio = false;
 		bReceivedCompleteStream = false;
 #endif
+
+		// we're reusable now. Anyone popping us off the free list has to lock CS before using us, so they'll see the new state
+		if ((State != EState::Available) && (Owner != nullptr))
+		{
+			Owner->ReleaseContext(this);
+		}
 	}
 	State = NewState;
 }
@@ -654,32 +789,35 @@ FACEAnimDataChunk FAIMA2FStreamContext::CreateChunkFromAIMOutputs(nvaim::Inferen
 		bool bUsePassthroughAudio = (Denominator != 0);
 		if (bUsePassthroughAudio)
 		{
-			// convert a received sample index to an original sample index
+			// convert a received sample index to an absolute original sample index
 			auto ToOriginalIdx = [this](int32 ReceivedIdx)
 			{
-				int32 OriginalIdx = static_cast<int32>(static_cast<int64>(Numerator) * ReceivedIdx / Denominator);
+				int64 OriginalIdx = static_cast<int64>(Numerator) * ReceivedIdx / Denominator;
 				// take into account that the result needs to be a multiple of the original sample size in bytes times the number of channels
 				return OriginalIdx - (OriginalIdx % OriginalSampleQuantum);
 			};
 
 			// Use the saved original samples and pass them through to the consumer
-			int32 FirstOriginalIdx = ToOriginalIdx(ReceivedAudioSampleCount);
-			int32 LastOriginalIdx = ToOriginalIdx(NextReceivedAudioSampleCount);
+			const int64 OriginalSamplesEnd = OriginalSamplesStart + OriginalSamples.Num();
+			int64 FirstOriginalIdx = FMath::Max(ToOriginalIdx(ReceivedAudioSampleCount), OriginalSamplesStart);
+			int64 LastOriginalIdx = ToOriginalIdx(NextReceivedAudioSampleCount);
 
-			if (LastOriginalIdx > OriginalSamples.Num())
+			if (LastOriginalIdx > OriginalSamplesEnd)
 			{
 				// This is normal behavior, since the Audio2Face-3D service can send back more audio than we send out.
 				// The service adds silence to the end of the buffer.
 				UE_LOG(LogACEA2FCommon, VeryVerbose,
-					TEXT("[ACE SID %d] received more audio from Audio2Face-3D service (%d samples) than original audio (%d samples)"),
-					StreamID, NextReceivedAudioSampleCount, OriginalSamples.Num());
-				LastOriginalIdx = OriginalSamples.Num();
+					TEXT("[ACE SID %d] received more audio from Audio2Face-3D service (%d samples) than original audio (%lld samples)"),
+					StreamID, NextReceivedAudioSampleCount, OriginalSamplesEnd);
+				LastOriginalIdx = OriginalSamplesEnd;
 			}
-			int32 ByteCount = LastOriginalIdx - FirstOriginalIdx;
+			int32 ByteCount = static_cast<int32>(LastOriginalIdx - FirstOriginalIdx);
 			if (ByteCount > 0)
 			{
-				const uint8* Start = &OriginalSamples[FirstOriginalIdx];
+				const uint8* Start = &OriginalSamples[static_cast<int32>(FirstOriginalIdx - OriginalSamplesStart)];
 				Chunk.AudioBuffer = TArrayView<const uint8>(Start, ByteCount);
+				// everything up to here is the consumer's now, so it can be dropped from the window once this chunk is delivered
+				OriginalSamplesReleased = LastOriginalIdx;
 			}
 			else
 			{
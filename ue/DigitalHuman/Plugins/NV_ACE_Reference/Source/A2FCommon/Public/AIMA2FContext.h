@@ -57,16 +57,24 @@ namespace nvaim
 // own associated FAIMInferenceInstanceRef.
 //
 // The optional CreateFn will be used to recreate a destroyed instance if necessary.
+//
+// A provider may own several of these to run more than one stream at a time. See
+// FAIMA2FStreamContextProvider::CreateA2FContext.
 class A2FCOMMON_API FAIMInferenceInstance : FNoncopyable
 {
 public:
 	FAIMInferenceInstance(nvaim::InferenceInstance* InInstance, TFunction<nvaim::InferenceInstance*()> InCreateFn)
 		: Instance(InInstance), CreateFn(InCreateFn) {}
 
+	// Number of FAIMInferenceInstanceRefs currently pointing at this instance, whether they own it yet or are still
+	// waiting for it. Used to pick the least loaded instance for a new stream.
+	int32 GetNumRefs() const { return NumRefs; }
+
 private:
 	UE::FMutex Guard{};
 	nvaim::InferenceInstance* Instance = nullptr;
 	const TFunction<nvaim::InferenceInstance* ()> CreateFn;
+	std::atomic<int32> NumRefs = 0;
 	friend class FAIMInferenceInstanceRef;
 };
 
@@ -83,10 +91,12 @@ public:
 		Reset();
 	}
 
-	FAIMInferenceInstanceRef(FAIMInferenceInstance* InInstance = nullptr) : RawInstance(InInstance) {}
+	FAIMInferenceInstanceRef(FAIMInferenceInstance* InInstance = nullptr);
 
 	// move assignment is the only assignment allowed
 	FAIMInferenceInstanceRef& operator=(FAIMInferenceInstanceRef&& Other);
+	FAIMInferenceInstanceRef(const FAIMInferenceInstanceRef&) = delete;
+	FAIMInferenceInstanceRef& operator=(const FAIMInferenceInstanceRef&) = delete;
 
 	bool IsValid() const
 	{
@@ -149,7 +159,13 @@ public:
 private:
 	mutable FCriticalSection CS{};
 	mutable FCriticalSection EndStreamCS{};
+	// Sliding window over the original audio of the stream. OriginalSamples[0] is the byte at absolute stream position
+	// OriginalSamplesStart. Bytes before OriginalSamplesReleased were already passed on to the consumer and get dropped
+	// from the front of the window the next time new samples are enqueued, so the window only holds audio that's in
+	// flight to the A2F-3D service.
 	TArray<uint8> OriginalSamples{};
+	int64 OriginalSamplesStart = 0;
+	int64 OriginalSamplesReleased = 0;
 #if ALLOW_DUMPING_A2F
 	bool bSentCompleteAudio = false;
 	bool bReceivedCompleteStream = false;
@@ -177,6 +193,11 @@ private:
 	FAIMInferenceInstanceRef AIMInstance{};
 	EState State = EState::Available;
 
+	// set once when the provider creates this context, so the context can return itself to the provider's free list
+	class FAIMA2FStreamContextProvider* Owner = nullptr;
+	// protected by the owner's FreeListGuard, not CS
+	bool bOnFreeList = false;
+
 private:
 	void Reset(EState NewState);
 	FACEAnimDataChunk CreateChunkFromAIMOutputs(nvaim::InferenceExecutionState AIMState);
@@ -198,16 +219,34 @@ public:
 	static FAIMA2FStreamContextProvider* Get();
 
 	// meant to be called from A2F provider's CreateA2FStream
+	// InInstances: the provider's pool of instances, the new context is assigned the least loaded one
 	// InDefaultFaceParams: if provided, context will set the default values before sending chunks
-	FAIMA2FStreamContext* CreateA2FContext(FName ProviderName, IACEAnimDataConsumer* CallbackObject, FAIMInferenceInstance& InInstance,
+	FAIMA2FStreamContext* CreateA2FContext(FName ProviderName, IACEAnimDataConsumer* CallbackObject, TArrayView<FAIMInferenceInstance* const> InInstances,
 		TOptional<TMap<FString, float>> InDefaultFaceParams);
 
 	// when an A2F provider is shutting down, use this to ensure that it doesn't hold any active contexts
 	void KillAllActiveContexts(FName ProviderName);
 
+	// context pool counters
+	int32 GetNumLiveContexts() const;
+	int32 GetNumFreeContexts() const;
+	int32 GetHighWaterLiveContexts() const;
+
 private:
 	// chunked array so that the memory won't be reallocated or moved around, since pointers to things in this array will come back via callback
 	TChunkedArray<FAIMA2FStreamContext> Contexts;
 	UE::FMutex ContextArrayGuard{};
+
+	// Contexts in the Available state, so allocation doesn't need to search Contexts. Contexts push themselves here
+	// while holding their own CS, so FreeListGuard must never be held while locking a context.
+	TArray<FAIMA2FStreamContext*> FreeContexts;
+	mutable UE::FMutex FreeListGuard{};
+	int32 NumContexts = 0;
+	int32 HighWaterLiveContexts = 0;
+
+	FAIMA2FStreamContext* PopFreeContext();
+	void ReleaseContext(FAIMA2FStreamContext* Context);
+	void UpdateContextStats() const;
+	friend struct FAIMA2FStreamContext;
 };
 
@@ -25,6 +25,7 @@
 
 // engine includes
 #include "Containers/StringConv.h"
+#include "HAL/IConsoleManager.h"
 
 // plugin includes
 #include "A2FLocalModule.h"
@@ -39,6 +40,12 @@
 #include "nvaim_cuda.h"
 
 
+static TAutoConsoleVariable<int32> CVarA2FLocalInstances(
+	TEXT("a2f3d.local.instances"),
+	1,
+	TEXT("Number of Audio2Face-3D local inference instances per provider. Each instance can animate one stream at a time and needs its own VRAM budget. (default: 1)"),
+	ECVF_Default);
+
 //////
 // FA2FLocal implementation
 
@@ -87,9 +94,11 @@ IA2FProvider::IA2FStream* FA2FLocal::CreateA2FStream(IACEAnimDataConsumer* Callb
 {
 	bool bInstanceAvailable = IsA2FInstanceAvailable();
 	FAIMA2FStreamContextProvider* ContextProvider = FAIMA2FStreamContextProvider::Get();
-	if ((ContextProvider != nullptr) && bInstanceAvailable && Instance.IsValid())
+	TArray<FAIMInferenceInstance*, TInlineAllocator<8>> AvailableInstances;
+	GetInstances(AvailableInstances);
+	if ((ContextProvider != nullptr) && bInstanceAvailable && !AvailableInstances.IsEmpty())
 	{
-		return ContextProvider->CreateA2FContext(ProviderName, CallbackObject, *Instance, FaceParameterDefaults);
+		return ContextProvider->CreateA2FContext(ProviderName, CallbackObject, AvailableInstances, FaceParameterDefaults);
 	}
 
 	return nullptr;
@@ -154,17 +163,29 @@ void FA2FLocal::AllocateResources()
 
 void FA2FLocal::FreeResources()
 {
-	if (Instance.IsValid())
+	TArray<FAIMInferenceInstance*, TInlineAllocator<8>> InstancesToFree;
+	GetInstances(InstancesToFree);
+	for (FAIMInferenceInstance* Instance : InstancesToFree)
 	{
 		UE_LOG(LogACEA2FLocal, Log, TEXT("Removal of instance of %s requested"), *GetName().ToString());
 		// safely remove local execution instance
-		FAIMInferenceInstanceRef InstanceRef(Instance.Get());
+		FAIMInferenceInstanceRef InstanceRef(Instance);
 		InstanceRef.DestroyInstance(Interface);
 		UE_LOG(LogACEA2FLocal, Log, TEXT("Instance of %s removed"), *GetName().ToString());
 	}
 
 }
 
+void FA2FLocal::GetInstances(TArray<FAIMInferenceInstance*, TInlineAllocator<8>>& OutInstances)
+{
+	FScopeLock Lock(&InstanceCreationCS);
+	OutInstances.Reset();
+	for (const TPimplPtr<FAIMInferenceInstance>& Instance : Instances)
+	{
+		OutInstances.Add(Instance.Get());
+	}
+}
+
 #define AIM_RETURNS_GARBAGE_AUDIO 1
 
 void FA2FLocal::SetOriginalAudioParams(IA2FStream* Stream, uint32 SampleRate, int32 NumChannels, int32 SampleByteSize)
@@ -365,23 +386,32 @@ bool FA2FLocal::IsA2FInstanceAvailable()
 
 	if (Interface != nullptr)
 	{
-		if (!Instance.IsValid())
+		// grow the pool up to the requested size. Instances are never removed from the pool since streams may still
+		// reference them, FreeResources only destroys the underlying AIM instances
+		const int32 NumInstancesWanted = FMath::Max(1, CVarA2FLocalInstances.GetValueOnAnyThread());
+		while ((Instances.Num() < NumInstancesWanted) && !bInstancePoolLimitReached)
 		{
 			nvaim::InferenceInstance* RawInstance = CreateA2FInstanceInternal(Interface, ModelDir, ModelGUID);
 			if (RawInstance != nullptr)
 			{
-				Instance = MakePimpl<FAIMInferenceInstance>(RawInstance, [this]() {
+				Instances.Add(MakePimpl<FAIMInferenceInstance>(RawInstance, [this]() {
 					FScopeLock Lock(&InstanceCreationCS);
 					return CreateA2FInstanceInternal(Interface, ModelDir, ModelGUID);
-				});
+				}));
 			}
 			else
 			{
-				Instance.Reset();
+				if (!Instances.IsEmpty())
+				{
+					UE_LOG(LogACEA2FLocal, Warning, TEXT("Only able to create %d of %d requested %s instances"),
+						Instances.Num(), NumInstancesWanted, *ProviderName.ToString());
+					bInstancePoolLimitReached = true;
+				}
+				break;
 			}
 		}
 	}
 
-	return Instance.IsValid();
+	return !Instances.IsEmpty();
 }
 
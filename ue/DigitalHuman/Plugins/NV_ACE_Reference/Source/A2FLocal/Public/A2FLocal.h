@@ -105,11 +105,15 @@ private:
 
 	FCriticalSection InstanceCreationCS{};
 	nvaim::InferenceInterface* Interface = nullptr;
-	TPimplPtr<class FAIMInferenceInstance> Instance;
+	// pool of inference instances, each can run one stream at a time. Only ever grows, so pointers to elements stay valid
+	TArray<TPimplPtr<class FAIMInferenceInstance>> Instances;
+	// stop trying to grow the pool once we've failed to create an instance, likely out of VRAM
+	bool bInstancePoolLimitReached = false;
 
 private:
 
 	bool IsA2FInstanceAvailable();
+	void GetInstances(TArray<class FAIMInferenceInstance*, TInlineAllocator<8>>& OutInstances);
 
 };
 
@@ -26,6 +26,7 @@
 // engine includes
 #include "Containers/StringConv.h"
 #include "GenericPlatform/GenericPlatformHttp.h"
+#include "HAL/IConsoleManager.h"
 
 // plugin includes
 #include "A2FRemoteModule.h"
@@ -43,6 +44,12 @@
 
 static const FName GRemoteA2FProviderName = FName(TEXT("RemoteA2F"));
 
+static TAutoConsoleVariable<int32> CVarA2FRemoteConnections(
+	TEXT("a2f3d.remote.connections"),
+	2,
+	TEXT("Number of connections to the Audio2Face-3D service. Each connection can animate one stream at a time. (default: 2)"),
+	ECVF_Default);
+
 static FString GetConnectionInfoString(const FACEConnectionInfo& Connection)
 {
 	FString Result = FString::Printf(TEXT("URL:\"%s\""), *Connection.DestURL);
@@ -95,13 +102,9 @@ FA2FRemote::~FA2FRemote()
 			ContextProvider->KillAllActiveContexts(GRemoteA2FProviderName);
 		}
 
-		if (Connection.IsValid())
-		{
-			// close connection
-			FAIMInferenceInstanceRef ConnectionRef(Connection.Get());
-			ConnectionRef.DestroyInstance(Interface);
-		}
-		Connection.Reset();
+		// close connections
+		FreeResources();
+		Connections.Reset();
 
 		// unload feature interface
 		FAIMModule::Get().UnloadAIMFeature(nvaim::plugin::a2x::cloud::grpc::kId, Interface);
@@ -112,9 +115,11 @@ IA2FProvider::IA2FStream* FA2FRemote::CreateA2FStream(IACEAnimDataConsumer* Call
 {
 	bool bConnectionAvailable = IsConnectionAvailable();
 	FAIMA2FStreamContextProvider* ContextProvider = FAIMA2FStreamContextProvider::Get();
-	if ((ContextProvider != nullptr) && bConnectionAvailable && Connection.IsValid())
+	TArray<FAIMInferenceInstance*, TInlineAllocator<8>> AvailableConnections;
+	GetConnections(AvailableConnections);
+	if ((ContextProvider != nullptr) && bConnectionAvailable && !AvailableConnections.IsEmpty())
 	{
-		return ContextProvider->CreateA2FContext(GRemoteA2FProviderName, CallbackObject, *Connection, NullOpt);
+		return ContextProvider->CreateA2FContext(GRemoteA2FProviderName, CallbackObject, AvailableConnections, NullOpt);
 	}
 
 	return nullptr;
@@ -164,16 +169,28 @@ FName FA2FRemote::GetName() const
 
 void FA2FRemote::FreeResources()
 {
-	if (Connection.IsValid())
+	TArray<FAIMInferenceInstance*, TInlineAllocator<8>> ConnectionsToFree;
+	GetConnections(ConnectionsToFree);
+	for (FAIMInferenceInstance* Connection : ConnectionsToFree)
 	{
 		UE_LOG(LogACEA2FRemote, Log, TEXT("Disconnection of %s requested"), *GetName().ToString());
 		// safely disconnect from service
-		FAIMInferenceInstanceRef ConnectionRef(Connection.Get());
+		FAIMInferenceInstanceRef ConnectionRef(Connection);
 		ConnectionRef.DestroyInstance(Interface);
 		UE_LOG(LogACEA2FRemote, Log, TEXT("%s disconnected"), *GetName().ToString());
 	}
 }
 
+void FA2FRemote::GetConnections(TArray<FAIMInferenceInstance*, TInlineAllocator<8>>& OutConnections)
+{
+	FScopeLock Lock(&ConnectionsCS);
+	OutConnections.Reset();
+	for (const TPimplPtr<FAIMInferenceInstance>& Connection : Connections)
+	{
+		OutConnections.Add(Connection.Get());
+	}
+}
+
 void FA2FRemote::SetConnectionInfo(const FString& URL, const FString& APIKey, const FString& NvCFFunctionId, const FString& NvCFFunctionVersion)
 {
 	ACEOverrideConnectionInfo.DestURL = URL;
@@ -312,35 +329,50 @@ bool FA2FRemote::IsConnectionAvailable()
 	{
 		FACEConnectionInfo NewConnectionInfo = GetConnectionInfo();
 		bool bConnectionInfoChanged = ACEConnectionInfo != NewConnectionInfo;
-		if (bConnectionInfoChanged && Connection.IsValid())
+		TArray<FAIMInferenceInstance*, TInlineAllocator<8>> ExistingConnections;
+		GetConnections(ExistingConnections);
+		if (bConnectionInfoChanged && !ExistingConnections.IsEmpty())
 		{
 			// Unfortunately AIM doesn't allow connecting to multiple servers simultaneously, so this could block until other
 			// connections are done
-			FAIMInferenceInstanceRef ConnectionRef(Connection.Get());
-			UE_LOG(LogACEA2FRemote, Log, TEXT("Connection info changed, closing previous A2F-3D connection"));
-			ConnectionRef.DestroyInstance(Interface);
-			const nvaim::InferenceInstance* NoConnection = nullptr;
-			if (ConnectionRef == NoConnection)
+			UE_LOG(LogACEA2FRemote, Log, TEXT("Connection info changed, closing previous A2F-3D connections"));
+			bConnectionPoolLimitReached = false;
+			for (FAIMInferenceInstance* Connection : ExistingConnections)
 			{
-				return false;
+				FAIMInferenceInstanceRef ConnectionRef(Connection);
+				ConnectionRef.DestroyInstance(Interface);
+				const nvaim::InferenceInstance* NoConnection = nullptr;
+				if (ConnectionRef == NoConnection)
+				{
+					return false;
+				}
 			}
 		}
 
-		if (!Connection.IsValid())
+		// grow the pool up to the requested size. Connections are never removed from the pool since streams may still
+		// reference them, FreeResources only disconnects them
+		const int32 NumConnectionsWanted = FMath::Max(1, CVarA2FRemoteConnections.GetValueOnAnyThread());
+		while ((ExistingConnections.Num() < NumConnectionsWanted) && !bConnectionPoolLimitReached)
 		{
 			nvaim::InferenceInstance* RawConnection = CreateConnection();
-			if (RawConnection != nullptr)
+			if (RawConnection == nullptr)
 			{
-				Connection = MakePimpl<FAIMInferenceInstance>(RawConnection, [this]() { return CreateConnection(); });
-			}
-			else
-			{
-				Connection.Reset();
+				if (!ExistingConnections.IsEmpty())
+				{
+					UE_LOG(LogACEA2FRemote, Warning, TEXT("Only able to open %d of %d requested A2F-3D connections"), ExistingConnections.Num(), NumConnectionsWanted);
+					bConnectionPoolLimitReached = true;
+				}
+				break;
 			}
+			FScopeLock ConnectionsLock(&ConnectionsCS);
+			Connections.Add(MakePimpl<FAIMInferenceInstance>(RawConnection, [this]() { return CreateConnection(); }));
+			ExistingConnections.Add(Connections.Last().Get());
 		}
+
+		return !ExistingConnections.IsEmpty();
 	}
 
-	return Connection.IsValid();
+	return false;
 }
 
 nvaim::InferenceInstance* FA2FRemote::CreateConnection()
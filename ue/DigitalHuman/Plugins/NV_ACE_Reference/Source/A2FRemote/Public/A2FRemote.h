@@ -114,7 +114,11 @@ private:
 	bool bIsFeatureAvailable = false;
 
 	nvaim::InferenceInterface* Interface = nullptr;
-	TPimplPtr<class FAIMInferenceInstance> Connection;
+	// pool of connections, each can run one stream at a time. Only ever grows, so pointers to elements stay valid
+	TArray<TPimplPtr<class FAIMInferenceInstance>> Connections;
+	FCriticalSection ConnectionsCS{};
+	// stop trying to grow the pool once the service has refused a connection, until the connection info changes
+	bool bConnectionPoolLimitReached = false;
 	FACEConnectionInfo ACEConnectionInfo;
 	FACEConnectionInfo ACEOverrideConnectionInfo;
 
@@ -122,6 +126,7 @@ private:
 
 	bool IsConnectionAvailable();
 	nvaim::InferenceInstance* CreateConnection();
+	void GetConnections(TArray<class FAIMInferenceInstance*, TInlineAllocator<8>>& OutConnections);
 
 };
 
@@ -27,17 +27,36 @@
 #include "ACECoreModulePrivate.h"
 #include "AnimDataConsumerRegistry.h"
 
+// engine includes
+#include "Misc/ScopeRWLock.h"
+
+/////////////////////
+// FACEAnimDataChunk
+
+TArrayView<const uint8> FACEAnimDataChunk::GetSilencePage()
+{
+	// 4 KiB covers a typical 30 fps frame of 16 kHz int16 audio several times over
+	alignas(16) static const uint8 SilencePage[4096] = {};
+	return MakeArrayView(SilencePage, UE_ARRAY_COUNT(SilencePage));
+}
+
 /////////////////////////////
 // FAnimDataConsumerRegistry
 
 // Important structures used by this class:
 //
-// - ActiveConsumers: set of all active IACEAnimDataConsumer objects. Self-registered through ctor/dtor. Protected by critical section.
+// - ActiveConsumers: maps all active IACEAnimDataConsumer objects to their FConsumerSlot. Self-registered through ctor/dtor. Protected by DataLock.
+//
+// - StreamToConsumerMap: used to find the FConsumerSlot to call into for a given stream ID. Currently we only support a single consumer per stream,
+// but in the future we may expand this to an array of consumers for a single stream. Protected by DataLock.
 //
-// - StreamToConsumerMap: used to find all IACEAnimDataConsumers to call into for a given stream ID. Currently we only support a single consumer per stream,
-// but in the future we may expand this to an array of consumers for a single stream. Protected by critical section.
+// - ConsumerToStreamMap: guaranteed to map only from active IACEAnimDataConsumer objects. Protected by DataLock.
 //
-// - ConsumerToStreamMap: guaranteed to map only from active IACEAnimDataConsumer objects. Protected by critical section.
+// - FConsumerSlot: per-consumer handle. Callbacks into a consumer are made while holding only the slot's CallbackCS, so
+// streams delivering to different consumers never contend with each other beyond a short read lock on DataLock.
+// FConsumerSlot::StreamID is the authoritative record of which stream the consumer is currently receiving. A sender
+// that resolved a slot just before the stream was detached will see a mismatched StreamID (or a null Consumer after
+// unregistration) once it acquires CallbackCS, and drops the chunk.
 
 FAnimDataConsumerRegistry* FAnimDataConsumerRegistry::Get()
 {
@@ -57,37 +76,43 @@ int32 FAnimDataConsumerRegistry::CreateStream_AnyThread()
 
 void FAnimDataConsumerRegistry::RemoveStream_AnyThread(int32 StreamID)
 {
-	IACEAnimDataConsumer* Consumer = nullptr;
-	// Find any mapped consumers while removing the stream ID from the map
-	FScopeLock Lock(&DataCS);
-	StreamToConsumerMap.RemoveAndCopyValue(StreamID, Consumer);
-	if (Consumer != nullptr)
+	// Find any mapped consumer while removing the stream ID from the map
+	FConsumerSlotPtr Slot;
 	{
-		// if there was a consumer, remove consumer → stream mapping also
-		int32 NumRemoved = ConsumerToStreamMap.Remove(Consumer);
+		FWriteScopeLock Lock(DataLock);
+		StreamToConsumerMap.RemoveAndCopyValue(StreamID, Slot);
+		if (Slot.IsValid())
+		{
+			// if there was a consumer, remove consumer → stream mapping also
+			int32* MappedStreamID = ConsumerToStreamMap.Find(Slot->Consumer);
+			if ((MappedStreamID != nullptr) && (*MappedStreamID == StreamID))
+			{
+				ConsumerToStreamMap.Remove(Slot->Consumer);
+			}
+		}
+	}
 
-		if (ensure(NumRemoved > 0))
+	if (Slot.IsValid())
+	{
+		FScopeLock CallbackLock(&Slot->CallbackCS);
+		if ((Slot->Consumer != nullptr) && (Slot->StreamID == StreamID))
 		{
 			UE_LOG(LogACECore, Verbose, TEXT("[ACE SID %d] RemoveStream called, notifying consumer"), StreamID);
 			// notify consumer that stream is done
-			CancelStreamToConsumer_AnyThread(StreamID, Consumer);
+			CancelStreamToConsumer_AnyThread(StreamID, *Slot);
 		}
 	}
 }
 
 void FAnimDataConsumerRegistry::SetAudioParams_AnyThread(int32 StreamID, uint32 NewSampleRate, int32 NewNumChannels, int32 SampleByteSize)
 {
-	IACEAnimDataConsumer** Consumer = nullptr;
+	FConsumerSlotPtr Slot = FindSlotForStream_AnyThread(StreamID);
+	if (Slot.IsValid())
 	{
-		FScopeLock Lock(&DataCS);
-		Consumer = StreamToConsumerMap.Find(StreamID);
-		if ((Consumer != nullptr) && ((*Consumer) != nullptr))
+		FScopeLock CallbackLock(&Slot->CallbackCS);
+		if ((Slot->Consumer != nullptr) && (Slot->StreamID == StreamID))
 		{
-			bool bConsumerActive = ConsumerToStreamMap.Contains(*Consumer);
-			if (ensure(bConsumerActive))
-			{
-				(*Consumer)->PrepareNewStream_AnyThread(StreamID, NewSampleRate, NewNumChannels, SampleByteSize);
-			}
+			Slot->Consumer->PrepareNewStream_AnyThread(StreamID, NewSampleRate, NewNumChannels, SampleByteSize);
 		}
 	}
 }
@@ -96,25 +121,40 @@ void FAnimDataConsumerRegistry::AttachConsumerToStream_AnyThread(int32 StreamID,
 {
 	check(Consumer != nullptr);
 
-	FScopeLock Lock(&DataCS);
-	if (!ActiveConsumers.Contains(Consumer))
+	FConsumerSlotPtr Slot = FindSlotForConsumer_AnyThread(Consumer);
+	if (!Slot.IsValid())
 	{
 		return;
 	}
 
-	StreamToConsumerMap.Add(StreamID, Consumer);
-	if (ConsumerToStreamMap.Contains(Consumer))
+	// Hold the slot's callback lock across the routing update so no chunk from the new stream can reach the consumer
+	// before PrepareNewStream_AnyThread has been called
+	FScopeLock CallbackLock(&Slot->CallbackCS);
+	if (Slot->Consumer == nullptr)
 	{
-		// cancel stream
-		int32 OldStreamID = ConsumerToStreamMap.FindAndRemoveChecked(Consumer);
-		StreamToConsumerMap.Remove(OldStreamID);
+		// consumer unregistered while we were waiting
+		return;
+	}
 
+	{
+		FWriteScopeLock Lock(DataLock);
+		int32 OldStreamID = INDEX_NONE;
+		if (ConsumerToStreamMap.RemoveAndCopyValue(Consumer, OldStreamID))
+		{
+			StreamToConsumerMap.Remove(OldStreamID);
+		}
+		StreamToConsumerMap.Add(StreamID, Slot);
+		ConsumerToStreamMap.Add(Consumer, StreamID);
+	}
+
+	if ((Slot->StreamID != INDEX_NONE) && (Slot->StreamID != StreamID))
+	{
 		// notify consumer that old stream is done
 		// but then again, that's really implied by our call to PrepareNewStream_AnyThread below so maybe we leave it up to the consumer to sort it out?
-		UE_LOG(LogACECore, Verbose, TEXT("[ACE SID %d] AttachConsumerToStream called with new stream ID %d, notifying consumer"), OldStreamID, StreamID);
-		CancelStreamToConsumer_AnyThread(OldStreamID, Consumer);
+		UE_LOG(LogACECore, Verbose, TEXT("[ACE SID %d] AttachConsumerToStream called with new stream ID %d, notifying consumer"), Slot->StreamID, StreamID);
+		CancelStreamToConsumer_AnyThread(Slot->StreamID, *Slot);
 	}
-	ConsumerToStreamMap.Add(Consumer, StreamID);
+	Slot->StreamID = StreamID;
 	Consumer->PrepareNewStream_AnyThread(StreamID, SampleRate, NumChannels, SampleByteSize);
 }
 
@@ -125,18 +165,25 @@ void FAnimDataConsumerRegistry::DetachConsumer_AnyThread(IACEAnimDataConsumer* C
 		return;
 	}
 
-	int32 StreamID = -1;
-	FScopeLock Lock(&DataCS);
-	bool bFound = ConsumerToStreamMap.RemoveAndCopyValue(Consumer, StreamID);
-	if (bFound)
+	FConsumerSlotPtr Slot;
+	int32 StreamID = INDEX_NONE;
 	{
-		int32 NumRemoved = StreamToConsumerMap.Remove(StreamID);
+		FWriteScopeLock Lock(DataLock);
+		if (ConsumerToStreamMap.RemoveAndCopyValue(Consumer, StreamID))
+		{
+			StreamToConsumerMap.RemoveAndCopyValue(StreamID, Slot);
+			ensure(Slot.IsValid());
+		}
+	}
 
-		if (ensure(NumRemoved > 0))
+	if (Slot.IsValid())
+	{
+		FScopeLock CallbackLock(&Slot->CallbackCS);
+		if ((Slot->Consumer != nullptr) && (Slot->StreamID == StreamID))
 		{
 			// notify consumer that stream is done
 			UE_LOG(LogACECore, Verbose, TEXT("[ACE SID %d] DetachConsumer called, notifying consumer"), StreamID);
-			CancelStreamToConsumer_AnyThread(StreamID, Consumer);
+			CancelStreamToConsumer_AnyThread(StreamID, *Slot);
 		}
 	}
 }
@@ -145,65 +192,102 @@ int32 FAnimDataConsumerRegistry::SendAnimData_AnyThread(const FACEAnimDataChunk&
 {
 	// Note: often this will NOT be called from game thread, but from an external callback
 
-	IACEAnimDataConsumer** Consumer = nullptr;
+	FConsumerSlotPtr Slot = FindSlotForStream_AnyThread(StreamID);
+	if (!Slot.IsValid())
 	{
-		FScopeLock Lock(&DataCS);
-		Consumer = StreamToConsumerMap.Find(StreamID);
-		if ((Consumer != nullptr) && ((*Consumer) != nullptr))
-		{
-			bool bConsumerActive = ConsumerToStreamMap.Contains(*Consumer);
-			if (ensure(bConsumerActive))
-			{
-				(*Consumer)->ConsumeAnimData_AnyThread(AnimData, StreamID);
-				if (AnimData.Status == EACEAnimDataStatus::OK_NO_MORE_DATA)
-				{
-					// stream is done, so clean up
-					ConsumerToStreamMap.Remove(*Consumer);
-					StreamToConsumerMap.Remove(StreamID);
-				}
-				return 1;
-			}
-		}
+		return 0;
+	}
+
+	FScopeLock CallbackLock(&Slot->CallbackCS);
+	if ((Slot->Consumer == nullptr) || (Slot->StreamID != StreamID))
+	{
+		// stream was detached or consumer unregistered after we looked it up
+		return 0;
 	}
-	return 0;
+
+	Slot->Consumer->ConsumeAnimData_AnyThread(AnimData, StreamID);
+	if (AnimData.Status == EACEAnimDataStatus::OK_NO_MORE_DATA)
+	{
+		// stream is done, so clean up
+		Slot->StreamID = INDEX_NONE;
+		RemoveMapping_AnyThread(StreamID, Slot);
+	}
+	return 1;
 }
 
 bool FAnimDataConsumerRegistry::DoesStreamHaveConsumers_AnyThread(int32 StreamID)
 {
-	FScopeLock Lock(&DataCS);
+	FReadScopeLock Lock(DataLock);
 	return StreamToConsumerMap.Contains(StreamID);
 }
 
+FAnimDataConsumerRegistry::FConsumerSlotPtr FAnimDataConsumerRegistry::FindSlotForStream_AnyThread(int32 StreamID)
+{
+	FReadScopeLock Lock(DataLock);
+	const FConsumerSlotPtr* Slot = StreamToConsumerMap.Find(StreamID);
+	return (Slot != nullptr) ? *Slot : FConsumerSlotPtr();
+}
 
-void FAnimDataConsumerRegistry::CancelStreamToConsumer_AnyThread(int32 StreamID, IACEAnimDataConsumer* Consumer)
+FAnimDataConsumerRegistry::FConsumerSlotPtr FAnimDataConsumerRegistry::FindSlotForConsumer_AnyThread(IACEAnimDataConsumer* Consumer)
+{
+	FReadScopeLock Lock(DataLock);
+	const FConsumerSlotPtr* Slot = ActiveConsumers.Find(Consumer);
+	return (Slot != nullptr) ? *Slot : FConsumerSlotPtr();
+}
+
+void FAnimDataConsumerRegistry::RemoveMapping_AnyThread(int32 StreamID, const FConsumerSlotPtr& Slot)
+{
+	FWriteScopeLock Lock(DataLock);
+	const FConsumerSlotPtr* MappedSlot = StreamToConsumerMap.Find(StreamID);
+	if ((MappedSlot != nullptr) && (*MappedSlot == Slot))
+	{
+		StreamToConsumerMap.Remove(StreamID);
+		ConsumerToStreamMap.Remove(Slot->Consumer);
+	}
+}
+
+void FAnimDataConsumerRegistry::CancelStreamToConsumer_AnyThread(int32 StreamID, FConsumerSlot& Slot)
 {
 	// not sure if this is a good idea or even necessary
-	if (Consumer != nullptr)
+	if (Slot.Consumer != nullptr)
 	{
 		// notify any mapped consumer that no more data is coming
 		FACEAnimDataChunk EndChunk{};
 		EndChunk.Status = EACEAnimDataStatus::OK_NO_MORE_DATA;
-		Consumer->ConsumeAnimData_AnyThread(EndChunk, StreamID);
+		Slot.Consumer->ConsumeAnimData_AnyThread(EndChunk, StreamID);
 	}
+	Slot.StreamID = INDEX_NONE;
 }
 
 void FAnimDataConsumerRegistry::RegisterConsumer_AnyThread(IACEAnimDataConsumer* Consumer)
 {
-	FScopeLock Lock(&DataCS);
-	ActiveConsumers.Add(Consumer);
+	FWriteScopeLock Lock(DataLock);
+	ActiveConsumers.Add(Consumer, MakeShared<FConsumerSlot, ESPMode::ThreadSafe>(Consumer));
 }
 
 void FAnimDataConsumerRegistry::UnregisterConsumer_AnyThread(IACEAnimDataConsumer* Consumer)
 {
-	FScopeLock Lock(&DataCS);
-	ActiveConsumers.Remove(Consumer);
+	FConsumerSlotPtr Slot;
+	{
+		FWriteScopeLock Lock(DataLock);
+		ActiveConsumers.RemoveAndCopyValue(Consumer, Slot);
+
+		// remove from mappings to ensure the consumer doesn't receive any more callbacks
+		int32 StreamIDToRemove = INDEX_NONE;
+		bool bFound = ConsumerToStreamMap.RemoveAndCopyValue(Consumer, StreamIDToRemove);
+		if (bFound)
+		{
+			StreamToConsumerMap.Remove(StreamIDToRemove);
+		}
+	}
 
-	// remove from mappings to ensure the consumer doesn't receive any more callbacks
-	int32 StreamIDToRemove = -1;
-	bool bFound = ConsumerToStreamMap.RemoveAndCopyValue(Consumer, StreamIDToRemove);
-	if (bFound)
+	if (Slot.IsValid())
 	{
-		StreamToConsumerMap.Remove(StreamIDToRemove);
+		// Wait for any in-flight callback to finish. Senders that already resolved this slot will see the null
+		// Consumer once they get the lock, so the consumer is safe to destroy after this returns.
+		FScopeLock CallbackLock(&Slot->CallbackCS);
+		Slot->Consumer = nullptr;
+		Slot->StreamID = INDEX_NONE;
 	}
 }
 
@@ -0,0 +1,141 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+// Multi-stream contention benchmark for FAnimDataConsumerRegistry.
+// Usage: au.ace.registry.benchmark [NumStreams=16] [ChunksPerStream=2000] [SlowConsumerSleepMs=5]
+// Stream 0 is attached to a deliberately slow consumer. The remaining streams should keep full throughput regardless.
+
+// plugin includes
+#include "ACECoreModulePrivate.h"
+#include "AnimDataConsumer.h"
+#include "AnimDataConsumerRegistry.h"
+
+// engine includes
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+	class FBenchmarkConsumer : public IACEAnimDataConsumer
+	{
+	public:
+		explicit FBenchmarkConsumer(float InSleepSeconds) : SleepSeconds(InSleepSeconds) {}
+
+		virtual void PrepareNewStream_AnyThread(int32 StreamID, uint32 SampleRate, int32 NumChannels, int32 SampleByteSize) override {}
+		virtual void ConsumeAnimData_AnyThread(const FACEAnimDataChunk& AnimData, int32 StreamID) override
+		{
+			if (SleepSeconds > 0.0f)
+			{
+				FPlatformProcess::Sleep(SleepSeconds);
+			}
+			++NumChunks;
+		}
+
+		const float SleepSeconds;
+		std::atomic<int32> NumChunks = 0;
+	};
+
+	void RunRegistryBenchmark(const TArray<FString>& Args)
+	{
+		FAnimDataConsumerRegistry* Registry = FAnimDataConsumerRegistry::Get();
+		if (Registry == nullptr)
+		{
+			return;
+		}
+
+		const int32 NumStreams = FMath::Max(1, (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 16);
+		const int32 ChunksPerStream = FMath::Max(1, (Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 2000);
+		const float SlowSleepSeconds = ((Args.Num() > 2) ? FCString::Atof(*Args[2]) : 5.0f) * 0.001f;
+
+		TArray<TUniquePtr<FBenchmarkConsumer>> Consumers;
+		TArray<int32> StreamIDs;
+		for (int32 Idx = 0; Idx < NumStreams; ++Idx)
+		{
+			Consumers.Add(MakeUnique<FBenchmarkConsumer>((Idx == 0) ? SlowSleepSeconds : 0.0f));
+			StreamIDs.Add(Registry->CreateStream_AnyThread());
+			Registry->AttachConsumerToStream_AnyThread(StreamIDs.Last(), Consumers.Last().Get());
+		}
+
+		TArray<float> Weights;
+		Weights.AddZeroed(55);
+		TArray<uint8> Audio;
+		Audio.AddZeroed(1066);
+		TArray<double> StreamSeconds;
+		StreamSeconds.AddZeroed(NumStreams);
+
+		TArray<TFuture<void>> Senders;
+		for (int32 Idx = 0; Idx < NumStreams; ++Idx)
+		{
+			Senders.Add(Async(EAsyncExecution::Thread, [Registry, &StreamIDs, &StreamSeconds, &Weights, &Audio, Idx, ChunksPerStream]()
+			{
+				const int32 NumChunks = (Idx == 0) ? FMath::Min(ChunksPerStream, 100) : ChunksPerStream;
+				FACEAnimDataChunk Chunk{};
+				Chunk.BlendShapeWeights = Weights;
+				Chunk.AudioBuffer = Audio;
+				Chunk.Status = EACEAnimDataStatus::OK;
+
+				const double StartTime = FPlatformTime::Seconds();
+				for (int32 ChunkIdx = 0; ChunkIdx < NumChunks; ++ChunkIdx)
+				{
+					Chunk.Timestamp = ChunkIdx / 30.0;
+					Registry->SendAnimData_AnyThread(Chunk, StreamIDs[Idx]);
+				}
+				StreamSeconds[Idx] = FPlatformTime::Seconds() - StartTime;
+			}));
+		}
+		for (TFuture<void>& Sender : Senders)
+		{
+			Sender.Wait();
+		}
+
+		double FastTotalSeconds = 0.0;
+		double FastMaxSeconds = 0.0;
+		for (int32 Idx = 1; Idx < NumStreams; ++Idx)
+		{
+			FastTotalSeconds += StreamSeconds[Idx];
+			FastMaxSeconds = FMath::Max(FastMaxSeconds, StreamSeconds[Idx]);
+		}
+		const int32 NumFastStreams = NumStreams - 1;
+		if (NumFastStreams > 0)
+		{
+			const double AvgUsPerChunk = 1e6 * FastTotalSeconds / (static_cast<double>(NumFastStreams) * ChunksPerStream);
+			UE_LOG(LogACECore, Display, TEXT("au.ace.registry.benchmark: %d streams x %d chunks, slow consumer %.1f ms/chunk: avg %.2f us/chunk, slowest fast stream %.2f ms, slow stream %.2f ms"),
+				NumStreams, ChunksPerStream, SlowSleepSeconds * 1000.0f, AvgUsPerChunk, FastMaxSeconds * 1000.0, StreamSeconds[0] * 1000.0);
+		}
+
+		for (int32 Idx = 0; Idx < NumStreams; ++Idx)
+		{
+			Registry->RemoveStream_AnyThread(StreamIDs[Idx]);
+		}
+	}
+
+	FAutoConsoleCommand CmdACERegistryBenchmark(
+		TEXT("au.ace.registry.benchmark"),
+		TEXT("Measure FAnimDataConsumerRegistry::SendAnimData_AnyThread throughput under multi-stream contention with one slow consumer. Args: [NumStreams] [ChunksPerStream] [SlowConsumerSleepMs]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunRegistryBenchmark));
+}
+
+#endif
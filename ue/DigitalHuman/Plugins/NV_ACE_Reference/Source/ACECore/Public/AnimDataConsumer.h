@@ -47,6 +47,18 @@ public:
 	// Byte array corresponding to audio data samples
 	TArrayView<const uint8> AudioBuffer;
 
+	// Bytes of silence to play before and after AudioBuffer. Providers that need to pad audio to line up with the
+	// animation timestamps set these instead of copying AudioBuffer into a zero-padded array. Consumers should treat
+	// the chunk's audio as LeadingSilenceBytes zeroes, then AudioBuffer, then TrailingSilenceBytes zeroes
+	int32 LeadingSilenceBytes = 0;
+	int32 TrailingSilenceBytes = 0;
+
+	// total audio length of this chunk in bytes, including silence
+	int32 GetTotalAudioBytes() const { return LeadingSilenceBytes + AudioBuffer.Num() + TrailingSilenceBytes; }
+
+	// Shared read-only page of zeroes that consumers can queue in pieces to play silence without allocating
+	static ACECORE_API TArrayView<const uint8> GetSilencePage();
+
 	// This should have been named AnimationTimestamp, it tells where to align this chunk's blend shape and joint data
 	// relative to the beginning of the audio playback
 	double Timestamp;
@@ -48,6 +48,8 @@ class IACEAnimDataConsumer;
 ///     buffer can be filled with zeroes for the appropriate length. For example, if int16 samples at 16000 samples
 ///     per second are being used, then 0.03 seconds of silence would be equivalent to:
 ///     0.03 seconds * 16000 samples/second * 2 bytes/sample = a length 960 TArrayView<const uint8> of all 0's.
+///     Rather than allocating that buffer, a provider can leave AudioBuffer empty and set
+///     FACEAnimDataChunk::TrailingSilenceBytes to 960 instead.
 class ACECORE_API FAnimDataConsumerRegistry {
 public:
 	// get the singleton registry
@@ -80,7 +82,28 @@ public:
 	bool DoesStreamHaveConsumers_AnyThread(int32 StreamID);
 
 private:
-	void CancelStreamToConsumer_AnyThread(int32 StreamID, IACEAnimDataConsumer* Consumer);
+	// Per-consumer routing handle. Streams resolve to a slot under a short read lock, and the consumer callback is
+	// then made while holding only that slot's CallbackCS, so a slow consumer never blocks routing for other streams.
+	// Lock order: a slot's CallbackCS may be held while acquiring DataLock, never the other way around.
+	struct FConsumerSlot
+	{
+		explicit FConsumerSlot(IACEAnimDataConsumer* InConsumer) : Consumer(InConsumer) {}
+
+		// serializes all callbacks into Consumer, and protects Consumer and StreamID
+		FCriticalSection CallbackCS;
+		// set to nullptr once the consumer unregisters, after which no more callbacks will be made
+		IACEAnimDataConsumer* Consumer;
+		// stream currently delivered to Consumer, or INDEX_NONE
+		int32 StreamID = INDEX_NONE;
+	};
+	using FConsumerSlotPtr = TSharedPtr<FConsumerSlot, ESPMode::ThreadSafe>;
+
+	FConsumerSlotPtr FindSlotForStream_AnyThread(int32 StreamID);
+	FConsumerSlotPtr FindSlotForConsumer_AnyThread(IACEAnimDataConsumer* Consumer);
+	// removes the stream → slot and consumer → stream mappings if they still refer to the given stream
+	void RemoveMapping_AnyThread(int32 StreamID, const FConsumerSlotPtr& Slot);
+	// caller must hold Slot->CallbackCS
+	void CancelStreamToConsumer_AnyThread(int32 StreamID, FConsumerSlot& Slot);
 
 	friend class IACEAnimDataConsumer;
 	// called by IACEAnimDataConsumer ctor
@@ -90,11 +113,11 @@ private:
 
 private:
 
-	FCriticalSection DataCS;
-	TSet<IACEAnimDataConsumer*> ActiveConsumers;
-	TMap<int32, IACEAnimDataConsumer*> StreamToConsumerMap;
+	// protects the routing tables below. Only held for lookups and updates, never across consumer callbacks
+	FRWLock DataLock;
+	TMap<IACEAnimDataConsumer*, FConsumerSlotPtr> ActiveConsumers;
+	TMap<int32, FConsumerSlotPtr> StreamToConsumerMap;
 	TMap<IACEAnimDataConsumer*, int32> ConsumerToStreamMap;
 
 	std::atomic<int32> NextStreamId = 0;
 };
-
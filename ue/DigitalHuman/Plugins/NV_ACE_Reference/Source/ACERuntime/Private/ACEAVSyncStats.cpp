@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ACEAVSyncStats.h"
+
+// engine includes
+#include "Algo/Sort.h"
+#include "HAL/IConsoleManager.h"
+
+// plugin includes
+#include "ACERuntimePrivate.h"
+
+
+static TAutoConsoleVariable<bool> CVarACEAVSyncRecord(
+	TEXT("au.ace.avsync.record"),
+	false,
+	TEXT("Record animation vs audio offsets from ACE audio curve sources for au.ace.avsync.report. (default: false)"),
+	ECVF_Default);
+
+namespace
+{
+	constexpr int32 MAX_AV_SYNC_SAMPLES = 1 << 20;
+
+	FCriticalSection AVSyncCS;
+	TArray<float> AVSyncOffsets;
+	int32 NumOutOfBound = 0;
+	float MaxAudioBlockSeconds = 0.0f;
+
+	float GetPercentile(const TArray<float>& Sorted, float Percentile)
+	{
+		const int32 Idx = FMath::Clamp(FMath::CeilToInt(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Idx];
+	}
+
+	void ReportAVSync()
+	{
+		TArray<float> Sorted;
+		int32 LocalNumOutOfBound = 0;
+		float LocalMaxAudioBlockSeconds = 0.0f;
+		{
+			FScopeLock Lock(&AVSyncCS);
+			Sorted = MoveTemp(AVSyncOffsets);
+			LocalNumOutOfBound = NumOutOfBound;
+			LocalMaxAudioBlockSeconds = MaxAudioBlockSeconds;
+			AVSyncOffsets.Reset();
+			NumOutOfBound = 0;
+			MaxAudioBlockSeconds = 0.0f;
+		}
+
+		if (Sorted.IsEmpty())
+		{
+			UE_LOG(LogACERuntime, Display, TEXT("au.ace.avsync.report: no samples, enable au.ace.avsync.record while ACE animation plays"));
+			return;
+		}
+
+		Algo::Sort(Sorted);
+		UE_LOG(LogACERuntime, Display, TEXT("au.ace.avsync.report: %d samples, A/V offset ms: min %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f. Largest audio buffer %.2f ms, %d samples outside one buffer"),
+			Sorted.Num(), Sorted[0] * 1000.0f, GetPercentile(Sorted, 0.5f) * 1000.0f, GetPercentile(Sorted, 0.95f) * 1000.0f,
+			GetPercentile(Sorted, 0.99f) * 1000.0f, Sorted.Last() * 1000.0f, LocalMaxAudioBlockSeconds * 1000.0f, LocalNumOutOfBound);
+	}
+
+	FAutoConsoleCommand CmdACEAVSyncReport(
+		TEXT("au.ace.avsync.report"),
+		TEXT("Log the distribution of animation vs audio offsets recorded with au.ace.avsync.record, then reset the recorded samples"),
+		FConsoleCommandDelegate::CreateStatic(&ReportAVSync));
+}
+
+bool FACEAVSyncStats::IsRecording()
+{
+	return CVarACEAVSyncRecord.GetValueOnAnyThread();
+}
+
+void FACEAVSyncStats::RecordOffset(float OffsetSeconds, float AudioBlockSeconds)
+{
+	FScopeLock Lock(&AVSyncCS);
+	if (AVSyncOffsets.Num() < MAX_AV_SYNC_SAMPLES)
+	{
+		AVSyncOffsets.Add(OffsetSeconds);
+	}
+	if (FMath::Abs(OffsetSeconds) > AudioBlockSeconds)
+	{
+		++NumOutOfBound;
+	}
+	MaxAudioBlockSeconds = FMath::Max(MaxAudioBlockSeconds, AudioBlockSeconds);
+}
@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+// engine includes
+#include "CoreMinimal.h"
+
+
+// Collects the offset between animation time and a wall clock audio reference (time since the stream's first rendered
+// sample) from every UACEAudioCurveSourceComponent while au.ace.avsync.record is enabled. Use au.ace.avsync.report to
+// log the distribution and reset the collected samples. Positive offsets mean the displayed animation is ahead of the audio.
+class FACEAVSyncStats
+{
+public:
+	static bool IsRecording();
+
+	// Safe to call from any thread.
+	// AudioBlockSeconds is the duration of the audio buffer most recently rendered, the bound we expect offsets to stay within.
+	static void RecordOffset(float OffsetSeconds, float AudioBlockSeconds);
+};
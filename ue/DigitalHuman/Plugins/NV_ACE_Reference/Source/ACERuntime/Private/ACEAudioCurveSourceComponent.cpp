@@ -33,13 +33,40 @@
 
 // plugin includes
 #include "A2XSession.h"
+#include "ACEAVSyncStats.h"
 #include "ACEBlueprintLibrary.h"
+#include "ACEPlayoutDelayEstimator.h"
 #include "ACERuntimePrivate.h"
 #include "AnimDataConsumer.h"
 #include "AnimDataConsumerRegistry.h"
 #include "ProceduralSound.h"
 
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Underflows"), STAT_ACEAudioUnderflows, STATGROUP_ACE);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Playout Buffer Depth (ms)"), STAT_ACEPlayoutBufferDepth, STATGROUP_ACE);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Stream Start Latency (ms)"), STAT_ACEStreamStartLatency, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Components Created"), STAT_ACEAudioComponentsCreated, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Components Reused"), STAT_ACEAudioComponentsReused, STATGROUP_ACE);
+
+static TAutoConsoleVariable<bool> CVarACESampleClockEnable(
+	TEXT("au.ace.sampleclock.enable"),
+	true,
+	TEXT("Derive ACE animation playback time from the number of audio samples consumed by the audio renderer. (default: true)\n")
+	TEXT("If disabled, playback time is estimated from the audio component's playback percent instead."),
+	ECVF_Default);
+
+// queue NumBytes of silence from the shared zero page, without allocating a buffer of zeroes
+static void QueueSilence(USoundWaveProcedural* SoundStreaming, int32 NumBytes)
+{
+	const TArrayView<const uint8> SilencePage = FACEAnimDataChunk::GetSilencePage();
+	while (NumBytes > 0)
+	{
+		const int32 BytesThisPass = FMath::Min(NumBytes, SilencePage.Num());
+		SoundStreaming->QueueAudio(SilencePage.GetData(), BytesThisPass);
+		NumBytes -= BytesThisPass;
+	}
+}
+
 const FName UACEAudioCurveSourceComponent::CurveNames[55] =
 {
 	FName(TEXT("EyeBlinkLeft")),
@@ -110,17 +137,31 @@ UACEAudioCurveSourceComponent::UACEAudioCurveSourceComponent() :
 	Priority(1.0f),
 	Volume(1.0f),
 	ReceivedAudioSamples(0),
+	PlayoutDelayEstimator(MakeUnique<FACEPlayoutDelayEstimator>()),
 	AudioCompCS(),
+	CurrentBufferLength(0.0f),
+	NumUnderflows(0),
+	AudioComponentFormatKey(0),
+	PreparedStreamID(INDEX_NONE),
+	StreamPrepareTime(0.0),
+	LastStreamStartLatency(0.0f),
 	ReceivedBSWeightSamples(0),
 	CurrentSessionID(IA2FProvider::IA2FStream::INVALID_STREAM_ID),
 	LastSampleIdx(-1),
 	LastUpdatedGlobalTime(0),
 	AudioPlaybackTimeEstimate(0.0f),
 	CurrentPlaybackTime(0.0f),
-	LastAnimPlaybackTime(0.0f)
+	LastAnimPlaybackTime(0.0f),
+	bHasAudioClock(false),
+	RenderedAudioBlockLength(0.0f),
+	AudioClockOriginTime(0.0),
+	LastConsumedSamples(0),
+	WallClockAudioTime(0.0f)
 {
-	// make this component tickable so we can run audio code from game thread
+	// make this component tickable so we can run audio code from game thread.
+	// It sleeps while idle and is woken from PrepareNewAudioComponent_GameThread when a new stream arrives
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 // dtor
@@ -145,35 +186,44 @@ void UACEAudioCurveSourceComponent::PrepareNewAudioComponent_GameThread(int32 St
 {
 	check(IsInGameThread());
 
-	// Create/replace audio component
-	UAudioComponent* NewAudioComponent = CreateAudioComponent_GameThread(SampleRate, NumChannels, SampleByteSize);
+	// Reuse the current audio component if it already plays this format, otherwise take one from the pool or create one.
+	// AudioComponent is only ever replaced on the game thread, so it's safe to read here without the lock.
+	const uint64 FormatKey = MakeAudioFormatKey(SampleRate, NumChannels, SampleByteSize);
+	const bool bReuseCurrent = IsValid(AudioComponent) && (AudioComponentFormatKey == FormatKey);
+	UAudioComponent* NewAudioComponent = bReuseCurrent ? AudioComponent.Get() : AcquireAudioComponent_GameThread(SampleRate, NumChannels, SampleByteSize);
 	{
 		FScopeLock Lock(&AudioCompCS);
 
-		// clean up any existing audio component
-		if (AudioComponent != nullptr)
+		if (bReuseCurrent)
 		{
 			// stop the existing AudioComponent in case it's still playing a previously received audio stream
+			ResetAudioComponent_GameThread(AudioComponent, SampleRate, NumChannels, SampleByteSize);
+			INC_DWORD_STAT(STAT_ACEAudioComponentsReused);
+		}
+		else if (AudioComponent != nullptr)
+		{
+			// stop the existing AudioComponent in case it's still playing a previously received audio stream, and keep it around for later
 			AudioComponent->Stop();
-			// TODO: Is this correct to explictly detach the existing AudioComponent here? Need to think through possible race conditions.
-			AudioComponent->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
+			ReleaseAudioComponent_GameThread(AudioComponent, AudioComponentFormatKey);
 		}
 
 		// finish setting up new audio component
 		AudioComponent = NewAudioComponent;
+		AudioComponentFormatKey = FormatKey;
 		if (AudioComponent != nullptr)
 		{
-			AudioComponent->AttachToComponent(this, FAttachmentTransformRules::KeepRelativeTransform);
-			// make this component tickable so we can run audio code from game thread
-			PrimaryComponentTick.bCanEverTick = true;
+			// wake up so we can run audio code from game thread
+			SetComponentTickEnabled(true);
 		}
 		else
 		{
 			// no audio available, so no need to tick this component
-			PrimaryComponentTick.bCanEverTick = false;
+			SetComponentTickEnabled(false);
 		}
 		ReceivedAudioSamples = 0;
 		ReceivedBSWeightSamples.store(0);
+		bAnimationAllFramesRecived = false;
+		PlayoutDelayEstimator->BeginStream();
 	}
 
 	// reset blend shape weights, elapsed play time, timestamps, etc
@@ -183,6 +233,11 @@ void UACEAudioCurveSourceComponent::PrepareNewAudioComponent_GameThread(int32 St
 	AudioPlaybackTimeEstimate = 0.0f;
 	CurrentPlaybackTime = 0.0f;
 	LastAnimPlaybackTime = 0.0f;
+	bHasAudioClock = false;
+	RenderedAudioBlockLength = 0.0f;
+	AudioClockOriginTime = 0.0;
+	LastConsumedSamples = 0;
+	WallClockAudioTime = 0.0f;
 	for (float& RecentPlaybackTime : RecentPlaybackTimes)
 	{
 		RecentPlaybackTime = 0.0f;
@@ -193,6 +248,103 @@ void UACEAudioCurveSourceComponent::PrepareNewAudioComponent_GameThread(int32 St
 	AudioCompReady.Notify();
 }
 
+uint64 UACEAudioCurveSourceComponent::MakeAudioFormatKey(uint32 SampleRate, int32 NumChannels, int32 SampleByteSize)
+{
+	return (static_cast<uint64>(SampleRate) << 32) | (static_cast<uint64>(NumChannels & 0xffffff) << 8) | static_cast<uint64>(SampleByteSize & 0xff);
+}
+
+UAudioComponent* UACEAudioCurveSourceComponent::AcquireAudioComponent_GameThread(uint32 SampleRate, int32 NumChannels, int32 SampleByteSize)
+{
+	check(IsInGameThread());
+	TObjectPtr<UAudioComponent> PooledAudioComponent = nullptr;
+	if (PooledAudioComponents.RemoveAndCopyValue(MakeAudioFormatKey(SampleRate, NumChannels, SampleByteSize), PooledAudioComponent) && IsValid(PooledAudioComponent))
+	{
+		ResetAudioComponent_GameThread(PooledAudioComponent, SampleRate, NumChannels, SampleByteSize);
+		INC_DWORD_STAT(STAT_ACEAudioComponentsReused);
+		return PooledAudioComponent;
+	}
+
+	UAudioComponent* NewAudioComponent = CreateAudioComponent_GameThread(SampleRate, NumChannels, SampleByteSize);
+	if (NewAudioComponent != nullptr)
+	{
+		NewAudioComponent->AttachToComponent(this, FAttachmentTransformRules::KeepRelativeTransform);
+		INC_DWORD_STAT(STAT_ACEAudioComponentsCreated);
+	}
+	return NewAudioComponent;
+}
+
+void UACEAudioCurveSourceComponent::ReleaseAudioComponent_GameThread(UAudioComponent* InAudioComponent, uint64 FormatKey)
+{
+	check(IsInGameThread());
+	if (!IsValid(InAudioComponent))
+	{
+		return;
+	}
+
+	// keep one idle audio component per format
+	TObjectPtr<UAudioComponent>& PoolSlot = PooledAudioComponents.FindOrAdd(FormatKey);
+	if (IsValid(PoolSlot) && (PoolSlot != InAudioComponent))
+	{
+		PoolSlot->DestroyComponent();
+	}
+	PoolSlot = InAudioComponent;
+}
+
+void UACEAudioCurveSourceComponent::ResetAudioComponent_GameThread(UAudioComponent* InAudioComponent, uint32 SampleRate, int32 NumChannels, int32 SampleByteSize)
+{
+	check(IsInGameThread());
+	InAudioComponent->Stop();
+	// Stop() on this component mutes the audio component, so undo that
+	InAudioComponent->SetVolumeMultiplier(1.0f);
+	ApplyAttenuationSettings(InAudioComponent);
+
+	// Stop() is asynchronous, so the audio render thread may still be pulling from the old wave. Resetting its queue and
+	// sample clock here would race GeneratePCMData and break the sample clock's single writer rule. Swap in a fresh wave
+	// instead; the old one is kept alive by the audio device until its source has actually stopped.
+	UBetterSoundWaveProcedural* SoundStreaming = CreateSoundWave_GameThread(SampleRate, NumChannels, SampleByteSize);
+	if (SoundStreaming != nullptr)
+	{
+		InAudioComponent->SetSound(SoundStreaming);
+	}
+}
+
+void UACEAudioCurveSourceComponent::ApplyAttenuationSettings(UAudioComponent* InAudioComponent) const
+{
+	// Should probably have a way to set bIsUISound for animation editor preview once we implement that, but for now it's never true
+	const bool bIsUISound = false;
+	InAudioComponent->bIsUISound = bIsUISound;
+	bool bAllowSpatialization = !bIsUISound && (AttenuationSettings || bOverrideAttenuation);
+	InAudioComponent->bAllowSpatialization = bAllowSpatialization;
+	InAudioComponent->bOverrideAttenuation = bOverrideAttenuation;
+	if (bOverrideAttenuation)
+	{
+		InAudioComponent->AttenuationOverrides = AttenuationOverrides;
+	}
+	else
+	{
+		InAudioComponent->AttenuationSettings = AttenuationSettings;
+	}
+}
+
+void UACEAudioCurveSourceComponent::PrewarmAudio(int32 SampleRate, int32 NumChannels, int32 SampleByteSize)
+{
+	check(IsInGameThread());
+	const uint64 FormatKey = MakeAudioFormatKey(SampleRate, NumChannels, SampleByteSize);
+	if ((IsValid(AudioComponent) && (AudioComponentFormatKey == FormatKey)) || IsValid(PooledAudioComponents.FindRef(FormatKey)))
+	{
+		// already have one
+		return;
+	}
+
+	UAudioComponent* NewAudioComponent = CreateAudioComponent_GameThread(SampleRate, NumChannels, SampleByteSize);
+	if (NewAudioComponent != nullptr)
+	{
+		NewAudioComponent->AttachToComponent(this, FAttachmentTransformRules::KeepRelativeTransform);
+		INC_DWORD_STAT(STAT_ACEAudioComponentsCreated);
+		ReleaseAudioComponent_GameThread(NewAudioComponent, FormatKey);
+	}
+}
+
 // Note: can only create audio component from game thread
 UAudioComponent* UACEAudioCurveSourceComponent::CreateAudioComponent_GameThread(uint32 SampleRate, int32 NumChannels, int32 SampleByteSize)
 {
@@ -214,48 +366,22 @@ UAudioComponent* UACEAudioCurveSourceComponent::CreateAudioComponent_GameThread(
 	if (AudioDevice)
 	{
 		// Create a procedural sound, where the received audio samples will be queued
-		UBetterSoundWaveProcedural* SoundStreaming = NewObject<UBetterSoundWaveProcedural>();
+		UBetterSoundWaveProcedural* SoundStreaming = CreateSoundWave_GameThread(SampleRate, NumChannels, SampleByteSize);
 		if (SoundStreaming == nullptr)
 		{
 			UE_LOG(LogACERuntime, Warning, TEXT("Unable to create audio component for ACE animation"));
 			return nullptr;
 		}
-		SoundStreaming->SetSampleRate(SampleRate);
-		SoundStreaming->NumChannels = NumChannels;
-		SoundStreaming->SampleByteSize = SampleByteSize;
-		SoundStreaming->Duration = INDEFINITELY_LOOPING_DURATION;	// 166m40s ought to be enough for anybody
-		SoundStreaming->Priority = Priority;
-		SoundStreaming->SoundGroup = SoundGroup;
-		SoundStreaming->bLooping = false;
-		SoundStreaming->bProcedural = true;
-		SoundStreaming->Volume = Volume;
-		SoundStreaming->Pitch = 1.0f;
-		SoundStreaming->AttenuationSettings = nullptr;
-		SoundStreaming->bDebug = bEnableAttenuationDebug;
-		SoundStreaming->VirtualizationMode = EVirtualizationMode::PlayWhenSilent;
-		SoundStreaming->OnSoundWaveProceduralUnderflow.BindUObject(this, &UACEAudioCurveSourceComponent::HandleSoundUnderflow);
 
 		// And now finally create the audio component to play the sound
 		FAudioDevice::FCreateComponentParams Params(GetOwner());
 		NewAudioComponent = AudioDevice->CreateComponent(SoundStreaming, Params);
 		if (NewAudioComponent != nullptr)
 		{
-			// Should probably have a way to set bIsUISound for animation editor preview once we implement that, but for now it's never true
-			const bool bIsUISound = false;
-			NewAudioComponent->bIsUISound = bIsUISound;
-			bool bAllowSpatialization = !bIsUISound && (AttenuationSettings || bOverrideAttenuation);
-			NewAudioComponent->bAllowSpatialization = bAllowSpatialization;
+			ApplyAttenuationSettings(NewAudioComponent);
 			NewAudioComponent->bAutoActivate = false;
-			NewAudioComponent->bAutoDestroy = true;
-			NewAudioComponent->bOverrideAttenuation = bOverrideAttenuation;
-			if (bOverrideAttenuation)
-			{
-				NewAudioComponent->AttenuationOverrides = AttenuationOverrides;
-			}
-			else
-			{
-				NewAudioComponent->AttenuationSettings = AttenuationSettings;
-			}
+			// audio components are pooled and reused across streams, so they must survive being stopped
+			NewAudioComponent->bAutoDestroy = false;
 			NewAudioComponent->OnAudioPlaybackPercentNative.AddUObject(this, &UACEAudioCurveSourceComponent::HandlePlaybackFraction);
 		}
 	}
@@ -272,9 +398,40 @@ UAudioComponent* UACEAudioCurveSourceComponent::CreateAudioComponent_GameThread(
 	return NewAudioComponent;
 }
 
+UBetterSoundWaveProcedural* UACEAudioCurveSourceComponent::CreateSoundWave_GameThread(uint32 SampleRate, int32 NumChannels, int32 SampleByteSize)
+{
+	check(IsInGameThread());
+	UBetterSoundWaveProcedural* SoundStreaming = NewObject<UBetterSoundWaveProcedural>();
+	if (SoundStreaming == nullptr)
+	{
+		return nullptr;
+	}
+	SoundStreaming->SetSampleRate(SampleRate);
+	SoundStreaming->NumChannels = NumChannels;
+	SoundStreaming->SampleByteSize = SampleByteSize;
+	SoundStreaming->Duration = INDEFINITELY_LOOPING_DURATION;	// 166m40s ought to be enough for anybody
+	SoundStreaming->Priority = Priority;
+	SoundStreaming->SoundGroup = SoundGroup;
+	SoundStreaming->bLooping = false;
+	SoundStreaming->bProcedural = true;
+	SoundStreaming->Volume = Volume;
+	SoundStreaming->Pitch = 1.0f;
+	SoundStreaming->AttenuationSettings = nullptr;
+	SoundStreaming->bDebug = bEnableAttenuationDebug;
+	SoundStreaming->VirtualizationMode = EVirtualizationMode::PlayWhenSilent;
+	SoundStreaming->OnSoundWaveProceduralUnderflow.BindUObject(this, &UACEAudioCurveSourceComponent::HandleSoundUnderflow);
+	return SoundStreaming;
+}
+
 void UACEAudioCurveSourceComponent::PrepareNewStream_AnyThread(int32 StreamID, uint32 SampleRate, int32 NumChannels, int32 SampleByteSize)
 {
 	AudioCompReady.Reset();
+	bStreamOpen = true;
+	if (PreparedStreamID.exchange(StreamID) != StreamID)
+	{
+		// a stream may be prepared more than once if its audio format changes, only time it from the first
+		StreamPrepareTime = FPlatformTime::Seconds();
+	}
 	AudioSampleRate = static_cast<float>(SampleRate);
 	NumAudioChannels = NumChannels;
 	AudioSampleByteSize = SampleByteSize;
@@ -323,7 +480,7 @@ void UACEAudioCurveSourceComponent::ConsumeAnimData_AnyThread(const FACEAnimData
 			return;
 		}
 
-		if ((Chunk.AudioBuffer.Num() == 0) && (Chunk.BlendShapeWeights.Num() == 0))
+		if ((Chunk.GetTotalAudioBytes() == 0) && (Chunk.BlendShapeWeights.Num() == 0))
 		{
 			// no data this frame, probably a header
 			UE_LOG(LogACERuntime, Verbose, TEXT("[ACE SID %d callback] no data this frame, probably received header"), SessionID);
@@ -347,21 +504,23 @@ void UACEAudioCurveSourceComponent::ConsumeAnimData_AnyThread(const FACEAnimData
 		{
 			FScopeLock Lock(&AudioCompCS);
 
-			TArrayView<const uint8> AudioBuffer = Chunk.AudioBuffer;
-			int32 NumAudioSamples = AudioBuffer.Num() / AudioSampleByteSize;
+			const int32 TotalAudioBytes = Chunk.GetTotalAudioBytes();
+			int32 NumAudioSamples = TotalAudioBytes / AudioSampleByteSize;
 			// TODO: check if the AudioComponent is invalid, for example during shutdown
 			if (AudioComponent != nullptr)
 			{
-				if (ensure(0 == (AudioBuffer.Num() % AudioSampleByteSize)))
+				if (ensure((0 == (Chunk.AudioBuffer.Num() % AudioSampleByteSize)) && (0 == (TotalAudioBytes % AudioSampleByteSize))))
 				{
-					// Add new samples to streaming queue
+					// Add new samples to streaming queue. Silence padding is queued straight from the shared zero page
 					UBetterSoundWaveProcedural* SoundStreaming = CastChecked<UBetterSoundWaveProcedural>(AudioComponent->Sound);
-					SoundStreaming->QueueAudio(AudioBuffer.GetData(), AudioBuffer.Num());
+					QueueSilence(SoundStreaming, Chunk.LeadingSilenceBytes);
+					SoundStreaming->QueueAudio(Chunk.AudioBuffer.GetData(), Chunk.AudioBuffer.Num());
+					QueueSilence(SoundStreaming, Chunk.TrailingSilenceBytes);
 					UE_LOG(LogACERuntime, VeryVerbose, TEXT("[ACE SID %d callback] queued %d samples"), SessionID, NumAudioSamples);
 				}
 				else
 				{
-					UE_LOG(LogACERuntime, Warning, TEXT("[ACE SID %d callback] invalid buffer size %d, skipping audio samples!"), SessionID, AudioBuffer.Num());
+					UE_LOG(LogACERuntime, Warning, TEXT("[ACE SID %d callback] invalid buffer size %d, skipping audio samples!"), SessionID, TotalAudioBytes);
 					NumAudioSamples = 0;
 				}
 			}
@@ -374,6 +533,13 @@ void UACEAudioCurveSourceComponent::ConsumeAnimData_AnyThread(const FACEAnimData
 			// increment number of samples
 			ReceivedAudioSamples += NumAudioSamples;
 
+			// track arrival jitter so we know how much audio to buffer before playback
+			if (NumAudioSamples > 0)
+			{
+				const double ChunkAudioSeconds = static_cast<double>(NumAudioSamples) / (AudioSampleRate * static_cast<float>(NumAudioChannels));
+				PlayoutDelayEstimator->AddArrival(FPlatformTime::Seconds(), ChunkAudioSeconds);
+			}
+
 			// Adjust local timestamp by any extra silence that got queued up
 			LocalTimestamp += static_cast<float>(TotalUnderflowSamples) / (AudioSampleRate * static_cast<float>(NumAudioChannels));
 		}
@@ -427,6 +593,7 @@ void UACEAudioCurveSourceComponent::ConsumeAnimData_AnyThread(const FACEAnimData
 	else
 	{
 		bAnimationAllFramesRecived = true;
+		bStreamOpen = false;
 		// TODO: animation/audio complete. Play back any remaining buffered audio, and be sure to start it if it's not currently playing back
 		FScopeLock Lock(&AudioCompCS);
 		UE_LOG(LogACERuntime, Log, TEXT("[ACE SID %d callback] received %d animation samples, %d audio samples for clip on %s"), SessionID, ReceivedBSWeightSamples.load(), ReceivedAudioSamples, *GetOwner()->GetFullName());
@@ -440,28 +607,33 @@ void UACEAudioCurveSourceComponent::TickComponent(float DeltaTime, enum ELevelTi
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	// if it's ending, we stopped audio, but this keeps playing here.
-	if (AnimState != EAnimState::ENDING)
+	// if it's idle with no stream attached, there's nothing new to start playing.
+	if ((AnimState != EAnimState::ENDING) && IsStreamActive())
 	{
 		UBetterSoundWaveProcedural* SoundStreaming = nullptr;
+		FScopeLock Lock(&AudioCompCS);
+		if (AudioComponent != nullptr)
 		{
-			FScopeLock Lock(&AudioCompCS);
-			if (AudioComponent == nullptr)
-			{
-				return;
-			}
-
 			SoundStreaming = CastChecked<UBetterSoundWaveProcedural>(AudioComponent->Sound);
 
 			if ((SoundStreaming != nullptr) && !AudioComponent->IsPlaying())
 			{
-				// Start playing audio if we've queued enough samples
+				// Start playing audio if we've queued enough samples, or if there's nothing more to wait for
 				int32 QueuedSamples = SoundStreaming->GetAvailableAudioByteCount() / SoundStreaming->SampleByteSize;
 				float QueuedTime = static_cast<float>(QueuedSamples) / (AudioSampleRate * static_cast<float>(NumAudioChannels));
-				if (QueuedTime >= BufferLengthInSeconds)
+				const float TargetBufferLength = (bAdaptiveBuffer && PlayoutDelayEstimator->HasHistory())
+					? PlayoutDelayEstimator->GetTargetDelaySeconds(AdaptiveBufferPercentile, MinBufferLengthInSeconds, MaxBufferLengthInSeconds)
+					: BufferLengthInSeconds;
+				if ((QueuedTime >= TargetBufferLength) || (bAnimationAllFramesRecived && (QueuedSamples > 0)))
 				{
 					TotalUnderflowSamples = 0;
+					CurrentBufferLength = QueuedTime;
+					SET_FLOAT_STAT(STAT_ACEPlayoutBufferDepth, QueuedTime * 1000.0f);
+					LastStreamStartLatency = static_cast<float>(FPlatformTime::Seconds() - StreamPrepareTime);
+					SET_FLOAT_STAT(STAT_ACEStreamStartLatency, LastStreamStartLatency * 1000.0f);
 					AudioComponent->Play();
-					UE_LOG(LogACERuntime, Log, TEXT("start playing audio on %s"), *GetOwner()->GetFullName());
+					UE_LOG(LogACERuntime, Log, TEXT("start playing audio on %s with %.3f seconds buffered (target %.3f), %.3f seconds after stream start"),
+						*GetOwner()->GetFullName(), QueuedTime, TargetBufferLength, LastStreamStartLatency.load());
 				}
 			}
 		}
@@ -479,6 +651,11 @@ void UACEAudioCurveSourceComponent::TickComponent(float DeltaTime, enum ELevelTi
 		OnAnimationEnded.Broadcast();
 	}
 
+	if ((AnimState == EAnimState::IDLE) && !bStreamOpen)
+	{
+		SleepIfIdle_GameThread();
+	}
+
 	// Even this workaround wasn't enough, we were still rarely seeing bad CurrentPlaybackTime.
 	// Unknown why, possibly a race condition between audio and game thread?
 	// Leaving the following comment in place so some future dev doesn't have to figure this out all over again
@@ -508,6 +685,28 @@ void UACEAudioCurveSourceComponent::TickComponent(float DeltaTime, enum ELevelTi
 #endif
 }
 
+void UACEAudioCurveSourceComponent::SleepIfIdle_GameThread()
+{
+	check(IsInGameThread());
+	FScopeLock Lock(&AudioCompCS);
+	if (AudioComponent != nullptr)
+	{
+		const UBetterSoundWaveProcedural* SoundStreaming = Cast<UBetterSoundWaveProcedural>(AudioComponent->Sound);
+		if (AudioComponent->IsPlaying() && (SoundStreaming != nullptr) && (SoundStreaming->GetAvailableAudioByteCount() > 0))
+		{
+			// let the last of the audio play out before going to sleep
+			return;
+		}
+
+		// nothing left to play, so stop rendering silence until the next stream
+		AudioComponent->Stop();
+	}
+
+	bAnimationAllFramesRecived = false;
+	SetComponentTickEnabled(false);
+	UE_LOG(LogACERuntime, Verbose, TEXT("ACE audio curve source going idle on %s"), *GetOwner()->GetFullName());
+}
+
 #if 0
 const FSoundSource* UACEAudioCurveSourceComponent::FindSoundSourceAudioThread(const UBetterSoundWaveProcedural* SoundWave)
 {
@@ -597,9 +796,28 @@ void UACEAudioCurveSourceComponent::HandlePlaybackFraction(const UAudioComponent
 
 void UACEAudioCurveSourceComponent::EvaluateAndUpdateCurrentPlaybackTime()
 {
-	// this function may modify game thread data: CurrentPlaybackTime, LastUpdatedGlobalTime
+	// this function may modify game thread data: CurrentPlaybackTime, LastUpdatedGlobalTime, bHasAudioClock, RenderedAudioBlockLength, A/V sync reference
 	check(IsInGameThread());
 	FScopeLock Lock(&AudioCompCS);
+
+	// Preferred: playback time from the count of samples the audio renderer has actually consumed. This doesn't
+	// depend on FMixerSource::GetPlaybackPercent, so it can't report stale values from a previous playback.
+	float SampleClockPlaybackTime = 0.0f;
+	bHasAudioClock = UpdateAudioClock_GameThread(SampleClockPlaybackTime);
+	if (bHasAudioClock && CVarACESampleClockEnable.GetValueOnGameThread())
+	{
+		CurrentPlaybackTime = SampleClockPlaybackTime;
+		LastUpdatedGlobalTime = 0;
+		if (AnimState == EAnimState::STARTING)
+		{
+			// the renderer has started pulling samples from this stream, so playback has definitely begun
+			AnimState = EAnimState::STARTED;
+		}
+		UE_LOG(LogACERuntime, VeryVerbose, TEXT("UACEAudioCurveSourceComponent::EvaluateAndUpdateCurrentPlaybackTime sample clock CurrentPlaybackTime %f"), CurrentPlaybackTime);
+		return;
+	}
+
+	// Fallback: estimate from playback percent reported by the engine, smoothed with wall clock time
 	const int64 CurrentUpdatedGlobalTime = FDateTime::Now().GetTicks();
 	const int64 ElapsedTicks = (LastUpdatedGlobalTime > 0) ? CurrentUpdatedGlobalTime - LastUpdatedGlobalTime : 0;
 	const float ElapsedTimeSinceLastUpdate = (float)ElapsedTicks / (float)ETimespan::TicksPerSecond;
@@ -628,6 +846,54 @@ void UACEAudioCurveSourceComponent::EvaluateAndUpdateCurrentPlaybackTime()
 	UE_LOG(LogACERuntime, VeryVerbose, TEXT("UACEAudioCurveSourceComponent::EvaluateAndUpdateCurrentPlaybackTime CurrentPlaybackTime %f"), CurrentPlaybackTime);
 }
 
+bool UACEAudioCurveSourceComponent::UpdateAudioClock_GameThread(float& OutPlaybackTime)
+{
+	// caller must hold AudioCompCS
+	if (AudioComponent == nullptr)
+	{
+		return false;
+	}
+
+	const UBetterSoundWaveProcedural* SoundStreaming = Cast<UBetterSoundWaveProcedural>(AudioComponent->Sound);
+	uint64 ConsumedSamples = 0;
+	uint32 LastBlockSamples = 0;
+	double LastBlockTime = 0.0;
+	if ((SoundStreaming == nullptr) || !SoundStreaming->GetSampleClock(ConsumedSamples, LastBlockSamples, LastBlockTime))
+	{
+		return false;
+	}
+
+	// The most recent block started playing at LastBlockTime. Advance through it with wall clock time, but never past
+	// its end, so the result is always within one audio buffer of what the renderer has consumed.
+	const double SamplesPerSecond = static_cast<double>(AudioSampleRate) * static_cast<double>(NumAudioChannels);
+	const double BlockStartTime = static_cast<double>(ConsumedSamples - LastBlockSamples) / SamplesPerSecond;
+	const double BlockLength = static_cast<double>(LastBlockSamples) / SamplesPerSecond;
+	const double Now = FPlatformTime::Seconds();
+	const double ElapsedInBlock = FMath::Clamp(Now - LastBlockTime, 0.0, BlockLength);
+
+	// The A/V sync reference must not share the clamp above, or offsets could never exceed one block. Pin the wall clock
+	// time of sample 0 once per stream (re-pinned if the sample clock was reset) and measure from there, so renderer
+	// stalls and clock drift show up as growing offsets.
+	if ((AudioClockOriginTime <= 0.0) || (ConsumedSamples < LastConsumedSamples))
+	{
+		AudioClockOriginTime = LastBlockTime - BlockStartTime;
+	}
+	LastConsumedSamples = ConsumedSamples;
+	WallClockAudioTime = static_cast<float>(Now - AudioClockOriginTime);
+
+	RenderedAudioBlockLength = static_cast<float>(BlockLength);
+	OutPlaybackTime = static_cast<float>(BlockStartTime + ElapsedInBlock);
+	return true;
+}
+
+void UACEAudioCurveSourceComponent::RecordAVSyncOffset(float AnimationTime) const
+{
+	if (bHasAudioClock && FACEAVSyncStats::IsRecording())
+	{
+		FACEAVSyncStats::RecordOffset(AnimationTime - WallClockAudioTime, RenderedAudioBlockLength);
+	}
+}
+
 // Handle audio playback running out of received audio samples (delegate)
 void UACEAudioCurveSourceComponent::HandleSoundUnderflow(USoundWaveProcedural* InProceduralWave, int32 SamplesRequired)
 {
@@ -637,10 +903,16 @@ void UACEAudioCurveSourceComponent::HandleSoundUnderflow(USoundWaveProcedural* I
 	{
 		FScopeLock Lock(&AudioCompCS);
 		UBetterSoundWaveProcedural* SoundStreaming = CastChecked<UBetterSoundWaveProcedural>(InProceduralWave);
-		TArray<uint8> AudioBuffer;
-		AudioBuffer.AddZeroed(SamplesRequired * SoundStreaming->SampleByteSize);
-		SoundStreaming->QueueAudio(AudioBuffer.GetData(), AudioBuffer.Num());
+		QueueSilence(SoundStreaming, SamplesRequired * SoundStreaming->SampleByteSize);
 		TotalUnderflowSamples += SamplesRequired;
+
+		if (!bAnimationAllFramesRecived)
+		{
+			// we ran out of audio before the end of the clip, so let the adaptive buffer know it was too shallow
+			++NumUnderflows;
+			INC_DWORD_STAT(STAT_ACEAudioUnderflows);
+			PlayoutDelayEstimator->AddUnderflow(static_cast<double>(SamplesRequired) / (AudioSampleRate * static_cast<float>(NumAudioChannels)));
+		}
 	}
 }
 
@@ -789,6 +1061,7 @@ void UACEAudioCurveSourceComponent::GetCurveOutputs(TArray<float>& OutWeights)
 		ensure(Sample.SessionID == CurrentSessionID);
 		LastAnimPlaybackTime = CurrentPlaybackTime;
 		OutWeights = Sample.Weights;
+		RecordAVSyncOffset(Sample.Timestamp);
 	}
 }
 
@@ -864,6 +1137,7 @@ void UACEAudioCurveSourceComponent::GetCurveOutputsInterp(TArray<float>& OutWeig
 				}
 
 				LastAnimPlaybackTime = CurrentPlaybackTime;
+				RecordAVSyncOffset(CurrentPlaybackTime);
 
 				// check if the queue needs readjust
 				RecentPlaybackIdx = (RecentPlaybackIdx + 1) % NUM_RECENT_PLAYBACK_TIMES;
@@ -939,6 +1213,9 @@ void UACEAudioCurveSourceComponent::Stop()
 	}
 
 	AnimState = EAnimState::ENDING;
+	bStreamOpen = false;
+	// make sure we tick at least once more to broadcast the end of animation and go idle
+	SetComponentTickEnabled(true);
 
 	// clear the animation buffer
 	ResetAnimSamples();
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ACEPlayoutDelayEstimator.h"
+
+// engine includes
+#include "Algo/Sort.h"
+
+
+void FACEPlayoutDelayEstimator::BeginStream()
+{
+	FirstArrivalTime.Reset();
+	ReceivedAudioSeconds = 0.0;
+	MinRelativeDelay = 0.0;
+	PendingUnderflowSeconds = 0.0;
+}
+
+void FACEPlayoutDelayEstimator::AddArrival(double ArrivalTimeSeconds, double AudioSeconds)
+{
+	if (!FirstArrivalTime.IsSet())
+	{
+		FirstArrivalTime = ArrivalTimeSeconds;
+	}
+
+	const double RelativeDelay = (ArrivalTimeSeconds - FirstArrivalTime.GetValue()) - ReceivedAudioSeconds;
+	MinRelativeDelay = FMath::Min(MinRelativeDelay, RelativeDelay);
+	ReceivedAudioSeconds += AudioSeconds;
+
+	AddLateness(static_cast<float>(RelativeDelay - MinRelativeDelay + PendingUnderflowSeconds));
+	PendingUnderflowSeconds = 0.0;
+}
+
+void FACEPlayoutDelayEstimator::AddUnderflow(double UnderflowSeconds)
+{
+	PendingUnderflowSeconds += UnderflowSeconds;
+}
+
+float FACEPlayoutDelayEstimator::GetTargetDelaySeconds(float Percentile, float MinSeconds, float MaxSeconds)
+{
+	if (History.IsEmpty())
+	{
+		return MinSeconds;
+	}
+
+	SortedScratch = History;
+	const int32 Idx = FMath::Clamp(FMath::CeilToInt(FMath::Clamp(Percentile, 0.0f, 1.0f) * SortedScratch.Num()) - 1, 0, SortedScratch.Num() - 1);
+	// history is small, and this only runs while waiting for playback to start
+	Algo::Sort(SortedScratch);
+
+	return FMath::Clamp(SortedScratch[Idx], MinSeconds, FMath::Max(MinSeconds, MaxSeconds));
+}
+
+void FACEPlayoutDelayEstimator::AddLateness(float LatenessSeconds)
+{
+	if (History.Num() < MAX_HISTORY)
+	{
+		History.Add(LatenessSeconds);
+	}
+	else
+	{
+		History[NextHistoryIdx] = LatenessSeconds;
+	}
+	NextHistoryIdx = (NextHistoryIdx + 1) % MAX_HISTORY;
+}
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+// engine includes
+#include "CoreMinimal.h"
+
+
+// Tracks arrival jitter of incoming ACE audio chunks and picks a playout buffer depth that covers a given percentile
+// of observed lateness.
+//
+// For each chunk we compute its relative delay: wall clock time since the first chunk of the stream arrived, minus the
+// amount of audio received before it. A chunk that arrives exactly on real-time schedule has the same relative delay
+// as the first chunk. The lateness of a chunk is its relative delay above the smallest relative delay seen so far in
+// the stream, which is how much audio would have had to be buffered to play it without an underrun.
+//
+// Lateness history is kept across streams so a new utterance starts with what we learned from the previous ones.
+// Not thread safe, the owner is expected to provide synchronization.
+class FACEPlayoutDelayEstimator
+{
+public:
+	// reset per-stream arrival tracking, keeping the lateness history
+	void BeginStream();
+
+	// record arrival of a chunk containing AudioSeconds worth of audio
+	void AddArrival(double ArrivalTimeSeconds, double AudioSeconds);
+
+	// record that playback ran out of audio for UnderflowSeconds while the stream was still active
+	void AddUnderflow(double UnderflowSeconds);
+
+	// returns the buffer depth in seconds that covers the given fraction [0, 1] of recent lateness, clamped to [MinSeconds, MaxSeconds]
+	float GetTargetDelaySeconds(float Percentile, float MinSeconds, float MaxSeconds);
+
+	bool HasHistory() const { return !History.IsEmpty(); }
+
+private:
+	void AddLateness(float LatenessSeconds);
+
+	static constexpr int32 MAX_HISTORY = 256;
+
+	TArray<float> History;
+	int32 NextHistoryIdx = 0;
+	// scratch copy of History used to compute percentiles without allocating
+	TArray<float> SortedScratch;
+
+	// per-stream state
+	TOptional<double> FirstArrivalTime;
+	double ReceivedAudioSeconds = 0.0;
+	double MinRelativeDelay = 0.0;
+	// lateness added to the next observation after an underrun, so the buffer grows in response to underflows
+	double PendingUnderflowSeconds = 0.0;
+};
@@ -25,9 +25,11 @@
 
 // engine includes
 #include "Async/Async.h"
+#include "UObject/UObjectIterator.h"
 
 // plugin includes
 #include "A2XSession.h"
+#include "ACEAudioCurveSourceComponent.h"
 #include "ACERuntimePrivate.h"
 #include "AnimDataConsumerRegistry.h"
 
@@ -156,6 +158,20 @@ void FACERuntimeModule::AllocateA2F3DResources(FName ProviderName)
 		// This is only a runtime resource optimization hint, not something that anyone needs to wait on for completion,
 		// so we discard the TFuture returned by AsyncThread.
 		AsyncThread([Provider] { Provider->AllocateResources(); });
+
+		// Also have every curve source in the world create its audio component for the default A2F audio format now,
+		// so the first animation doesn't pay for audio component creation before it starts playing.
+		AsyncTask(ENamedThreads::GameThread, []
+		{
+			for (TObjectIterator<UACEAudioCurveSourceComponent> It; It; ++It)
+			{
+				UACEAudioCurveSourceComponent* CurveSource = *It;
+				if (IsValid(CurveSource) && !CurveSource->IsTemplate() && CurveSource->IsRegistered())
+				{
+					CurveSource->PrewarmAudio();
+				}
+			}
+		});
 	}
 }
 
@@ -25,4 +25,5 @@
 #include "CoreMinimal.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogACERuntime, Log, All);
+DECLARE_STATS_GROUP(TEXT("ACE"), STATGROUP_ACE, STATCAT_Advanced);
 
@@ -96,6 +96,12 @@ void FAnimNode_ApplyACEAnimation::PreUpdate(const UAnimInstance* InAnimInstance)
 	{
 		CachedWeights.Reset();
 
+		if (!CurveSource->IsStreamActive())
+		{
+			// idle, so there are no curves to fetch. Any blend out is handled from LastCurveVals in Evaluate_AnyThread
+			return;
+		}
+
 		if (bInterpolate)
 		{
 			CurveSource->GetCurveOutputsInterp(CachedWeights);
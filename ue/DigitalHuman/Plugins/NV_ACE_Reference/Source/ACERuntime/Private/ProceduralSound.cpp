@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ProceduralSound.h"
+
+
+int32 UBetterSoundWaveProcedural::GeneratePCMData(uint8* PCMData, const int32 SamplesNeeded)
+{
+	const int32 BytesGenerated = Super::GeneratePCMData(PCMData, SamplesNeeded);
+	const uint32 SamplesGenerated = (SampleByteSize > 0) ? static_cast<uint32>(BytesGenerated / SampleByteSize) : 0;
+	if (SamplesGenerated > 0)
+	{
+		// only the audio render thread writes, so a plain increment pair is enough to mark the update
+		++ClockSequence;
+		ConsumedSamples += SamplesGenerated;
+		LastBlockSamples = SamplesGenerated;
+		LastBlockTime = FPlatformTime::Seconds();
+		++ClockSequence;
+	}
+	return BytesGenerated;
+}
+
+bool UBetterSoundWaveProcedural::GetSampleClock(uint64& OutConsumedSamples, uint32& OutLastBlockSamples, double& OutLastBlockTime) const
+{
+	uint32 SequenceBefore = 0;
+	uint32 SequenceAfter = 0;
+	do
+	{
+		SequenceBefore = ClockSequence;
+		OutConsumedSamples = ConsumedSamples;
+		OutLastBlockSamples = LastBlockSamples;
+		OutLastBlockTime = LastBlockTime;
+		SequenceAfter = ClockSequence;
+	} while ((SequenceBefore != SequenceAfter) || ((SequenceBefore & 1) != 0));
+
+	return OutConsumedSamples > 0;
+}
@@ -27,7 +27,9 @@
 
 #include "ProceduralSound.generated.h"
 
-// like USoundWaveProcedural but it properly handles float format too
+// like USoundWaveProcedural but it properly handles float format too.
+// Also counts samples consumed by the audio renderer, so the game thread can derive playback time without relying on
+// FMixerSource::GetPlaybackPercent
 UCLASS(MinimalAPI)
 class UBetterSoundWaveProcedural : public USoundWaveProcedural
 {
@@ -38,5 +40,22 @@ public:
 	{
 		return (SampleByteSize == 4) ? Audio::EAudioMixerStreamDataFormat::Float : Audio::EAudioMixerStreamDataFormat::Int16;
 	}
+
+	// called from the audio render thread
+	virtual int32 GeneratePCMData(uint8* PCMData, const int32 SamplesNeeded) override;
+
+	// Safe to call from any thread. Returns false if the renderer hasn't consumed any samples yet.
+	// OutConsumedSamples: total samples (all channels) handed to the renderer, including any underflow padding
+	// OutLastBlockSamples: samples handed to the renderer in the most recent GeneratePCMData call
+	// OutLastBlockTime: FPlatformTime::Seconds() at the most recent GeneratePCMData call
+	bool GetSampleClock(uint64& OutConsumedSamples, uint32& OutLastBlockSamples, double& OutLastBlockTime) const;
+
+private:
+	// Published from the audio render thread. ClockSequence is odd while an update is in progress, so readers can
+	// retry rather than see a sample count from one block paired with the time of another.
+	std::atomic<uint32> ClockSequence{ 0 };
+	std::atomic<uint64> ConsumedSamples{ 0 };
+	std::atomic<uint32> LastBlockSamples{ 0 };
+	std::atomic<double> LastBlockTime{ 0.0 };
 };
 
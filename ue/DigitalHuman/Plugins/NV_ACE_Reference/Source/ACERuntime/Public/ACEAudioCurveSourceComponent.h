@@ -41,6 +41,7 @@
 
 
 enum ESoundGroup : int;
+class FACEPlayoutDelayEstimator;
 class FSoundSource;
 class UAudioComponent;
 class USoundAttenuation;
@@ -75,10 +76,26 @@ public:
 	UACEAudioCurveSourceComponent(FVTableHelper& Helper);
 	virtual ~UACEAudioCurveSourceComponent();
 
-	/** How many seconds of received audio to buffer before beginning playback */
+	/** How many seconds of received audio to buffer before beginning playback. With an adaptive buffer, this is only used until some arrival jitter has been observed */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ACE Config")
 	float BufferLengthInSeconds = 0.1f;
 
+	/** Choose how much audio to buffer before playback from observed arrival jitter of received audio, instead of always using BufferLengthInSeconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ACE Config")
+	bool bAdaptiveBuffer = true;
+
+	/** Fraction of observed audio chunk lateness the adaptive buffer should absorb. Higher values add latency but reduce audio underflows */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ACE Config", meta = (EditCondition = "bAdaptiveBuffer", ClampMin = "0.5", ClampMax = "1.0", UIMin = "0.5", UIMax = "1.0"))
+	float AdaptiveBufferPercentile = 0.95f;
+
+	/** Smallest amount of audio in seconds the adaptive buffer will hold before beginning playback */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ACE Config", meta = (EditCondition = "bAdaptiveBuffer", ClampMin = "0.0", UIMin = "0.0"))
+	float MinBufferLengthInSeconds = 0.02f;
+
+	/** Largest amount of audio in seconds the adaptive buffer will hold before beginning playback */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ACE Config", meta = (EditCondition = "bAdaptiveBuffer", ClampMin = "0.0", UIMin = "0.0"))
+	float MaxBufferLengthInSeconds = 0.5f;
+
 	/** When "au.3dVisualize.Attenuation" has been specified, draw this sound's attenuation shape when the sound is audible. For debugging purposes only. */
 	UPROPERTY(EditAnywhere, Category = Developer)
 	uint8 bEnableAttenuationDebug : 1;
@@ -135,6 +152,24 @@ public:
 	/** Stop audio and animation */
 	void Stop();
 
+	/** Whether a stream is attached or animation is still playing. When false there's no work to do and no curves to fetch */
+	bool IsStreamActive() const { return bStreamOpen || (AnimState != EAnimState::IDLE); }
+
+	/** Seconds of audio that were buffered before playback of the most recent clip began */
+	UFUNCTION(BlueprintPure, Category = "ACE Config")
+	float GetCurrentBufferLength() const { return CurrentBufferLength; }
+
+	/** Number of times playback ran out of received audio before the end of a clip */
+	UFUNCTION(BlueprintPure, Category = "ACE Config")
+	int32 GetUnderflowCount() const { return NumUnderflows; }
+
+	/** Seconds from the most recent stream being attached to this component until its audio started playing */
+	UFUNCTION(BlueprintPure, Category = "ACE Config")
+	float GetLastStreamStartLatency() const { return LastStreamStartLatency; }
+
+	/** Create an idle audio component for the given audio format ahead of time, so the first stream using it doesn't have to. Game thread only */
+	void PrewarmAudio(int32 SampleRate = 16'000, int32 NumChannels = 1, int32 SampleByteSize = 2);
+
 	// IACEAnimDataConsumer interface
 	virtual void PrepareNewStream_AnyThread(int32 StreamID, uint32 SampleRate, int32 NumChannels, int32 SampleByteSize) override;
 	virtual void ConsumeAnimData_AnyThread(const FACEAnimDataChunk& Chunk, int32 SessionID) override;
@@ -149,7 +184,18 @@ private:
 	UPROPERTY()
 	TObjectPtr<UAudioComponent> AudioComponent;
 	int32 TotalUnderflowSamples;
+	TUniquePtr<FACEPlayoutDelayEstimator> PlayoutDelayEstimator;
 	FCriticalSection AudioCompCS;
+	std::atomic<float> CurrentBufferLength;
+	std::atomic<int32> NumUnderflows;
+
+	// idle audio components kept for reuse, keyed by MakeAudioFormatKey. game thread only
+	UPROPERTY()
+	TMap<uint64, TObjectPtr<UAudioComponent>> PooledAudioComponents;
+	uint64 AudioComponentFormatKey;
+	std::atomic<int32> PreparedStreamID;
+	std::atomic<double> StreamPrepareTime;
+	std::atomic<float> LastStreamStartLatency;
 
 	UE::FManualResetEvent AudioCompReady;
 
@@ -171,6 +217,13 @@ private:
 	float AudioPlaybackTimeEstimate;
 	float CurrentPlaybackTime;
 	float LastAnimPlaybackTime;
+	// audio render position from the procedural sound wave's sample clock, updated by EvaluateAndUpdateCurrentPlaybackTime
+	bool bHasAudioClock;
+	float RenderedAudioBlockLength;
+	// independent A/V sync reference: unclamped wall clock time since the stream's first sample was rendered
+	double AudioClockOriginTime;
+	uint64 LastConsumedSamples;
+	float WallClockAudioTime;
 	static const uint32 NUM_RECENT_PLAYBACK_TIMES = 20;
 	TStaticArray<float, NUM_RECENT_PLAYBACK_TIMES> RecentPlaybackTimes;
 	uint32 RecentPlaybackIdx = 0;
@@ -190,6 +243,8 @@ private:
 	};
 	std::atomic<EAnimState> AnimState{ EAnimState::IDLE };
 	std::atomic_bool bAnimationAllFramesRecived;
+	// set when a stream is prepared, cleared when its last chunk is received or the animation is stopped
+	std::atomic_bool bStreamOpen{ false };
 	std::atomic<float> AudioSampleRate;
 	std::atomic<int32> NumAudioChannels;
 	std::atomic<int32> AudioSampleByteSize;
@@ -198,14 +253,23 @@ private:
 
 private:
 	UAudioComponent* CreateAudioComponent_GameThread(uint32 SampleRate, int32 NumChannels, int32 SampleByteSize);
+	class UBetterSoundWaveProcedural* CreateSoundWave_GameThread(uint32 SampleRate, int32 NumChannels, int32 SampleByteSize);
+	UAudioComponent* AcquireAudioComponent_GameThread(uint32 SampleRate, int32 NumChannels, int32 SampleByteSize);
+	void ReleaseAudioComponent_GameThread(UAudioComponent* InAudioComponent, uint64 FormatKey);
+	void ResetAudioComponent_GameThread(UAudioComponent* InAudioComponent, uint32 SampleRate, int32 NumChannels, int32 SampleByteSize);
+	void ApplyAttenuationSettings(UAudioComponent* InAudioComponent) const;
+	static uint64 MakeAudioFormatKey(uint32 SampleRate, int32 NumChannels, int32 SampleByteSize);
 	void HandlePlaybackFraction(const UAudioComponent* InComponent, const USoundWave* InSoundWave, const float InPlaybackFraction);
 	void HandleSoundUnderflow(USoundWaveProcedural* InProceduralWave, int32 SamplesRequired);
 	const int32 GetCurrentSampleIdx();
 	void EvaluateAndUpdateCurrentPlaybackTime();
+	bool UpdateAudioClock_GameThread(float& OutPlaybackTime);
+	void RecordAVSyncOffset(float AnimationTime) const;
 	void PrepareNewAudioComponent_GameThread(int32 StreamID, uint32 SampleRate, int32 NumChannels, int32 SampleByteSize);
 	const FSoundSource* FindSoundSourceAudioThread(const USoundWaveProcedural* SoundWave);
 	bool IsAnimationActive() const { return AnimState != EAnimState::IDLE && AnimState != EAnimState::ENDING; }
 	bool IsPlaybackActive() const { return AnimState == EAnimState::STARTED || AnimState == EAnimState::IN_PROGRESS; }
+	void SleepIfIdle_GameThread();
 	void ResetAnimSamples();
 };
 
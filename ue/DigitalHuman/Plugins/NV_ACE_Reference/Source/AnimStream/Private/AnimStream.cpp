@@ -24,7 +24,12 @@
 #include "AnimStream.h"
 
 // engine includes
+#include "Algo/Count.h"
 #include "Containers/StringConv.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/QueuedThreadPool.h"
 
 // plugin includes
 #include "AIMModule.h"
@@ -38,6 +43,13 @@
 
 const char* MODEL_STRING = "{CA7BC62F-BCF5-4981-926E-01CE7E1C6E35}";
 
+static TAutoConsoleVariable<int32> CVarAnimStreamWorkers(
+	TEXT("au.ace.animstream.workers"),
+	16,
+	TEXT("Number of worker threads shared by all ACE animgraph streams. Each streaming subscription occupies one worker while it's receiving, ")
+	TEXT("additional subscriptions get a dedicated thread until the pool has room again. Read when the first stream is created. (default: 16)"),
+	ECVF_Default);
+
 
 ////////////////////////
 // FAIMAnimgraphFeature
@@ -80,11 +92,58 @@ FAIMAnimgraphFeature::~FAIMAnimgraphFeature()
 //////////////////
 // FACEAnimStream
 
+struct FACEAnimStream::FOverflowThread : public FRunnable
+{
+	explicit FOverflowThread(FAnimStreamWork* InWork) : Work(InWork) {}
+
+	virtual uint32 Run() override
+	{
+		Work->DoThreadedWork();
+		return 0;
+	}
+
+	FAnimStreamWork* Work;
+	TUniquePtr<FRunnableThread> Thread;
+};
+
 FACEAnimStream::FACEAnimStream()
 {
 	FAIMModule::Get().RegisterAIMFeature(nvaim::plugin::animgraph::kId, {}, { nvaim::plugin::a2x::cloud::grpc::kId });
 }
 
+FACEAnimStream::~FACEAnimStream()
+{
+	// ask every stream to wrap up, then wait for the workers. Streams that haven't started yet get abandoned.
+	for (const TUniquePtr<FAnimStreamWork>& Stream : Streams)
+	{
+		Stream->Stop();
+	}
+	if (WorkerPool != nullptr)
+	{
+		WorkerPool->Destroy();
+		delete WorkerPool;
+		WorkerPool = nullptr;
+	}
+	for (TPair<const FAnimStreamWork*, TUniquePtr<FOverflowThread>>& Overflow : OverflowThreads)
+	{
+		Overflow.Value->Thread->WaitForCompletion();
+	}
+	OverflowThreads.Reset();
+	Streams.Reset();
+	// close any warm connections while the animgraph feature is still loaded
+	ConnectionCache.Reset();
+}
+
+int32 FACEAnimStream::GetNumActiveStreams() const
+{
+	return Algo::CountIf(Streams, [](const TUniquePtr<FAnimStreamWork>& Stream) { return !IsFinalState(Stream->GetState()); });
+}
+
+TArray<FAnimgraphConnectionStats> FACEAnimStream::GetConnectionStats() const
+{
+	return ConnectionCache.IsValid() ? ConnectionCache->GetStats() : TArray<FAnimgraphConnectionStats>();
+}
+
 int32 FACEAnimStream::CreateStream(IACEAnimDataConsumer* Consumer, FString InStreamName, FString InURL, int32 InNumOfRetries, float InTimeBetweenRetries, float RPCTimeout)
 {
 	// clean up any old dead streams we have lying around
@@ -107,25 +166,68 @@ int32 FACEAnimStream::CreateStream(IACEAnimDataConsumer* Consumer, FString InStr
 		UE_LOG(LogACEAnimStream, Log, TEXT("Unable to create new ACE animation stream, no AIM animgraph feature available"));
 		return -1;
 	}
+	if (!ConnectionCache.IsValid())
+	{
+		ConnectionCache = MakeShared<FAnimgraphConnectionCache>(Animgraph);
+	}
+
+	// create the shared worker pool if it hasn't already been created
+	if (WorkerPool == nullptr)
+	{
+		const int32 NewNumWorkers = FMath::Max(1, CVarAnimStreamWorkers.GetValueOnAnyThread());
+		FQueuedThreadPool* NewWorkerPool = FQueuedThreadPool::Allocate();
+		if (!NewWorkerPool->Create(NewNumWorkers, 0, TPri_Normal, TEXT("ACE AnimStream")))
+		{
+			UE_LOG(LogACEAnimStream, Log, TEXT("Unable to create new ACE animation stream, failed to start %d stream workers"), NewNumWorkers);
+			delete NewWorkerPool;
+			return -1;
+		}
+		WorkerPool = NewWorkerPool;
+		NumWorkers = NewNumWorkers;
+	}
 
 	int32 StreamID = Registry->CreateStream_AnyThread();
 	if (Consumer != nullptr)
 	{
 		// Assume 16000 samples per second mono audio, since that's the default.
-		// The anim stream thread will call SetAudioParams_AnyThread if that assumption is wrong.
+		// The anim stream work will call SetAudioParams_AnyThread if that assumption is wrong.
 		Registry->AttachConsumerToStream_AnyThread(StreamID, Consumer, DEFAULT_SAMPLE_RATE, DEFAULT_NUM_CHANNELS);
 	}
 
-	StreamThreads.Emplace(
-		MakeUnique<FAnimStreamThread>(StreamID, InURL, InStreamName, Animgraph,
-			InNumOfRetries, InTimeBetweenRetries, RPCTimeout));
-
-	if (StreamThreads.Last()->GetState() == EACEAnimStreamState::CONNECTION_FAILED)
+	TUniquePtr<FAnimStreamWork> Stream = MakeUnique<FAnimStreamWork>(StreamID, InURL, InStreamName, ConnectionCache,
+		InNumOfRetries, InTimeBetweenRetries, RPCTimeout);
+	if (!Stream->Connect())
 	{
-		GC();
 		return -1;
 	}
 
+	// GC() above dropped finished streams, so everything left is running either on the pool or on an overflow thread
+	const int32 NumPoolStreams = GetNumActiveStreams() - OverflowThreads.Num();
+	bool bQueued = false;
+	if (NumPoolStreams >= NumWorkers)
+	{
+		TUniquePtr<FOverflowThread> Overflow = MakeUnique<FOverflowThread>(Stream.Get());
+		Overflow->Thread.Reset(FRunnableThread::Create(Overflow.Get(), *FString::Printf(TEXT("ACE AnimStream %d"), StreamID)));
+		if (Overflow->Thread.IsValid())
+		{
+			UE_LOG(LogACEAnimStream, Log, TEXT("[ACE SID %d] all %d animation stream workers are busy, running stream on its own thread. Increase au.ace.animstream.workers if this happens regularly"),
+				StreamID, NumWorkers);
+			OverflowThreads.Add(Stream.Get(), MoveTemp(Overflow));
+			bQueued = true;
+		}
+		else
+		{
+			UE_LOG(LogACEAnimStream, Warning, TEXT("[ACE SID %d] all %d animation stream workers are busy and no overflow thread could be started, stream will wait for a free worker"),
+				StreamID, NumWorkers);
+		}
+	}
+
+	if (!bQueued)
+	{
+		WorkerPool->AddQueuedWork(Stream.Get());
+	}
+	Streams.Emplace(MoveTemp(Stream));
+
 	return StreamID;
 }
 
@@ -149,10 +251,20 @@ void FACEAnimStream::CancelStream(IACEAnimDataConsumer* Consumer)
 
 void FACEAnimStream::GC()
 {
-	// clean up any runnable objects in their final state
-	StreamThreads.RemoveAll([](const TUniquePtr<class FAnimStreamThread>& StreamThread)
+	// clean up any stream work in its final state
+	Streams.RemoveAll([this](const TUniquePtr<class FAnimStreamWork>& Stream)
 	{
-		return !StreamThread.IsValid() || IsFinalState(StreamThread->GetState());
+		if (Stream.IsValid() && !IsFinalState(Stream->GetState()))
+		{
+			return false;
+		}
+		// an overflow thread may still be returning from DoThreadedWork, so join it before the work is deleted
+		if (TUniquePtr<FOverflowThread>* Overflow = OverflowThreads.Find(Stream.Get()))
+		{
+			(*Overflow)->Thread->WaitForCompletion();
+			OverflowThreads.Remove(Stream.Get());
+		}
+		return true;
 	});
 }
 
@@ -28,7 +28,8 @@
 
 // project includes
 #include "AnimDataConsumer.h"
-#include "AnimStreamThread.h"
+#include "AnimgraphConnectionCache.h"
+#include "AnimStreamWork.h"
 
 
 namespace nvaim
@@ -50,6 +51,7 @@ class FACEAnimStream: FNoncopyable
 public:
 
 	FACEAnimStream();
+	~FACEAnimStream();
 
 	// Returns new stream ID, or -1 if stream can't be created
 	int32 CreateStream(class IACEAnimDataConsumer* Consumer, FString InStreamName, FString InURL, int32 NumOfRetries, float TimeBetweenRetries, float RPCTimeout);
@@ -59,10 +61,32 @@ public:
 	void CancelStream(int32 StreamID);
 	void CancelStream(class IACEAnimDataConsumer* Consumer);
 
+	// Number of threads in the shared stream worker pool, 0 until the first stream is created
+	int32 GetNumWorkers() const { return NumWorkers; }
+
+	// Number of streams that are running, on the pool or on an overflow thread
+	int32 GetNumActiveStreams() const;
+
+	// Number of running streams that didn't fit in the pool and got a dedicated thread
+	int32 GetNumOverflowStreams() const { return OverflowThreads.Num(); }
+
+	// Connection state and reconnect counters for each animgraph URL used so far
+	TArray<FAnimgraphConnectionStats> GetConnectionStats() const;
+
 private:
 
-	TArray<TUniquePtr<class FAnimStreamThread>> StreamThreads;
+	// Streams run as queued work on a fixed size pool instead of each getting their own thread. Each running stream
+	// occupies a worker for the duration of its RPC, since AIM's animgraph evaluate blocks until the stream is done.
+	TArray<TUniquePtr<class FAnimStreamWork>> Streams;
+	class FQueuedThreadPool* WorkerPool = nullptr;
+	int32 NumWorkers = 0;
 	TSharedPtr<FAIMAnimgraphFeature> Animgraph;
+	TSharedPtr<FAnimgraphConnectionCache> ConnectionCache;
+
+	// Streams created while every pool worker is busy get a dedicated thread instead of queueing behind a stream that
+	// might run for a long time, so bursts above au.ace.animstream.workers never stall
+	struct FOverflowThread;
+	TMap<const class FAnimStreamWork*, TUniquePtr<FOverflowThread>> OverflowThreads;
 
 private:
 
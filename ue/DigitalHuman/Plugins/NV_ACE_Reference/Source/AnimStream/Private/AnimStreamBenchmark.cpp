@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+// Subscription latency and CPU cost benchmark for animgraph streams.
+// Usage: au.ace.animstream.benchmark <StreamName> [NumStreams...=1 10 100]
+// For each stream count, subscribes that many consumers to StreamName on the current animgraph server, lets them run
+// for a few seconds, then unsubscribes them. Requires a running animgraph service with an active stream of that name.
+
+// engine includes
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadManager.h"
+
+// plugin includes
+#include "AnimDataConsumer.h"
+#include "AnimStreamModule.h"
+#include "AnimStreamPrivate.h"
+
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+	const float SAMPLE_SECONDS = 5.0f;
+
+	class FBenchmarkConsumer : public IACEAnimDataConsumer
+	{
+	public:
+		virtual void PrepareNewStream_AnyThread(int32 StreamID, uint32 SampleRate, int32 NumChannels, int32 SampleByteSize) override {}
+		virtual void ConsumeAnimData_AnyThread(const FACEAnimDataChunk& AnimData, int32 StreamID) override
+		{
+			++NumChunks;
+		}
+
+		std::atomic<int32> NumChunks = 0;
+	};
+
+	int32 GetNumThreads()
+	{
+		int32 NumThreads = 0;
+		FThreadManager::Get().ForEachThread([&NumThreads](uint32 ThreadId, FRunnableThread* Thread) { ++NumThreads; });
+		return NumThreads;
+	}
+
+	struct FAnimStreamBenchmark
+	{
+		FString StreamName;
+		TArray<int32> StreamCounts;
+		int32 StepIdx = 0;
+		TArray<TUniquePtr<FBenchmarkConsumer>> Consumers;
+		double BaselineCPUPct = 0.0;
+		int32 BaselineThreads = 0;
+
+		// subscribe consumers for the current step, returns false if there's nothing left to do
+		bool StartStep()
+		{
+			if (!StreamCounts.IsValidIndex(StepIdx))
+			{
+				return false;
+			}
+
+			BaselineCPUPct = FPlatformTime::GetCPUTime().CPUTimePct;
+			BaselineThreads = GetNumThreads();
+
+			const int32 NumStreams = StreamCounts[StepIdx];
+			double TotalSubscribeSeconds = 0.0;
+			double MaxSubscribeSeconds = 0.0;
+			int32 NumFailed = 0;
+			for (int32 Idx = 0; Idx < NumStreams; ++Idx)
+			{
+				Consumers.Add(MakeUnique<FBenchmarkConsumer>());
+				const double StartTime = FPlatformTime::Seconds();
+				if (!FAnimStreamModule::Get().SubscribeCharacterToStream(Consumers.Last().Get(), StreamName))
+				{
+					++NumFailed;
+				}
+				const double SubscribeSeconds = FPlatformTime::Seconds() - StartTime;
+				TotalSubscribeSeconds += SubscribeSeconds;
+				MaxSubscribeSeconds = FMath::Max(MaxSubscribeSeconds, SubscribeSeconds);
+			}
+
+			UE_LOG(LogACEAnimStream, Display, TEXT("au.ace.animstream.benchmark: %d streams subscribed (%d failed): avg %.2f ms, max %.2f ms per subscription"),
+				NumStreams, NumFailed, 1000.0 * TotalSubscribeSeconds / NumStreams, 1000.0 * MaxSubscribeSeconds);
+			return true;
+		}
+
+		// measure and unsubscribe consumers for the current step
+		void EndStep()
+		{
+			const int32 NumStreams = StreamCounts[StepIdx];
+			const double CPUPct = FPlatformTime::GetCPUTime().CPUTimePct;
+			const int32 NumThreads = GetNumThreads();
+			int32 NumChunks = 0;
+			for (const TUniquePtr<FBenchmarkConsumer>& Consumer : Consumers)
+			{
+				NumChunks += Consumer->NumChunks;
+				FAnimStreamModule::Get().UnsubscribeFromStream(Consumer.Get());
+			}
+			Consumers.Reset();
+
+			UE_LOG(LogACEAnimStream, Display, TEXT("au.ace.animstream.benchmark: %d streams: %.2f%% process CPU per stream, %d extra threads, %.1f chunks/s per stream"),
+				NumStreams, (CPUPct - BaselineCPUPct) / NumStreams, NumThreads - BaselineThreads, NumChunks / (SAMPLE_SECONDS * NumStreams));
+			++StepIdx;
+		}
+	};
+
+	void RunAnimStreamBenchmark(const TArray<FString>& Args)
+	{
+		if (Args.IsEmpty())
+		{
+			UE_LOG(LogACEAnimStream, Display, TEXT("Usage: au.ace.animstream.benchmark <StreamName> [NumStreams...]"));
+			return;
+		}
+
+		TSharedRef<FAnimStreamBenchmark> Benchmark = MakeShared<FAnimStreamBenchmark>();
+		Benchmark->StreamName = Args[0];
+		for (int32 Idx = 1; Idx < Args.Num(); ++Idx)
+		{
+			Benchmark->StreamCounts.Add(FMath::Max(1, FCString::Atoi(*Args[Idx])));
+		}
+		if (Benchmark->StreamCounts.IsEmpty())
+		{
+			Benchmark->StreamCounts = { 1, 10, 100 };
+		}
+
+		// keep the engine ticking while streams run so CPU usage stays up to date
+		if (Benchmark->StartStep())
+		{
+			FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Benchmark](float DeltaTime)
+			{
+				Benchmark->EndStep();
+				return Benchmark->StartStep();
+			}), SAMPLE_SECONDS);
+		}
+	}
+
+	FAutoConsoleCommand CmdACEAnimStreamBenchmark(
+		TEXT("au.ace.animstream.benchmark"),
+		TEXT("Measure animgraph stream subscription latency and CPU cost per stream. Args: <StreamName> [NumStreams...]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunAnimStreamBenchmark));
+}
+
+#endif
@@ -25,6 +25,7 @@
 #include "CoreMinimal.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogACEAnimStream, Log, All);
+DECLARE_STATS_GROUP(TEXT("ACE"), STATGROUP_ACE, STATCAT_Advanced);
 
 // This string seems to correspond to an AIM Models subfolder, gets passed in as animgraph common parameters
 extern const char* MODEL_STRING;
@@ -21,102 +21,25 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
-#include "AnimStreamThread.h"
+#include "AnimStreamWork.h"
 
 // engine includes
 #include "Containers/StringConv.h"
-#include "GenericPlatform/GenericPlatformHttp.h"
 #include "HAL/PlatformProcess.h"
-#include "HAL/RunnableThread.h"
 
 // plugin includes
 #include "AIMModule.h"
 #include "AnimDataConsumerRegistry.h"
+#include "AnimgraphConnectionCache.h"
 #include "AnimStream.h"
 #include "AnimStreamPrivate.h"
 #include "nvaim.h"
 #include "nvaim_ai.h"
 #include "nvaim_animgraph.h"
-#include "nvaim_cloud.h"
 
+DECLARE_CYCLE_STAT(TEXT("AnimStream Receive Callback"), STAT_ACEAnimStreamCallback, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AnimStream Silence Padding (bytes)"), STAT_ACEAnimStreamSilenceBytes, STATGROUP_ACE);
 
-static nvaim::InferenceInstance* CreateAnimgraphConnection(nvaim::InferenceInterface* AnimgraphFeature, FString DestURL, int32 NumOfRetries, float TimeBetweenRetries, float RPCTimeout)
-{
-	if (!ensure(AnimgraphFeature != nullptr))
-	{
-		return nullptr;
-	}
-
-	nvaim::AnimgraphCreationParameters AnimgraphCreationParams;
-	nvaim::CommonCreationParameters CommonCreationParams;
-
-	auto ModelDirUTF8 = StringCast<UTF8CHAR>(*FAIMModule::Get().GetModelDirectory());
-	CommonCreationParams.utf8PathToModels = reinterpret_cast<const char*>(ModelDirUTF8.Get());
-	CommonCreationParams.numThreads = 4;	// just guessing, I don't know how to tell how many threads AIM needs
-	CommonCreationParams.vramBudgetMB = 0;	// If AIM uses any VRAM at all in its gRPC implementation, something has gone horribly awry
-	CommonCreationParams.modelGUID = MODEL_STRING;
-	AnimgraphCreationParams.common = &CommonCreationParams;
-
-	// connection timeout in ms
-	float RPCTimeoutMs = 1000.0f * RPCTimeout;
-	AnimgraphCreationParams.connection_timeout_in_ms = static_cast<uint32_t>(FMath::Clamp(static_cast<int32_t>(RPCTimeoutMs), 1, nvaim::ANIMGRAPH_MAX_CONNECTION_TIMEOUT_IN_MS));
-	UE_LOG(LogACEAnimStream, Verbose, TEXT("Animgraph gRPC timeout = %d ms"), AnimgraphCreationParams.connection_timeout_in_ms);
-
-
-	if (DestURL.IsEmpty())
-	{
-		UE_LOG(LogACEAnimStream, Warning, TEXT("No server address configured, please configure in Project Settings->ACE Settings->Default Animgraph Server URL"));
-		return nullptr;
-	}
-	if (!DestURL.StartsWith("http"))
-	{
-		UE_LOG(LogACEAnimStream, Warning, TEXT("Server address does not start with http or https, defaulting to non secure connection"));
-	}
-
-	nvaim::RPCParameters GRPCParams{};
-	FString URLWithoutScheme = FGenericPlatformHttp::GetUrlDomainAndPort(DestURL);
-	auto URLWithoutSchemeUTF8 = StringCast<UTF8CHAR>(*URLWithoutScheme);
-	TOptional<bool> MaybeIsHttps = FGenericPlatformHttp::IsSecureProtocol(DestURL);
-
-	GRPCParams.url = reinterpret_cast<const char*>(URLWithoutSchemeUTF8.Get());
-	GRPCParams.useSSL = MaybeIsHttps.IsSet() ? *MaybeIsHttps : false;	// assume http scheme if not specified
-	GRPCParams.metaData = "";	// AIM will refuse to create a connection with null metaData, we have to provide empty string
-	AnimgraphCreationParams.chain(GRPCParams);
-
-	nvaim::InferenceInstance* Connection = nullptr;
-	nvaim::Result Result = nvaim::ResultInvalidState;
-
-	for (int32 i = 0 ; i < NumOfRetries ; ++i)
-	{
-		Result = AnimgraphFeature->createInstance(AnimgraphCreationParams, &Connection);
-		if (Result != nvaim::ResultOk)
-		{
-
-			UE_LOG(LogACEAnimStream, Warning, TEXT("Unable to create animgraph instance, try %d of %d"),i,NumOfRetries);
-			
-			if (TimeBetweenRetries != 0.f)
-			{
-				UE_LOG(LogACEAnimStream, Warning, TEXT("Retring in: %f"),TimeBetweenRetries);
-				FPlatformProcess::Sleep(TimeBetweenRetries);
-			}
-		}
-		else
-		{
-			break;
-		}
-
-	}
-	
-	if (Result != nvaim::ResultOk)
-	{
-		UE_LOG(LogACEAnimStream, Warning,
-			TEXT("Unable to create animgraph instance (%s). nvaim::RPCParameters::url=\"%s\", nvaim::RPCParameters::useSSL=%s, nvaim::RPCParameters::metaData=\"%s\""),
-			*GetAIMStatusString(Result), UTF8_TO_TCHAR(GRPCParams.url), GRPCParams.useSSL ? TEXT("true") : TEXT("false"), UTF8_TO_TCHAR(GRPCParams.metaData));
-		return nullptr;
-	}
-
-	return Connection;
-}
 
 template<class T>
 static T& GetValueFromAIMParameter(const nvaim::NVAIMParameter* AIMParameter)
@@ -276,6 +199,7 @@ static FString GetAIMAnimgraphStatusString(nvaim::AnimgraphStatusCode Status)
 
 static nvaim::InferenceExecutionState AnimgraphCallback(const nvaim::InferenceExecutionContext* AIMContext, nvaim::InferenceExecutionState State, void* InContext)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ACEAnimStreamCallback);
 	FCallbackUserData* UserData = reinterpret_cast<FCallbackUserData*>(InContext);
 
 	if (ensure(AIMContext && UserData))
@@ -357,9 +281,10 @@ static nvaim::InferenceExecutionState AnimgraphCallback(const nvaim::InferenceEx
 			const double LocalAnimTimestamp = Chunk.Timestamp - *UserData->FirstAnimTimestamp;
 			const double LocalAudioTimestamp = Audio.Timestamp - *UserData->FirstAnimTimestamp;
 
-			// Pad start of audio buffer with silence if necessary to align with the audio timestamp
+			// Pad start of audio buffer with silence if necessary to align with the audio timestamp. The padding is
+			// described to the consumer as a silence count rather than copied into a new buffer, so the received audio
+			// is passed through as a view
 			const int32 BytesPerSample = Audio.SampleByteSize * Audio.NumChannels;
-			TArray<uint8> PaddedAudioBuffer;
 			const int64 AUDIO_SAMPLE_FUDGE_FACTOR = 2;
 			// ...but we only need to do so if we got audio samples
 			if (!Chunk.AudioBuffer.IsEmpty())
@@ -368,9 +293,8 @@ static nvaim::InferenceExecutionState AnimgraphCallback(const nvaim::InferenceEx
 				if (UserData->ReceivedAudioSamples < ExpectedTotalAudioSamples)
 				{
 					const int32 ExtraSamplesNeeded = static_cast<int32>(ExpectedTotalAudioSamples - UserData->ReceivedAudioSamples);
-					PaddedAudioBuffer.AddZeroed(BytesPerSample * ExtraSamplesNeeded);
-					PaddedAudioBuffer.Append(Chunk.AudioBuffer);
-					Chunk.AudioBuffer = PaddedAudioBuffer;
+					Chunk.LeadingSilenceBytes = BytesPerSample * ExtraSamplesNeeded;
+					UserData->ReceivedAudioSamples += static_cast<int64>(ExtraSamplesNeeded);
 				}
 				else if (UserData->ReceivedAudioSamples > (ExpectedTotalAudioSamples + AUDIO_SAMPLE_FUDGE_FACTOR))
 				{
@@ -395,15 +319,10 @@ static nvaim::InferenceExecutionState AnimgraphCallback(const nvaim::InferenceEx
 			if (UserData->ReceivedAudioSamples + AUDIO_SAMPLE_FUDGE_FACTOR < ExpectedTotalAudioSamples)
 			{
 				const int32 ExtraSamplesNeeded = static_cast<int32>(ExpectedTotalAudioSamples - UserData->ReceivedAudioSamples);
-				if (PaddedAudioBuffer.IsEmpty())
-				{
-					// we didn't pad the start above, so initialize the array here
-					PaddedAudioBuffer.Append(Chunk.AudioBuffer);
-				}
-				PaddedAudioBuffer.AddZeroed(BytesPerSample * ExtraSamplesNeeded);
-				Chunk.AudioBuffer = PaddedAudioBuffer;
+				Chunk.TrailingSilenceBytes = BytesPerSample * ExtraSamplesNeeded;
 				UserData->ReceivedAudioSamples += static_cast<int64>(ExtraSamplesNeeded);
 			}
+			INC_DWORD_STAT_BY(STAT_ACEAnimStreamSilenceBytes, Chunk.LeadingSilenceBytes + Chunk.TrailingSilenceBytes);
 
 			// send chunk to consumer
 			int32 NumConsumers = Registry->SendAnimData_AnyThread(Chunk, UserData->StreamID);
@@ -429,28 +348,36 @@ static nvaim::InferenceExecutionState AnimgraphCallback(const nvaim::InferenceEx
 	return State;
 }
 
-/////////////////////
-// FAnimStreamThread
+///////////////////
+// FAnimStreamWork
 
-FAnimStreamThread::FAnimStreamThread(int32 InStreamID, FString InURL, FString InStreamName, TSharedPtr<FAIMAnimgraphFeature> InAnimgraph,
+FAnimStreamWork::FAnimStreamWork(int32 InStreamID, FString InURL, FString InStreamName, TSharedPtr<FAnimgraphConnectionCache> InConnectionCache,
 	int32 InNumOfRetries, float InTimeBetweenRetries, float InRPCTimeout) :
 	StreamID(InStreamID), DestURL(InURL), NumOfRetries(InNumOfRetries), TimeBetweenRetries(InTimeBetweenRetries),
-	RPCTimeout(InRPCTimeout), StreamName(InStreamName), Animgraph(InAnimgraph)
+	RPCTimeout(InRPCTimeout), StreamName(InStreamName), ConnectionCache(InConnectionCache)
 {
 	State = EACEAnimStreamState::CONNECTING;
-	Thread.Reset(FRunnableThread::Create(this, *FString::Printf(TEXT("ACE AnimStream %d"), StreamID)));
 }
 
-EACEAnimStreamState FAnimStreamThread::GetState() const
+FAnimStreamWork::~FAnimStreamWork()
+{
+	// only happens if we were connected but never queued
+	if ((Connection != nullptr) && ensure(ConnectionCache.IsValid()))
+	{
+		ConnectionCache->Release(DestURL, Connection, true);
+		Connection = nullptr;
+	}
+}
+
+EACEAnimStreamState FAnimStreamWork::GetState() const
 {
 	return State.load();
 }
 
-// @return True if initialization was successful, false otherwise
-bool FAnimStreamThread::Init()
+bool FAnimStreamWork::Connect()
 {
 	// create connection to animgraph service
-	Connection = CreateAnimgraphConnection(Animgraph->Interface, DestURL, NumOfRetries, TimeBetweenRetries, RPCTimeout);
+	Connection = ConnectionCache->Acquire(DestURL, NumOfRetries, TimeBetweenRetries, RPCTimeout);
 	if (Connection == nullptr)
 	{
 		FAnimDataConsumerRegistry* Registry = FAnimDataConsumerRegistry::Get();
@@ -466,8 +393,20 @@ bool FAnimStreamThread::Init()
 	return true;
 }
 
-// @return The exit code of the runnable object
-uint32 FAnimStreamThread::Run()
+void FAnimStreamWork::DoThreadedWork()
+{
+	bool bConnectionHealthy = false;
+	const uint32 ExitCode = Run(bConnectionHealthy);
+	Finish(ExitCode == 0, bConnectionHealthy);
+}
+
+void FAnimStreamWork::Abandon()
+{
+	Stop();
+	Finish(true, true);
+}
+
+uint32 FAnimStreamWork::Run(bool& bOutConnectionHealthy)
 {
 	// convert StreamName to something AIM likes
 	const auto StreamNameUTF8 = StringCast<UTF8CHAR>(*StreamName);
@@ -526,9 +465,10 @@ uint32 FAnimStreamThread::Run()
 				}
 				else
 				{
-					if (TimeBetweenRetries != 0.f)
+					const float Delay = FAnimgraphConnectionCache::GetRetryDelay(TimeBetweenRetries, CurrentTry - 1);
+					if (Delay > 0.0f)
 					{
-						FPlatformProcess::Sleep(TimeBetweenRetries);
+						FPlatformProcess::Sleep(Delay);
 					}
 
 					UE_LOG(LogACEAnimStream,Warning,TEXT("Invalid Stream ID, Retrying %d of %d"),CurrentTry,NumOfRetries);
@@ -559,6 +499,8 @@ uint32 FAnimStreamThread::Run()
 	}
 
 	// RPC completed, clean up and exit
+	// a connection that lost the stream isn't worth keeping warm for the next one
+	bOutConnectionHealthy = (Result == nvaim::ResultOk) && (UserData.StreamState != EStreamState::ConnectionLost);
 	FAnimDataConsumerRegistry* Registry = FAnimDataConsumerRegistry::Get();
 	if (ensure(Registry != nullptr))
 	{
@@ -567,17 +509,14 @@ uint32 FAnimStreamThread::Run()
 
 	if (Result != nvaim::ResultOk)
 	{
-		State = EACEAnimStreamState::STREAM_FAILED;
 		UE_LOG(LogACEAnimStream, Warning, TEXT("Failed receiving ACE animation stream: %s"), *GetAIMStatusString(Result));
 		return 1;
 	}
 
-	State = EACEAnimStreamState::STREAM_COMPLETE;
 	return 0;
 }
 
-// This is called if a thread is requested to terminate early.
-void FAnimStreamThread::Stop()
+void FAnimStreamWork::Stop()
 {
 	FAnimDataConsumerRegistry* Registry = FAnimDataConsumerRegistry::Get();
 	if (ensure(Registry != nullptr))
@@ -587,23 +526,15 @@ void FAnimStreamThread::Stop()
 	}
 }
 
-// Called in the context of the aggregating thread to perform any cleanup.
-void FAnimStreamThread::Exit()
+void FAnimStreamWork::Finish(bool bSucceeded, bool bConnectionHealthy)
 {
-	if ((Connection != nullptr) && ensure(Animgraph.IsValid()) && (Animgraph->Interface != nullptr))
+	if ((Connection != nullptr) && ensure(ConnectionCache.IsValid()))
 	{
-		Animgraph->Interface->destroyInstance(Connection);
+		// give the connection back so the next stream to this URL doesn't have to reconnect
+		ConnectionCache->Release(DestURL, Connection, bSucceeded && bConnectionHealthy);
 	}
+	Connection = nullptr;
 
-	EACEAnimStreamState LocalState = State;
-	if (!ensureMsgf(IsFinalState(LocalState), TEXT("%d is not final FAnimStreamThread state, forcing STREAM_COMPLETE"), LocalState))
-	{
-		FAnimDataConsumerRegistry* Registry = FAnimDataConsumerRegistry::Get();
-		if (ensure(Registry != nullptr))
-		{
-			// this will prevent consumer from getting any more callbacks, just in case
-			Registry->RemoveStream_AnyThread(StreamID);
-		}
-		State = EACEAnimStreamState::STREAM_COMPLETE;
-	}
+	// Entering a final state lets FACEAnimStream::GC delete this object, so it must be the very last thing we touch
+	State = bSucceeded ? EACEAnimStreamState::STREAM_COMPLETE : EACEAnimStreamState::STREAM_FAILED;
 }
@@ -24,11 +24,10 @@
 
 // engine includes
 #include "CoreMinimal.h"
-#include "HAL/Runnable.h"
-#include "HAL/RunnableThread.h"
+#include "Misc/IQueuedWork.h"
 
 
-struct FAIMAnimgraphFeature;
+class FAnimgraphConnectionCache;
 
 namespace nvaim
 {
@@ -61,29 +60,33 @@ inline bool IsFinalState(EACEAnimStreamState State)
 		(State == EACEAnimStreamState::CONNECTION_FAILED);
 }
 
-class FAnimStreamThread : public FRunnable
+// One animgraph stream subscription. Connect() runs on the subscribing thread, then the streaming RPC itself runs as
+// queued work on FACEAnimStream's shared worker pool instead of on a thread of its own.
+class FAnimStreamWork : public IQueuedWork
 {
 public:
-	FAnimStreamThread(int32 InStreamID, FString InURL, FString InStreamName, TSharedPtr<FAIMAnimgraphFeature> InAnimgraph, int32 NumOfRetries, float TimeBetweenRetries, float RPCTimeout);
+	FAnimStreamWork(int32 InStreamID, FString InURL, FString InStreamName, TSharedPtr<FAnimgraphConnectionCache> InConnectionCache, int32 NumOfRetries, float TimeBetweenRetries, float RPCTimeout);
+	virtual ~FAnimStreamWork();
 
 	EACEAnimStreamState GetState() const;
 
-	///////////////////
-	// begin FRunnable
+	// Get a connection to the animgraph service from the connection cache. May block while retrying.
+	// @return True if the connection was created and the work is ready to be queued, false otherwise
+	bool Connect();
 
-	// @return True if initialization was successful, false otherwise
-	virtual bool Init() override;
+	// Request the stream to terminate early. Consumers won't receive any more callbacks after this returns.
+	void Stop();
 
-	// @return The exit code of the runnable object
-	virtual uint32 Run() override;
+	///////////////////
+	// begin IQueuedWork
 
-	// This is called if a thread is requested to terminate early.
-	virtual void Stop() override;
+	// Runs the streaming RPC until the stream completes or fails
+	virtual void DoThreadedWork() override;
 
-	// Called in the context of the aggregating thread to perform any cleanup.
-	virtual void Exit() override;
+	// Called instead of DoThreadedWork if the pool is shut down before the work started
+	virtual void Abandon() override;
 
-	// end FRunnable
+	// end IQueuedWork
 	///////////////////
 
 private:
@@ -93,9 +96,12 @@ private:
 	float TimeBetweenRetries;
 	float RPCTimeout;
 	FString StreamName;
-	TUniquePtr<FRunnableThread> Thread;
-	TSharedPtr<FAIMAnimgraphFeature> Animgraph;
+	TSharedPtr<FAnimgraphConnectionCache> ConnectionCache;
 	nvaim::InferenceInstance* Connection = nullptr;
 	std::atomic<EACEAnimStreamState> State;
+
+private:
+	uint32 Run(bool& bOutConnectionHealthy);
+	void Finish(bool bSucceeded, bool bConnectionHealthy);
 };
 
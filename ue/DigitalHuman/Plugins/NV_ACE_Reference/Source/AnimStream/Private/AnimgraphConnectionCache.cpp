@@ -0,0 +1,359 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AnimgraphConnectionCache.h"
+
+// engine includes
+#include "Containers/StringConv.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/ScopeLock.h"
+
+// plugin includes
+#include "AIMModule.h"
+#include "AnimStream.h"
+#include "AnimStreamPrivate.h"
+#include "nvaim.h"
+#include "nvaim_ai.h"
+#include "nvaim_animgraph.h"
+#include "nvaim_cloud.h"
+
+
+static TAutoConsoleVariable<float> CVarAnimStreamMaxRetryDelay(
+	TEXT("au.ace.animstream.maxretrydelay"),
+	10.0f,
+	TEXT("Upper limit in seconds for the exponential backoff between animgraph connection retries. (default: 10.0)"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAnimStreamBreakerThreshold(
+	TEXT("au.ace.animstream.breaker.threshold"),
+	5,
+	TEXT("Consecutive failed connection attempts to an animgraph URL before new connection requests to it fail immediately. (default: 5)"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAnimStreamBreakerCooldown(
+	TEXT("au.ace.animstream.breaker.cooldown"),
+	30.0f,
+	TEXT("Seconds to fail animgraph connection requests immediately after the failure threshold was reached, before probing the service again. (default: 30.0)"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAnimStreamMaxIdleConnections(
+	TEXT("au.ace.animstream.maxidleconnections"),
+	4,
+	TEXT("Number of warm animgraph connections kept per URL for reuse by later streams. (default: 4)"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAnimStreamIdleTimeout(
+	TEXT("au.ace.animstream.idletimeout"),
+	60.0f,
+	TEXT("Seconds a warm animgraph connection may stay unused before it's closed instead of reused. (default: 60.0)"),
+	ECVF_Default);
+
+static const TCHAR* GetCircuitStateString(EAnimgraphCircuitState State)
+{
+	switch (State)
+	{
+	case EAnimgraphCircuitState::CLOSED:
+		return TEXT("closed");
+	case EAnimgraphCircuitState::OPEN:
+		return TEXT("open");
+	case EAnimgraphCircuitState::HALF_OPEN:
+		return TEXT("half-open");
+	default:
+		return TEXT("invalid");
+	}
+}
+
+
+/////////////////////////////
+// FAnimgraphConnectionCache
+
+FAnimgraphConnectionCache::FAnimgraphConnectionCache(TSharedPtr<FAIMAnimgraphFeature> InAnimgraph) : Animgraph(InAnimgraph)
+{
+	ReportCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("au.ace.animstream.connections"),
+		TEXT("Log connection state and reconnect counters for each animgraph URL"),
+		FConsoleCommandDelegate::CreateRaw(this, &FAnimgraphConnectionCache::LogStats));
+}
+
+FAnimgraphConnectionCache::~FAnimgraphConnectionCache()
+{
+	if (ReportCommand != nullptr)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(ReportCommand);
+	}
+
+	for (TPair<FString, FURLEntry>& Entry : Entries)
+	{
+		for (const FIdleConnection& Idle : Entry.Value.IdleConnections)
+		{
+			DestroyConnection(Idle.Connection);
+		}
+	}
+}
+
+float FAnimgraphConnectionCache::GetRetryDelay(float BaseDelay, int32 Attempt)
+{
+	if (BaseDelay <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	// "equal jitter": half the backoff is fixed, the other half random, so simultaneous retries spread out without
+	// ever retrying immediately
+	const float MaxDelay = FMath::Max(BaseDelay, CVarAnimStreamMaxRetryDelay.GetValueOnAnyThread());
+	const float Backoff = FMath::Min(MaxDelay, BaseDelay * FMath::Pow(2.0f, static_cast<float>(FMath::Min(Attempt, 16))));
+	return 0.5f * Backoff + FMath::FRandRange(0.0f, 0.5f * Backoff);
+}
+
+nvaim::InferenceInstance* FAnimgraphConnectionCache::Acquire(const FString& URL, int32 NumOfRetries, float TimeBetweenRetries, float RPCTimeout)
+{
+	if (URL.IsEmpty())
+	{
+		UE_LOG(LogACEAnimStream, Warning, TEXT("No server address configured, please configure in Project Settings->ACE Settings->Default Animgraph Server URL"));
+		return nullptr;
+	}
+
+	TArray<nvaim::InferenceInstance*> ExpiredConnections;
+	ON_SCOPE_EXIT
+	{
+		for (nvaim::InferenceInstance* Expired : ExpiredConnections)
+		{
+			DestroyConnection(Expired);
+		}
+	};
+
+	int32 NumAttempts = FMath::Max(1, NumOfRetries);
+	{
+		FScopeLock Lock(&CS);
+		FURLEntry& Entry = Entries.FindOrAdd(URL);
+		Entry.Stats.URL = URL;
+
+		const double Now = FPlatformTime::Seconds();
+		if (Entry.Stats.CircuitState == EAnimgraphCircuitState::OPEN)
+		{
+			if (Now < Entry.CircuitOpenUntil)
+			{
+				++Entry.Stats.NumRejected;
+				UE_LOG(LogACEAnimStream, Warning, TEXT("Not connecting to animgraph service at %s, too many recent failures. Retrying in %.1f seconds"),
+					*URL, Entry.CircuitOpenUntil - Now);
+				return nullptr;
+			}
+			// cooldown is over, this caller gets to probe the service with a single new connection. Warm connections
+			// from before the outage can't be trusted anymore.
+			Entry.Stats.CircuitState = EAnimgraphCircuitState::HALF_OPEN;
+			NumAttempts = 1;
+			for (const FIdleConnection& Idle : Entry.IdleConnections)
+			{
+				ExpiredConnections.Add(Idle.Connection);
+			}
+			Entry.IdleConnections.Reset();
+		}
+		else if (Entry.Stats.CircuitState == EAnimgraphCircuitState::HALF_OPEN)
+		{
+			++Entry.Stats.NumRejected;
+			UE_LOG(LogACEAnimStream, Warning, TEXT("Not connecting to animgraph service at %s, waiting for another connection attempt to finish"), *URL);
+			return nullptr;
+		}
+
+		// reuse the most recently used warm connection, close any that have been idle too long
+		const double IdleTimeout = CVarAnimStreamIdleTimeout.GetValueOnAnyThread();
+		while (!Entry.IdleConnections.IsEmpty())
+		{
+			FIdleConnection Idle = Entry.IdleConnections.Pop();
+			if ((Now - Idle.IdleSince) > IdleTimeout)
+			{
+				ExpiredConnections.Add(Idle.Connection);
+				continue;
+			}
+			++Entry.Stats.NumReused;
+			++Entry.Stats.NumActive;
+			Entry.Stats.NumIdle = Entry.IdleConnections.Num();
+			return Idle.Connection;
+		}
+		Entry.Stats.NumIdle = 0;
+	}
+
+	for (int32 Attempt = 0; Attempt < NumAttempts; ++Attempt)
+	{
+		nvaim::InferenceInstance* Connection = CreateConnection(URL, RPCTimeout);
+
+		FScopeLock Lock(&CS);
+		FURLEntry& Entry = Entries.FindOrAdd(URL);
+		if (Attempt > 0)
+		{
+			++Entry.Stats.NumReconnects;
+		}
+		if (Connection != nullptr)
+		{
+			Entry.ConsecutiveFailures = 0;
+			Entry.Stats.CircuitState = EAnimgraphCircuitState::CLOSED;
+			++Entry.Stats.NumConnects;
+			++Entry.Stats.NumActive;
+			return Connection;
+		}
+
+		RecordFailure(Entry, URL);
+		if (Entry.Stats.CircuitState == EAnimgraphCircuitState::OPEN)
+		{
+			// no point hammering the service any further
+			return nullptr;
+		}
+
+		if (Attempt + 1 < NumAttempts)
+		{
+			const float Delay = GetRetryDelay(TimeBetweenRetries, Attempt);
+			UE_LOG(LogACEAnimStream, Warning, TEXT("Unable to create animgraph instance, try %d of %d. Retrying in %.2f seconds"), Attempt + 1, NumAttempts, Delay);
+			FScopeUnlock Unlock(&CS);
+			if (Delay > 0.0f)
+			{
+				FPlatformProcess::Sleep(Delay);
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void FAnimgraphConnectionCache::Release(const FString& URL, nvaim::InferenceInstance* Connection, bool bHealthy)
+{
+	if (Connection == nullptr)
+	{
+		return;
+	}
+
+	{
+		FScopeLock Lock(&CS);
+		FURLEntry& Entry = Entries.FindOrAdd(URL);
+		Entry.Stats.NumActive = FMath::Max(0, Entry.Stats.NumActive - 1);
+		if (bHealthy && (Entry.IdleConnections.Num() < CVarAnimStreamMaxIdleConnections.GetValueOnAnyThread()))
+		{
+			Entry.IdleConnections.Add({ Connection, FPlatformTime::Seconds() });
+			Entry.Stats.NumIdle = Entry.IdleConnections.Num();
+			return;
+		}
+	}
+
+	DestroyConnection(Connection);
+}
+
+TArray<FAnimgraphConnectionStats> FAnimgraphConnectionCache::GetStats() const
+{
+	FScopeLock Lock(&CS);
+	TArray<FAnimgraphConnectionStats> Stats;
+	for (const TPair<FString, FURLEntry>& Entry : Entries)
+	{
+		Stats.Add(Entry.Value.Stats);
+	}
+	return Stats;
+}
+
+void FAnimgraphConnectionCache::RecordFailure(FURLEntry& Entry, const FString& URL)
+{
+	// note: CS must be locked when calling this function
+	++Entry.Stats.NumFailures;
+	++Entry.ConsecutiveFailures;
+	const bool bProbeFailed = (Entry.Stats.CircuitState == EAnimgraphCircuitState::HALF_OPEN);
+	if (bProbeFailed || (Entry.ConsecutiveFailures >= FMath::Max(1, CVarAnimStreamBreakerThreshold.GetValueOnAnyThread())))
+	{
+		const float Cooldown = CVarAnimStreamBreakerCooldown.GetValueOnAnyThread();
+		Entry.Stats.CircuitState = EAnimgraphCircuitState::OPEN;
+		Entry.CircuitOpenUntil = FPlatformTime::Seconds() + Cooldown;
+		UE_LOG(LogACEAnimStream, Warning, TEXT("%d consecutive failures connecting to animgraph service at %s, not trying again for %.1f seconds"),
+			Entry.ConsecutiveFailures, *URL, Cooldown);
+	}
+}
+
+void FAnimgraphConnectionCache::LogStats() const
+{
+	for (const FAnimgraphConnectionStats& Stats : GetStats())
+	{
+		UE_LOG(LogACEAnimStream, Display, TEXT("%s: circuit %s, %d active, %d idle, %d connects, %d reused, %d reconnects, %d failures, %d rejected"),
+			*Stats.URL, GetCircuitStateString(Stats.CircuitState), Stats.NumActive, Stats.NumIdle, Stats.NumConnects, Stats.NumReused,
+			Stats.NumReconnects, Stats.NumFailures, Stats.NumRejected);
+	}
+}
+
+void FAnimgraphConnectionCache::DestroyConnection(nvaim::InferenceInstance* Connection)
+{
+	if ((Connection != nullptr) && ensure(Animgraph.IsValid()) && (Animgraph->Interface != nullptr))
+	{
+		Animgraph->Interface->destroyInstance(Connection);
+	}
+}
+
+nvaim::InferenceInstance* FAnimgraphConnectionCache::CreateConnection(const FString& DestURL, float RPCTimeout)
+{
+	nvaim::InferenceInterface* AnimgraphFeature = Animgraph.IsValid() ? Animgraph->Interface : nullptr;
+	if (!ensure(AnimgraphFeature != nullptr))
+	{
+		return nullptr;
+	}
+
+	nvaim::AnimgraphCreationParameters AnimgraphCreationParams;
+	nvaim::CommonCreationParameters CommonCreationParams;
+
+	auto ModelDirUTF8 = StringCast<UTF8CHAR>(*FAIMModule::Get().GetModelDirectory());
+	CommonCreationParams.utf8PathToModels = reinterpret_cast<const char*>(ModelDirUTF8.Get());
+	CommonCreationParams.numThreads = 4;	// just guessing, I don't know how to tell how many threads AIM needs
+	CommonCreationParams.vramBudgetMB = 0;	// If AIM uses any VRAM at all in its gRPC implementation, something has gone horribly awry
+	CommonCreationParams.modelGUID = MODEL_STRING;
+	AnimgraphCreationParams.common = &CommonCreationParams;
+
+	// connection timeout in ms
+	float RPCTimeoutMs = 1000.0f * RPCTimeout;
+	AnimgraphCreationParams.connection_timeout_in_ms = static_cast<uint32_t>(FMath::Clamp(static_cast<int32_t>(RPCTimeoutMs), 1, nvaim::ANIMGRAPH_MAX_CONNECTION_TIMEOUT_IN_MS));
+	UE_LOG(LogACEAnimStream, Verbose, TEXT("Animgraph gRPC timeout = %d ms"), AnimgraphCreationParams.connection_timeout_in_ms);
+
+	if (!DestURL.StartsWith("http"))
+	{
+		UE_LOG(LogACEAnimStream, Warning, TEXT("Server address does not start with http or https, defaulting to non secure connection"));
+	}
+
+	nvaim::RPCParameters GRPCParams{};
+	FString URLWithoutScheme = FGenericPlatformHttp::GetUrlDomainAndPort(DestURL);
+	auto URLWithoutSchemeUTF8 = StringCast<UTF8CHAR>(*URLWithoutScheme);
+	TOptional<bool> MaybeIsHttps = FGenericPlatformHttp::IsSecureProtocol(DestURL);
+
+	GRPCParams.url = reinterpret_cast<const char*>(URLWithoutSchemeUTF8.Get());
+	GRPCParams.useSSL = MaybeIsHttps.IsSet() ? *MaybeIsHttps : false;	// assume http scheme if not specified
+	GRPCParams.metaData = "";	// AIM will refuse to create a connection with null metaData, we have to provide empty string
+	AnimgraphCreationParams.chain(GRPCParams);
+
+	nvaim::InferenceInstance* Connection = nullptr;
+	nvaim::Result Result = AnimgraphFeature->createInstance(AnimgraphCreationParams, &Connection);
+	if (Result != nvaim::ResultOk)
+	{
+		UE_LOG(LogACEAnimStream, Warning,
+			TEXT("Unable to create animgraph instance (%s). nvaim::RPCParameters::url=\"%s\", nvaim::RPCParameters::useSSL=%s, nvaim::RPCParameters::metaData=\"%s\""),
+			*GetAIMStatusString(Result), UTF8_TO_TCHAR(GRPCParams.url), GRPCParams.useSSL ? TEXT("true") : TEXT("false"), UTF8_TO_TCHAR(GRPCParams.metaData));
+		return nullptr;
+	}
+
+	return Connection;
+}
+
+// FAnimgraphConnectionCache
+/////////////////////////////
@@ -0,0 +1,122 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+// engine includes
+#include "CoreMinimal.h"
+
+
+struct FAIMAnimgraphFeature;
+class IConsoleObject;
+
+namespace nvaim
+{
+	struct InferenceInstance;
+}
+
+
+enum class EAnimgraphCircuitState : uint8
+{
+	// connections are being attempted normally
+	CLOSED,
+	// too many consecutive connection failures, new connections fail fast until the cooldown expires
+	OPEN,
+	// cooldown expired, a single connection attempt is in flight to probe whether the service is back
+	HALF_OPEN,
+};
+
+// Snapshot of the connection state for one animgraph URL
+struct FAnimgraphConnectionStats
+{
+	FString URL;
+	EAnimgraphCircuitState CircuitState = EAnimgraphCircuitState::CLOSED;
+	// connections currently used by streams
+	int32 NumActive = 0;
+	// warm connections waiting to be reused
+	int32 NumIdle = 0;
+	// new connections created
+	int32 NumConnects = 0;
+	// streams that got a warm connection instead of creating one
+	int32 NumReused = 0;
+	// connection attempts after a failed first attempt
+	int32 NumReconnects = 0;
+	// failed connection attempts
+	int32 NumFailures = 0;
+	// connection requests rejected without trying because the circuit was open
+	int32 NumRejected = 0;
+};
+
+// Shared cache of animgraph service connections, keyed by URL.
+//
+// AIM's animgraph evaluate blocks for the whole streaming RPC, so a connection serves one stream at a time. Streams
+// return their connection when they're done, and the next stream for that URL reuses it instead of paying for a new
+// gRPC channel. Connections whose stream ended with an error are considered unhealthy and are closed instead.
+//
+// Connection attempts back off exponentially with jitter between retries. After enough consecutive failures the
+// circuit for that URL opens, and any further requests fail immediately until a cooldown passes, so a dead server
+// doesn't cause retry storms from every avatar trying to subscribe.
+class FAnimgraphConnectionCache : FNoncopyable
+{
+public:
+	explicit FAnimgraphConnectionCache(TSharedPtr<FAIMAnimgraphFeature> InAnimgraph);
+	~FAnimgraphConnectionCache();
+
+	// Get a connection to the animgraph service at URL, reusing a warm one if possible. May block while retrying.
+	// Returns nullptr on failure. Every connection returned must be handed back with Release.
+	nvaim::InferenceInstance* Acquire(const FString& URL, int32 NumOfRetries, float TimeBetweenRetries, float RPCTimeout);
+
+	// Hand back a connection from Acquire. Healthy connections are kept warm for reuse, others are closed.
+	void Release(const FString& URL, nvaim::InferenceInstance* Connection, bool bHealthy);
+
+	// Per URL connection state and counters
+	TArray<FAnimgraphConnectionStats> GetStats() const;
+
+	// Jittered exponential backoff delay before retry number Attempt (0 based)
+	static float GetRetryDelay(float BaseDelay, int32 Attempt);
+
+private:
+	struct FIdleConnection
+	{
+		nvaim::InferenceInstance* Connection = nullptr;
+		double IdleSince = 0.0;
+	};
+
+	struct FURLEntry
+	{
+		FAnimgraphConnectionStats Stats;
+		TArray<FIdleConnection> IdleConnections;
+		int32 ConsecutiveFailures = 0;
+		double CircuitOpenUntil = 0.0;
+	};
+
+	TSharedPtr<FAIMAnimgraphFeature> Animgraph;
+	mutable FCriticalSection CS;
+	TMap<FString, FURLEntry> Entries;
+	IConsoleObject* ReportCommand = nullptr;
+
+private:
+	nvaim::InferenceInstance* CreateConnection(const FString& URL, float RPCTimeout);
+	void DestroyConnection(nvaim::InferenceInstance* Connection);
+	void RecordFailure(FURLEntry& Entry, const FString& URL);
+	void LogStats() const;
+};
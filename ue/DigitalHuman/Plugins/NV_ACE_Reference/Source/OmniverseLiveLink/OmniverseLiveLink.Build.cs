@@ -77,6 +77,7 @@ public class OmniverseLiveLink : ModuleRules
 				"AudioPlatformConfiguration",
 				"AudioExtensions",
 				"OmniverseAudioMixer",
+				"SignalProcessing",
 			}
 			);
     }
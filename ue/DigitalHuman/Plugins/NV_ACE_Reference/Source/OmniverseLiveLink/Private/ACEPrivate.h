@@ -25,3 +25,4 @@
 
 #include "CoreMinimal.h"
 DECLARE_LOG_CATEGORY_EXTERN(LogACE, Log, All);
+DECLARE_STATS_GROUP(TEXT("ACE"), STATGROUP_ACE, STATCAT_Advanced);
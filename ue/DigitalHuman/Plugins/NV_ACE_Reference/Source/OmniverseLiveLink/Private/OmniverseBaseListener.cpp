@@ -29,18 +29,23 @@
 #include "HAL/RunnableThread.h"
 #include "ILiveLinkClient.h"
 
+#include "ACEPrivate.h"
+
 #define RECV_BUFFER_SIZE 1024 * 1024
 #define RECV_HEADER_SIZE 8
+// always leave at least this much room for a socket read
+#define RECV_MIN_FREE_SIZE (64 * 1024)
+// anything bigger than this is assumed to be a corrupt header rather than a real package
+#define MAX_PACKAGE_SIZE (256 * 1024 * 1024)
 
 
-static int32 BytesToInt(uint8* Bytes, int32 Length)
+// Package sizes are sent as a big-endian integer in the RECV_HEADER_SIZE bytes before the package
+static uint64 BytesToInt(const uint8* Bytes, int32 Length)
 {
-	int32 Return = 0;
-	int32 Flag = 0;
-	for (int32 Index = Length - 1; Index >= 0; --Index)
+	uint64 Return = 0;
+	for (int32 Index = 0; Index < Length; ++Index)
 	{
-		Return += (Bytes[Index] & 0xFF) << (8 * Flag);
-		++Flag;
+		Return = (Return << 8) | Bytes[Index];
 	}
 	return Return;
 }
@@ -121,8 +126,7 @@ uint32 FOmniverseBaseListener::Run()
 			// Already have a Connection? destroy previous
 			if (ConnectionSocket)
 			{
-				ConnectionSocket->Close();
-				SocketSubsystem->DestroySocket(ConnectionSocket);
+				CloseConnection();
 			}
 			// New Connection receive!
 			ConnectionSocket = ListenerSocket->Accept(*RemoteAddr, TEXT("OmniverseLiveLink Received Socket Connection"));
@@ -132,14 +136,20 @@ uint32 FOmniverseBaseListener::Run()
 		{
 			double CurrentRecvTime = FPlatformTime::Seconds();
 			uint32 PendingSize = 0;
-			while (ConnectionSocket->HasPendingData(PendingSize))
+			while (ConnectionSocket && ConnectionSocket->HasPendingData(PendingSize))
 			{
+				// receive straight into the unused end of the receive buffer
+				ReserveRecvSpace(RECV_MIN_FREE_SIZE);
 				int32 ReadSize = 0;
-				if (ConnectionSocket->Recv(RecvBuffer.GetData(), RecvBuffer.Num(), ReadSize))
+				if (ConnectionSocket->Recv(RecvBuffer.GetData() + RecvEnd, RecvBuffer.Num() - RecvEnd, ReadSize))
 				{
 					if (ReadSize > 0)
 					{
-						OnRawDataReceived(RecvBuffer.GetData(), ReadSize);
+						RecvEnd += ReadSize;
+						if (!ProcessReceivedData())
+						{
+							CloseConnection();
+						}
 					}
 				}
 			}
@@ -235,57 +245,88 @@ void FOmniverseBaseListener::PushPackageData(const uint8* InPackageData, int32 I
 
 void FOmniverseBaseListener::OnRawDataReceived(const uint8* InReceivedData, int32 InReceivedSize)
 {
-	TArray<uint8> ReceivedData;
-	ReceivedData.Append(IncompleteData);
-	ReceivedData.Append(InReceivedData, InReceivedSize);
-	int ReceivedSize = ReceivedData.Num();
+	ReserveRecvSpace(InReceivedSize);
+	FMemory::Memcpy(RecvBuffer.GetData() + RecvEnd, InReceivedData, InReceivedSize);
+	RecvEnd += InReceivedSize;
+	NumBytesCopied.fetch_add(InReceivedSize, std::memory_order_relaxed);
 
-	IncompleteData.Empty();
+	if (!ProcessReceivedData())
+	{
+		RecvStart = 0;
+		RecvEnd = 0;
+	}
+}
 
-	while (true)
+void FOmniverseBaseListener::ReserveRecvSpace(int32 MinFreeBytes)
+{
+	if (RecvBuffer.Num() - RecvEnd >= MinFreeBytes)
 	{
-		if (!DataSizeInHeader.IsSet())
-		{
-			if (ReceivedSize < RECV_HEADER_SIZE)
-			{
-				//UE_LOG(LogACE, Warning, TEXT("Incomplete Data: %d"), ReceivedSize);
-				IncompleteData = ReceivedData;
-				break;
-			}
+		return;
+	}
 
-			DataSizeInHeader = BytesToInt(ReceivedData.GetData(), RECV_HEADER_SIZE);
-			ReceivedData.RemoveAt(0, RECV_HEADER_SIZE);
-			ReceivedSize = ReceivedData.Num();
-		}
-		// This's the complete package, ready to parse 
-		else if (ReceivedSize == DataSizeInHeader.GetValue())
+	// move the unframed bytes, at most one incomplete package, back to the front
+	const int32 PendingSize = RecvEnd - RecvStart;
+	if (RecvStart > 0)
+	{
+		if (PendingSize > 0)
 		{
-			PushPackageData(ReceivedData.GetData(), ReceivedSize);
-			DataSizeInHeader.Reset();
-
-			//UE_LOG(LogACE, Warning, TEXT("Complete package, ready to parse: %d, %d"), ReceivedSize, ReceivedData.Num());
-			break;
+			FMemory::Memmove(RecvBuffer.GetData(), RecvBuffer.GetData() + RecvStart, PendingSize);
+			NumBytesCopied.fetch_add(PendingSize, std::memory_order_relaxed);
 		}
-		// This's the incomplete data, need to be completed next time
-		else if (ReceivedSize < DataSizeInHeader.GetValue())
+		RecvStart = 0;
+		RecvEnd = PendingSize;
+	}
+
+	// a package bigger than the buffer needs a bigger buffer
+	if (RecvBuffer.Num() - RecvEnd < MinFreeBytes)
+	{
+		RecvBuffer.SetNumUninitialized(FMath::Max(RecvBuffer.Num() * 2, RecvEnd + MinFreeBytes));
+		NumBytesCopied.fetch_add(PendingSize, std::memory_order_relaxed);
+	}
+}
+
+bool FOmniverseBaseListener::ProcessReceivedData()
+{
+	while (RecvEnd - RecvStart >= RECV_HEADER_SIZE)
+	{
+		const uint64 DataSizeInHeader = BytesToInt(RecvBuffer.GetData() + RecvStart, RECV_HEADER_SIZE);
+		if (DataSizeInHeader > MAX_PACKAGE_SIZE)
 		{
-			IncompleteData = ReceivedData;
+			UE_LOG(LogACE, Warning, TEXT("Received invalid package size %llu, dropping connection"), DataSizeInHeader);
+			return false;
+		}
 
-			//UE_LOG(LogACE, Warning, TEXT("Incomplete package, complete next time: %d, %d"), ReceivedSize, ReceivedData.Num());
+		const int32 PackageSize = static_cast<int32>(DataSizeInHeader);
+		const int32 AvailableSize = RecvEnd - RecvStart;
+		if (AvailableSize < RECV_HEADER_SIZE + PackageSize)
+		{
+			// This's the incomplete data, make sure the rest of it fits so the package stays in one piece
+			ReserveRecvSpace(RECV_HEADER_SIZE + PackageSize - AvailableSize);
 			break;
 		}
-		// This's mixing data, need to be separated
-		else if (ReceivedSize > DataSizeInHeader.GetValue())
-		{
-			int32 DataSize = DataSizeInHeader.GetValue();
-			PushPackageData(ReceivedData.GetData(), DataSize);
-			ReceivedData.RemoveAt(0, DataSize);
-			ReceivedSize = ReceivedData.Num();
-			DataSizeInHeader.Reset();
 
-			//UE_LOG(LogACE, Warning, TEXT("Mixing data, need to be separated: %d, %d"), ReceivedSize, ReceivedData.Num());
-		}
+		// This's the complete package, ready to parse in place
+		PushPackageData(RecvBuffer.GetData() + RecvStart + RECV_HEADER_SIZE, PackageSize);
+		NumPackagesReceived.fetch_add(1, std::memory_order_relaxed);
+		RecvStart += RECV_HEADER_SIZE + PackageSize;
 	}
+
+	// everything was framed, so start over at the front without moving anything
+	if (RecvStart == RecvEnd)
+	{
+		RecvStart = 0;
+		RecvEnd = 0;
+	}
+	return true;
+}
+
+void FOmniverseBaseListener::CloseConnection()
+{
+	ConnectionSocket->Close();
+	SocketSubsystem->DestroySocket(ConnectionSocket);
+	ConnectionSocket = nullptr;
+	RecvStart = 0;
+	RecvEnd = 0;
 }
 
 bool FOmniverseBaseListener::IsSocketReady() const
@@ -304,3 +345,8 @@ void FOmniverseBaseListener::SetClient(ILiveLinkClient* InClient, FGuid InSource
 	LiveLinkClient = InClient;
 	SourceGuid = InSourceGuid;
 }
+
+int32 FOmniverseBaseListener::GetListenPort() const
+{
+	return (ListenerSocket != nullptr) ? ListenerSocket->GetPortNo() : 0;
+}
@@ -27,6 +27,7 @@
 #include "HAL/ThreadSafeBool.h"
 #include "ILiveLinkClient.h"
 #include "OmniverseLiveLinkFramePlayer.h"
+#include <atomic>
 
 
 class FOmniverseBaseListener : public FRunnable
@@ -43,7 +44,7 @@ public:
 	virtual void Start();
 	virtual bool IsValid() const;
 	virtual bool IsSocketReady() const;
-	// Get the raw data from network
+	// Get the raw data from network. The socket thread receives straight into the receive buffer instead of calling this
 	virtual void OnRawDataReceived(const uint8* InReceivedData, int32 InReceivedSize);
 	// Get the size-checked package
 	virtual void OnPackageDataReceived(const uint8* InPackageData, int32 InPackageSize) {};
@@ -57,6 +58,13 @@ public:
 	// End FOmniverseBaseListener Interface
 
 	void SetClient(class ILiveLinkClient* InClient, FGuid InSourceGuid);
+
+	// Port the listener socket is bound to, useful when it was created with port 0
+	int32 GetListenPort() const;
+
+	// Number of packages framed so far, and how many bytes had to be moved within the receive buffer to frame them
+	uint64 GetNumPackagesReceived() const { return NumPackagesReceived.load(std::memory_order_relaxed); }
+	uint64 GetNumBytesCopied() const { return NumBytesCopied.load(std::memory_order_relaxed); }
 protected:
 	// Begin FRunnable Interface
 	virtual bool Init() override { return true; }
@@ -76,6 +84,13 @@ protected:
 private:
 	void PushPackageData(const uint8* InPackageData, int32 InPackageSize);
 
+	// Make room for at least MinFreeBytes after RecvEnd, compacting or growing the receive buffer
+	void ReserveRecvSpace(int32 MinFreeBytes);
+	// Pass every complete package in the receive buffer to PushPackageData as a view into the buffer.
+	// Returns false if the stream is corrupt and the connection should be dropped
+	bool ProcessReceivedData();
+	void CloseConnection();
+
 	// Tcp Server
 	class FSocket* ListenerSocket;
 	class FSocket* ConnectionSocket;
@@ -86,11 +101,15 @@ private:
 	// Threadsafe Bool for terminating the main thread loop
 	FThreadSafeBool ThreadStopping;
 
-	// Buffer to receive socket data into
+	// Buffer to receive socket data into. Bytes in [RecvStart, RecvEnd) have been received but not framed yet.
+	// Packages are handed out in place, and only an incomplete trailing package is ever moved back to the front.
 	// Only in socket thread
 	TArray<uint8> RecvBuffer;
-	TArray<uint8> IncompleteData;
-	TOptional<int32> DataSizeInHeader;
+	int32 RecvStart = 0;
+	int32 RecvEnd = 0;
+
+	std::atomic<uint64> NumPackagesReceived = 0;
+	std::atomic<uint64> NumBytesCopied = 0;
 
 	TOptional<double> CustomDeltaTime;
 	TOptional<double> LastPushTime;
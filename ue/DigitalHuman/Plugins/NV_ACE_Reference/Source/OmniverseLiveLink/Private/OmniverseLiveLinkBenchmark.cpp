@@ -0,0 +1,284 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+// Benchmarks for the Omniverse LiveLink receive path.
+// Usage: omni.LiveLinkBenchmark [NumBones=1000] [NumCurves=55] [NumFrames=500]
+//   Decode time of JSON vs binary animation packages. The defaults approximate a MetaHuman body + face skeleton with
+//   the ARKit-style curves ACE produces.
+// Usage: omni.LiveLinkLoopbackBenchmark [Seconds=10] [FrameBytes=131072]
+//   Sends 60 fps animation packages of FrameBytes plus the matching 16 kHz int16 audio packages over a loopback
+//   connection to an FOmniverseBaseListener, as fast as the socket allows, and reports framing cost per package.
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "IPAddress.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "Roles/LiveLinkAnimationTypes.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#include "ACEPrivate.h"
+#include "OmniverseBaseListener.h"
+#include "OmniverseLiveLinkBinaryProtocol.h"
+#include "OmniverseLiveLinkListener.h"
+
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+	FString MakeJSONPackage(int32 NumBones, int32 NumCurves)
+	{
+		FString Builder;
+		Builder.Reserve(NumBones * 128 + NumCurves * 32);
+		Builder += TEXT("{\"Benchmark\":{\"Body\":[");
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			Builder += FString::Printf(TEXT("%s{\"Name\":\"bone_%d\",\"ParentName\":\"bone_%d\",\"Location\":[%f,%f,%f],\"Rotation\":[%f,%f,%f,%f]}"),
+				(BoneIndex > 0) ? TEXT(",") : TEXT(""), BoneIndex, FMath::Max(BoneIndex - 1, 0),
+				FMath::FRand(), FMath::FRand(), FMath::FRand(), 0.0f, 0.0f, 0.0f, 1.0f);
+		}
+		Builder += TEXT("],\"Facial\":{\"Names\":[");
+		for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+		{
+			Builder += FString::Printf(TEXT("%s\"curve_%d\""), (CurveIndex > 0) ? TEXT(",") : TEXT(""), CurveIndex);
+		}
+		Builder += TEXT("],\"Weights\":[");
+		for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+		{
+			Builder += FString::Printf(TEXT("%s%f"), (CurveIndex > 0) ? TEXT(",") : TEXT(""), FMath::FRand());
+		}
+		Builder += TEXT("]}}}");
+		return Builder;
+	}
+
+	template<typename T>
+	void Write(TArray<uint8>& Out, T Value)
+	{
+		Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+
+	void WriteString(TArray<uint8>& Out, const FString& String)
+	{
+		FTCHARToUTF8 Converted(*String);
+		Write<uint16>(Out, static_cast<uint16>(Converted.Length()));
+		Out.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+	}
+
+	TArray<uint8> MakeBinaryPackage(int32 NumBones, int32 NumCurves)
+	{
+		TArray<uint8> Layout;
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			WriteString(Layout, FString::Printf(TEXT("bone_%d"), BoneIndex));
+			Write<int16>(Layout, static_cast<int16>(BoneIndex - 1));
+		}
+		for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+		{
+			WriteString(Layout, FString::Printf(TEXT("curve_%d"), CurveIndex));
+		}
+
+		TArray<uint8> Package;
+		Package.Append(reinterpret_cast<const uint8*>(OmniverseLiveLinkBinary::ProtocolToken), UE_ARRAY_COUNT(OmniverseLiveLinkBinary::ProtocolToken) - 1);
+		Write<uint32>(Package, 0);
+		Write<uint16>(Package, 1);
+		WriteString(Package, TEXT("Benchmark"));
+		// layout included, as on a subject's first frame, so the benchmark also covers skipping over it
+		Write<uint8>(Package, OmniverseLiveLinkBinary::OLB_FLAG_LAYOUT);
+		Write<uint16>(Package, static_cast<uint16>(NumBones));
+		Write<uint16>(Package, static_cast<uint16>(NumCurves));
+		Write<uint32>(Package, static_cast<uint32>(Layout.Num()));
+		Package.Append(Layout);
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			const float Bone[OmniverseLiveLinkBinary::FloatsPerBone] = { FMath::FRand(), FMath::FRand(), FMath::FRand(), 0.0f, 0.0f, 0.0f, 1.0f };
+			Package.Append(reinterpret_cast<const uint8*>(Bone), sizeof(Bone));
+		}
+		for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+		{
+			Write<float>(Package, FMath::FRand());
+		}
+		return Package;
+	}
+
+	void RunLiveLinkBenchmark(const TArray<FString>& Args)
+	{
+		const int32 NumBones = FMath::Clamp((Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 1000, 1, MAX_int16);
+		const int32 NumCurves = FMath::Clamp((Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 55, 0, MAX_uint16);
+		const int32 NumFrames = FMath::Max((Args.Num() > 2) ? FCString::Atoi(*Args[2]) : 500, 1);
+
+		// JSON packages arrive as UTF-8 bytes, same as from the socket
+		const FString JSONString = MakeJSONPackage(NumBones, NumCurves);
+		const FTCHARToUTF8 JSONConverted(*JSONString);
+		const TArray<uint8> JSONPackage(reinterpret_cast<const uint8*>(JSONConverted.Get()), JSONConverted.Length());
+		const TArray<uint8> BinaryPackage = MakeBinaryPackage(NumBones, NumCurves);
+
+		// JSON: the same work FOmniverseLiveLinkListener::ParseJSON and ProcessAnimationData do per frame, minus LiveLink
+		double JSONSeconds = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			FString PackageString = FString(JSONPackage.Num(), (ANSICHAR*)JSONPackage.GetData());
+			TSharedPtr<FJsonObject> JsonObject;
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(PackageString);
+			if (!FJsonSerializer::Deserialize(Reader, JsonObject))
+			{
+				UE_LOG(LogACE, Warning, TEXT("omni.LiveLinkBenchmark: failed to parse generated JSON"));
+				return;
+			}
+			const TSharedPtr<FJsonObject> DataObject = JsonObject->Values.CreateConstIterator().Value()->AsObject();
+			const TArray<TSharedPtr<FJsonValue>>* BoneArray = nullptr;
+			DataObject->TryGetArrayField(TEXT("Body"), BoneArray);
+			FLiveLinkAnimationFrameData FrameData;
+			FOmniverseLiveLinkListener::ReadJSONFrameData(BoneArray, DataObject->TryGetField(TEXT("Facial")), NumCurves, FrameData);
+			JSONSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+
+		double BinarySeconds = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			uint32 FrameIndex = 0;
+			FLiveLinkAnimationFrameData FrameData;
+			OmniverseLiveLinkBinary::ParsePackage(BinaryPackage.GetData(), BinaryPackage.Num(), FrameIndex,
+				[&FrameData](const OmniverseLiveLinkBinary::FSubject& Subject)
+				{
+					OmniverseLiveLinkBinary::ReadFrame(Subject, FrameData);
+					return true;
+				});
+			BinarySeconds += FPlatformTime::Seconds() - StartTime;
+		}
+
+		UE_LOG(LogACE, Display, TEXT("omni.LiveLinkBenchmark: %d bones, %d curves, %d frames: JSON %d bytes %.1f us/frame, binary %d bytes %.1f us/frame"),
+			NumBones, NumCurves, NumFrames,
+			JSONPackage.Num(), 1e6 * JSONSeconds / NumFrames,
+			BinaryPackage.Num(), 1e6 * BinarySeconds / NumFrames);
+	}
+
+	class FLoopbackBenchmarkListener : public FOmniverseBaseListener
+	{
+	public:
+		FLoopbackBenchmarkListener() : FOmniverseBaseListener(nullptr, 0) {}
+
+		virtual void OnPackageDataReceived(const uint8* InPackageData, int32 InPackageSize) override
+		{
+			NumBytes.fetch_add(InPackageSize, std::memory_order_relaxed);
+		}
+
+		std::atomic<uint64> NumBytes = 0;
+	};
+
+	void AppendPackage(TArray<uint8>& Out, int32 PackageSize, uint8 Fill)
+	{
+		// 8 byte big-endian size header, then the package
+		for (int32 Shift = 56; Shift >= 0; Shift -= 8)
+		{
+			Out.Add(static_cast<uint8>((static_cast<uint64>(PackageSize) >> Shift) & 0xFF));
+		}
+		Out.AddUninitialized(PackageSize);
+		FMemory::Memset(Out.GetData() + Out.Num() - PackageSize, Fill, PackageSize);
+	}
+
+	void RunLoopbackBenchmark(const TArray<FString>& Args)
+	{
+		const int32 Seconds = FMath::Max((Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 10, 1);
+		const int32 FrameBytes = FMath::Max((Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 128 * 1024, 1);
+		const int32 NumFrames = Seconds * 60;
+		const int32 AudioBytes = (16'000 / 60) * static_cast<int32>(sizeof(int16));
+
+		FLoopbackBenchmarkListener Listener;
+		ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+		if (!Listener.IsSocketReady() || (SocketSubsystem == nullptr))
+		{
+			UE_LOG(LogACE, Warning, TEXT("omni.LiveLinkLoopbackBenchmark: unable to create listener socket"));
+			return;
+		}
+		Listener.Start();
+
+		FSocket* Sender = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("OmniverseLiveLink loopback benchmark"), false);
+		TSharedRef<FInternetAddr> Addr = SocketSubsystem->CreateInternetAddr();
+		Addr->SetLoopbackAddress();
+		Addr->SetPort(Listener.GetListenPort());
+		if ((Sender == nullptr) || !Sender->Connect(*Addr))
+		{
+			UE_LOG(LogACE, Warning, TEXT("omni.LiveLinkLoopbackBenchmark: unable to connect to port %d"), Listener.GetListenPort());
+			if (Sender != nullptr)
+			{
+				SocketSubsystem->DestroySocket(Sender);
+			}
+			return;
+		}
+
+		// one animation package and the audio that goes with it per frame
+		TArray<uint8> FrameData;
+		AppendPackage(FrameData, FrameBytes, 'a');
+		AppendPackage(FrameData, AudioBytes, 0);
+
+		const double StartTime = FPlatformTime::Seconds();
+		bool bSendFailed = false;
+		for (int32 Frame = 0; (Frame < NumFrames) && !bSendFailed; ++Frame)
+		{
+			int32 Offset = 0;
+			while (Offset < FrameData.Num())
+			{
+				int32 BytesSent = 0;
+				if (!Sender->Send(FrameData.GetData() + Offset, FrameData.Num() - Offset, BytesSent))
+				{
+					bSendFailed = true;
+					break;
+				}
+				Offset += BytesSent;
+			}
+		}
+
+		const uint64 ExpectedPackages = 2 * static_cast<uint64>(NumFrames);
+		while (!bSendFailed && (Listener.GetNumPackagesReceived() < ExpectedPackages) && (FPlatformTime::Seconds() - StartTime < 60.0))
+		{
+			FPlatformProcess::Sleep(0.001f);
+		}
+		const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		Sender->Close();
+		SocketSubsystem->DestroySocket(Sender);
+		Listener.Stop();
+
+		const uint64 NumPackages = Listener.GetNumPackagesReceived();
+		UE_LOG(LogACE, Display, TEXT("omni.LiveLinkLoopbackBenchmark: %llu/%llu packages (%.1f MB) in %.1f ms, %.1f MB/s, %.1f bytes copied per package"),
+			NumPackages, ExpectedPackages, Listener.NumBytes.load() / (1024.0 * 1024.0), ElapsedSeconds * 1000.0,
+			Listener.NumBytes.load() / (1024.0 * 1024.0) / ElapsedSeconds,
+			(NumPackages > 0) ? static_cast<double>(Listener.GetNumBytesCopied()) / NumPackages : 0.0);
+	}
+
+	FAutoConsoleCommand CmdOmniverseLiveLinkLoopbackBenchmark(
+		TEXT("omni.LiveLinkLoopbackBenchmark"),
+		TEXT("Measure Omniverse LiveLink socket framing cost with 60 fps animation and 16 kHz audio packages over loopback. Args: [Seconds] [FrameBytes]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunLoopbackBenchmark));
+
+	FAutoConsoleCommand CmdOmniverseLiveLinkBenchmark(
+		TEXT("omni.LiveLinkBenchmark"),
+		TEXT("Measure per-frame decode time of JSON vs binary Omniverse LiveLink animation packages. Args: [NumBones] [NumCurves] [NumFrames]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunLiveLinkBenchmark));
+}
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "OmniverseLiveLinkBinaryProtocol.h"
+#include "Containers/StringConv.h"
+#include "Roles/LiveLinkAnimationTypes.h"
+
+
+namespace OmniverseLiveLinkBinary
+{
+	// Bounds-checked cursor over a package. Once a read fails every following read fails too
+	class FReader
+	{
+	public:
+		FReader(const uint8* InData, int32 InSize) : Data(InData), Size(InSize) {}
+
+		template<typename T>
+		bool Read(T& OutValue)
+		{
+			const uint8* Src = Take(static_cast<int32>(sizeof(T)));
+			if (Src == nullptr)
+			{
+				return false;
+			}
+			FMemory::Memcpy(&OutValue, Src, sizeof(T));
+			return true;
+		}
+
+		bool ReadView(int32 NumBytes, TArrayView<const uint8>& OutView)
+		{
+			const uint8* Src = Take(NumBytes);
+			if (Src == nullptr)
+			{
+				return false;
+			}
+			OutView = MakeArrayView(Src, NumBytes);
+			return true;
+		}
+
+		bool ReadString(TArrayView<const uint8>& OutString)
+		{
+			uint16 Length = 0;
+			return Read(Length) && ReadView(Length, OutString);
+		}
+
+		bool IsAtEnd() const { return Offset == Size; }
+
+	private:
+		const uint8* Take(int32 NumBytes)
+		{
+			if (bFailed || (NumBytes < 0) || (NumBytes > Size - Offset))
+			{
+				bFailed = true;
+				return nullptr;
+			}
+			const uint8* Result = Data + Offset;
+			Offset += NumBytes;
+			return Result;
+		}
+
+		const uint8* Data;
+		int32 Size;
+		int32 Offset = 0;
+		bool bFailed = false;
+	};
+
+	static FName MakeName(TArrayView<const uint8> String, bool bLowerCase)
+	{
+		FUTF8ToTCHAR Converted(reinterpret_cast<const UTF8CHAR*>(String.GetData()), String.Num());
+		if (bLowerCase)
+		{
+			return FName(*FString(Converted.Length(), Converted.Get()).ToLower());
+		}
+		return FName(Converted.Length(), Converted.Get());
+	}
+
+	static constexpr int32 MagicSize = UE_ARRAY_COUNT(ProtocolToken) - 1;
+
+	bool IsBinaryPackage(const uint8* InPackageData, int32 InPackageSize)
+	{
+		return (InPackageSize >= MagicSize) && (FMemory::Memcmp(InPackageData, ProtocolToken, MagicSize) == 0);
+	}
+
+	bool ParsePackage(const uint8* InPackageData, int32 InPackageSize, uint32& OutFrameIndex, TFunctionRef<bool(const FSubject&)> Visitor)
+	{
+		if (!IsBinaryPackage(InPackageData, InPackageSize))
+		{
+			return false;
+		}
+
+		FReader Reader(InPackageData, InPackageSize);
+		TArrayView<const uint8> Magic;
+		uint16 NumSubjects = 0;
+		if (!Reader.ReadView(MagicSize, Magic) || !Reader.Read(OutFrameIndex) || !Reader.Read(NumSubjects))
+		{
+			return false;
+		}
+
+		for (int32 SubjectIndex = 0; SubjectIndex < NumSubjects; ++SubjectIndex)
+		{
+			FSubject Subject;
+			TArrayView<const uint8> SubjectName;
+			uint8 Flags = 0;
+			uint16 NumBones = 0;
+			uint16 NumCurves = 0;
+			if (!Reader.ReadString(SubjectName) || !Reader.Read(Flags) || !Reader.Read(NumBones) || !Reader.Read(NumCurves))
+			{
+				return false;
+			}
+			Subject.SubjectName = MakeName(SubjectName, false);
+			Subject.NumBones = NumBones;
+			Subject.NumCurves = NumCurves;
+
+			if (Flags & OLB_FLAG_LAYOUT)
+			{
+				uint32 LayoutSize = 0;
+				if (!Reader.Read(LayoutSize) || !Reader.ReadView(static_cast<int32>(LayoutSize), Subject.Layout))
+				{
+					return false;
+				}
+			}
+
+			if (!Reader.ReadView(NumBones * FloatsPerBone * static_cast<int32>(sizeof(float)), Subject.Transforms)
+				|| !Reader.ReadView(NumCurves * static_cast<int32>(sizeof(float)), Subject.Curves))
+			{
+				return false;
+			}
+
+			if (!Visitor(Subject))
+			{
+				return true;
+			}
+		}
+
+		return Reader.IsAtEnd();
+	}
+
+	bool ReadLayout(const FSubject& Subject, TArray<FName>& OutBoneNames, TArray<int32>& OutBoneParents, TArray<FName>& OutCurveNames)
+	{
+		OutBoneNames.SetNum(Subject.NumBones);
+		OutBoneParents.SetNum(Subject.NumBones);
+		OutCurveNames.SetNum(Subject.NumCurves);
+
+		FReader Reader(Subject.Layout.GetData(), Subject.Layout.Num());
+		for (int32 BoneIndex = 0; BoneIndex < Subject.NumBones; ++BoneIndex)
+		{
+			TArrayView<const uint8> BoneName;
+			int16 ParentIndex = INDEX_NONE;
+			if (!Reader.ReadString(BoneName) || !Reader.Read(ParentIndex) || (ParentIndex < INDEX_NONE) || (ParentIndex >= Subject.NumBones))
+			{
+				return false;
+			}
+			OutBoneNames[BoneIndex] = MakeName(BoneName, true);
+			OutBoneParents[BoneIndex] = ParentIndex;
+		}
+
+		for (int32 CurveIndex = 0; CurveIndex < Subject.NumCurves; ++CurveIndex)
+		{
+			TArrayView<const uint8> CurveName;
+			if (!Reader.ReadString(CurveName))
+			{
+				return false;
+			}
+			OutCurveNames[CurveIndex] = MakeName(CurveName, false);
+		}
+
+		return Reader.IsAtEnd();
+	}
+
+	void ReadFrame(const FSubject& Subject, FLiveLinkAnimationFrameData& OutFrame)
+	{
+		check(Subject.Transforms.Num() == Subject.NumBones * FloatsPerBone * static_cast<int32>(sizeof(float)));
+		check(Subject.Curves.Num() == Subject.NumCurves * static_cast<int32>(sizeof(float)));
+
+		OutFrame.Transforms.SetNumUninitialized(Subject.NumBones);
+		const uint8* BoneData = Subject.Transforms.GetData();
+		for (int32 BoneIndex = 0; BoneIndex < Subject.NumBones; ++BoneIndex)
+		{
+			float Bone[FloatsPerBone];
+			FMemory::Memcpy(Bone, BoneData, sizeof(Bone));
+			BoneData += sizeof(Bone);
+
+			// Same handedness conversion as the JSON path: flip Y on the location, and mirror the rotation across the
+			// XZ plane. Negating the quaternion's X and Z is equivalent to the JSON path's negated Euler roll and yaw
+			const FVector BoneLocation(Bone[0], -Bone[1], Bone[2]);
+			const FQuat BoneQuat(-Bone[3], Bone[4], -Bone[5], Bone[6]);
+			OutFrame.Transforms[BoneIndex] = FTransform(BoneQuat, BoneLocation);
+		}
+
+		// curve weights are already in the format LiveLink wants, so copy them in one go
+		OutFrame.PropertyValues.SetNumUninitialized(Subject.NumCurves);
+		FMemory::Memcpy(OutFrame.PropertyValues.GetData(), Subject.Curves.GetData(), Subject.Curves.Num());
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+struct FLiveLinkAnimationFrameData;
+
+// Binary animation package, an alternative to the JSON package that avoids string conversion and JSON parsing.
+// A sender announces it by appending a protocol token to the header package, e.g. "A2F:30:OLB1". Packages are
+// recognized by their magic word, so JSON packages keep working as a fallback on the same connection.
+//
+// All values are little-endian, names are UTF-8 without a terminator:
+//
+//   char[4]  Magic "OLB1"
+//   uint32   FrameIndex
+//   uint16   NumSubjects
+//   per subject:
+//     uint16   SubjectNameLength, char[SubjectNameLength] SubjectName
+//     uint8    Flags (OLB_FLAG_LAYOUT: a layout block follows the counts)
+//     uint16   NumBones
+//     uint16   NumCurves
+//     [uint32  LayoutSize, followed by LayoutSize bytes:
+//        per bone:  uint16 NameLength, char[NameLength] Name, int16 ParentIndex
+//        per curve: uint16 NameLength, char[NameLength] Name]
+//     float32[NumBones * 7]  bone location XYZ then rotation XYZW, in the same space as the JSON "Location" and "Rotation"
+//     float32[NumCurves]     curve weights
+//
+// The layout block only needs to be sent with the first frame of a subject and whenever its bones or curves change.
+// A subject named "Disconnect" ends the package, same as with JSON.
+namespace OmniverseLiveLinkBinary
+{
+	static constexpr ANSICHAR ProtocolToken[] = "OLB1";
+	static constexpr uint8 OLB_FLAG_LAYOUT = 0x1;
+	static constexpr int32 FloatsPerBone = 7;
+
+	// One subject inside a binary package. Views point into the package data, nothing is copied
+	struct FSubject
+	{
+		FName SubjectName;
+		int32 NumBones = 0;
+		int32 NumCurves = 0;
+		TArrayView<const uint8> Layout;
+		TArrayView<const uint8> Transforms;
+		TArrayView<const uint8> Curves;
+	};
+
+	bool IsBinaryPackage(const uint8* InPackageData, int32 InPackageSize);
+
+	// Calls Visitor for each subject in the package until it returns false. Returns false if the package is malformed
+	bool ParsePackage(const uint8* InPackageData, int32 InPackageSize, uint32& OutFrameIndex, TFunctionRef<bool(const FSubject&)> Visitor);
+
+	// Decodes a subject's layout block into names and parents. Bone names are lower-cased to match the JSON path
+	bool ReadLayout(const FSubject& Subject, TArray<FName>& OutBoneNames, TArray<int32>& OutBoneParents, TArray<FName>& OutCurveNames);
+
+	// Decodes a subject's transforms and curve weights straight from the package into OutFrame
+	void ReadFrame(const FSubject& Subject, FLiveLinkAnimationFrameData& OutFrame);
+}
@@ -24,11 +24,23 @@
 #include "OmniverseLiveLinkFramePlayer.h"
 #include "Async/Async.h"
 #include "HAL/Event.h"
+#include "HAL/IConsoleManager.h"
 #include "HAL/RunnableThread.h"
 #include "GenericPlatform/GenericPlatformProcess.h"
 #include "GenericPlatform/GenericPlatformTime.h"
 #include "OmniverseBaseListener.h"
 
+#include "ACEPrivate.h"
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("LiveLink Frame Release Jitter Avg (ms)"), STAT_OmniverseLiveLinkJitterAvg, STATGROUP_ACE);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("LiveLink Frame Release Jitter Max (ms)"), STAT_OmniverseLiveLinkJitterMax, STATGROUP_ACE);
+
+static TAutoConsoleVariable<int32> CVarOmniverseLiveLinkBufferPoolSize(
+	TEXT("omni.LiveLinkBufferPoolSize"),
+	64,
+	TEXT("Maximum number of package buffers the Omniverse LiveLink frame player keeps for reuse (default is 64).\n"),
+	ECVF_Default);
+
 std::unordered_map<const ILiveLinkSource*, TUniquePtr<FOmniverseLiveLinkFramePlayer>> FOmniverseLiveLinkFramePlayer::Instances;
 
 FOmniverseLiveLinkFramePlayer::FOmniverseLiveLinkFramePlayer()
@@ -38,7 +50,7 @@ FOmniverseLiveLinkFramePlayer::FOmniverseLiveLinkFramePlayer()
 	, AnimeListener(nullptr)
 	, AudioListener(nullptr)
 {
-	
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
 }
 
 FOmniverseLiveLinkFramePlayer::~FOmniverseLiveLinkFramePlayer()
@@ -50,6 +62,9 @@ FOmniverseLiveLinkFramePlayer::~FOmniverseLiveLinkFramePlayer()
 		Thread->WaitForCompletion();
 		delete Thread;
 	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
 }
 
 void FOmniverseLiveLinkFramePlayer::Start()
@@ -68,6 +83,7 @@ void FOmniverseLiveLinkFramePlayer::Reset()
 	AudioPendBuffer.Empty();
 	AnimePendBuffer.Empty();
 	ThreadReset = true;
+	WakeEvent->Trigger();
 	// Make sure the instance is properly destroyed
 	auto Source = std::find_if(std::begin(Instances), std::end(Instances),
 		[this](auto&& p)
@@ -82,6 +98,7 @@ void FOmniverseLiveLinkFramePlayer::Reset()
 void FOmniverseLiveLinkFramePlayer::Stop()
 {
 	ThreadStopping = true;
+	WakeEvent->Trigger();
 }
 
 void FOmniverseLiveLinkFramePlayer::RegisterAnime(TSharedPtr<class FOmniverseBaseListener, ESPMode::ThreadSafe> Listener)
@@ -94,45 +111,126 @@ void FOmniverseLiveLinkFramePlayer::RegisterAudio(TSharedPtr<class FOmniverseBas
 	AudioListener = Listener;
 }
 
+FPendBuffer FOmniverseLiveLinkFramePlayer::MakePendBuffer(const uint8* InData, int32 InSize, double DeltaTime, bool bBegin, bool bEnd)
+{
+	FPendBuffer PendBuffer{ {}, DeltaTime, bBegin, bEnd, FPlatformTime::Seconds() };
+	{
+		FScopeLock Lock(&BufferPoolCS);
+		if (!BufferPool.IsEmpty())
+		{
+			PendBuffer.Buffer = BufferPool.Pop();
+		}
+	}
+	PendBuffer.Buffer.Reset();
+	PendBuffer.Buffer.Append(InData, InSize);
+	return PendBuffer;
+}
+
+void FOmniverseLiveLinkFramePlayer::ReleaseBuffer(TArray<uint8>&& Buffer)
+{
+	FScopeLock Lock(&BufferPoolCS);
+	if (BufferPool.Num() < CVarOmniverseLiveLinkBufferPoolSize.GetValueOnAnyThread())
+	{
+		BufferPool.Add(MoveTemp(Buffer));
+	}
+}
+
 void FOmniverseLiveLinkFramePlayer::PushAudioData_AnyThread(const uint8* InData, int32 InSize, double DeltaTime, bool bBegin, bool bEnd)
 {
-	AudioPendBuffer.Enqueue({ std::string((char*)InData, InSize), DeltaTime, bBegin, bEnd });
+	AudioPendBuffer.Enqueue(MakePendBuffer(InData, InSize, DeltaTime, bBegin, bEnd));
+	WakeEvent->Trigger();
 }
 
 void FOmniverseLiveLinkFramePlayer::PushAnimeData_AnyThread(const uint8* InData, int32 InSize, double DeltaTime, bool bBegin, bool bEnd)
 {
-	AnimePendBuffer.Enqueue({ std::string((char*)InData, InSize), DeltaTime, bBegin, bEnd });
+	AnimePendBuffer.Enqueue(MakePendBuffer(InData, InSize, DeltaTime, bBegin, bEnd));
+	WakeEvent->Trigger();
 }
 
 void FOmniverseLiveLinkFramePlayer::PlayAudio(double CurrentTime)
 {
+	RecordReleaseJitter(CurrentAudio.GetValue(), LastAudioPlayTime, CurrentTime);
 	if (AudioListener)
 	{
-		AudioListener->OnPackageDataReceived((uint8*)CurrentAudio.GetValue().Buffer.data(), CurrentAudio.GetValue().Buffer.size());
+		AudioListener->OnPackageDataReceived(CurrentAudio.GetValue().Buffer.GetData(), CurrentAudio.GetValue().Buffer.Num());
 	}
+	ReleaseBuffer(MoveTemp(CurrentAudio.GetValue().Buffer));
 	CurrentAudio.Reset();
 	LastAudioPlayTime = CurrentTime;
 }
 
 void FOmniverseLiveLinkFramePlayer::PlayAnime(double CurrentTime)
 {
+	RecordReleaseJitter(CurrentAnime.GetValue(), LastAnimePlayTime, CurrentTime);
 	if (AnimeListener)
 	{
-		AnimeListener->OnPackageDataReceived((uint8*)CurrentAnime.GetValue().Buffer.data(), CurrentAnime.GetValue().Buffer.size());
+		AnimeListener->OnPackageDataReceived(CurrentAnime.GetValue().Buffer.GetData(), CurrentAnime.GetValue().Buffer.Num());
 	}
+	ReleaseBuffer(MoveTemp(CurrentAnime.GetValue().Buffer));
 	CurrentAnime.Reset();
 	LastAnimePlayTime = CurrentTime;
 }
 
-uint32 FOmniverseLiveLinkFramePlayer::Run()
+bool FOmniverseLiveLinkFramePlayer::IsReadyToPlay(const TOptional<FPendBuffer>& Current, double LastPlayTime, uint8 FenceBit, double CurrentTime, double& InOutNextDeadline)
 {
-	while (!ThreadStopping)
+	if (!Current.IsSet())
+	{
+		return false;
+	}
+
+	const double DueTime = LastPlayTime + Current.GetValue().DeltaPendingTime;
+	if (CurrentTime < DueTime)
+	{
+		InOutNextDeadline = FMath::Min(InOutNextDeadline, DueTime);
+		return false;
+	}
+
+	if (Current.GetValue().BeginFence)
+	{
+		Fence &= static_cast<uint8>(~FenceBit);
+	}
+
+	if (Current.GetValue().EndFence)
+	{
+		// the end of a burst waits for the other stream to reach its end too. That only changes when the other stream
+		// plays something, which happens on this thread, so there's no deadline to wait for here
+		Fence |= FenceBit;
+		return Fence == UINT8_MAX;
+	}
+
+	return true;
+}
+
+void FOmniverseLiveLinkFramePlayer::RecordReleaseJitter(const FPendBuffer& Played, double LastPlayTime, double CurrentTime)
+{
+	// a package can't be released before it arrives, so lateness is measured from whichever came last
+	const double DueTime = FMath::Max(LastPlayTime + Played.DeltaPendingTime, Played.PushTime);
+	const double Lateness = FMath::Max(CurrentTime - DueTime, 0.0);
+	JitterSumSeconds += Lateness;
+	JitterMaxSeconds = FMath::Max(JitterMaxSeconds, Lateness);
+	++JitterSamples;
+
+	if (CurrentTime - JitterWindowStart >= 1.0)
 	{
-		if (ThreadStopping)
+		if (JitterSamples > 0)
 		{
-			break;
+			const float AvgMs = static_cast<float>(1000.0 * JitterSumSeconds / JitterSamples);
+			const float MaxMs = static_cast<float>(1000.0 * JitterMaxSeconds);
+			SET_FLOAT_STAT(STAT_OmniverseLiveLinkJitterAvg, AvgMs);
+			SET_FLOAT_STAT(STAT_OmniverseLiveLinkJitterMax, MaxMs);
+			UE_LOG(LogACE, Verbose, TEXT("Frame release jitter over %d packages: avg %.2f ms, max %.2f ms"), JitterSamples, AvgMs, MaxMs);
 		}
+		JitterWindowStart = CurrentTime;
+		JitterSumSeconds = 0.0;
+		JitterMaxSeconds = 0.0;
+		JitterSamples = 0;
+	}
+}
 
+uint32 FOmniverseLiveLinkFramePlayer::Run()
+{
+	while (!ThreadStopping)
+	{
 		if (ThreadReset)
 		{
 			CurrentAudio.Reset();
@@ -145,7 +243,7 @@ uint32 FOmniverseLiveLinkFramePlayer::Run()
 			FPendBuffer DequeueData;
 			if (AudioPendBuffer.Dequeue(DequeueData))
 			{
-				CurrentAudio = DequeueData;
+				CurrentAudio = MoveTemp(DequeueData);
 			}
 		}
 
@@ -154,63 +252,41 @@ uint32 FOmniverseLiveLinkFramePlayer::Run()
 			FPendBuffer DequeueData;
 			if (AnimePendBuffer.Dequeue(DequeueData))
 			{
-				CurrentAnime = DequeueData;
+				CurrentAnime = MoveTemp(DequeueData);
 			}
 		}
 
 		double CurrentTime = FPlatformTime::Seconds();
-		if (CurrentAudio.IsSet() && CurrentTime - LastAudioPlayTime >= CurrentAudio.GetValue().DeltaPendingTime)
+		double NextDeadline = TNumericLimits<double>::Max();
+		bool bPlayed = false;
+		if (IsReadyToPlay(CurrentAudio, LastAudioPlayTime, 0x1, CurrentTime, NextDeadline))
 		{
-			if (CurrentAudio.GetValue().BeginFence)
-			{
-				Fence &= 0xFE;
-			}
-
-			bool IsAvailable = false;
-			if (CurrentAudio.GetValue().EndFence)
-			{
-				Fence |= 0x1;
-				if (Fence == UINT8_MAX)
-				{
-					IsAvailable = true;
-				}
-			}
-			else
-			{
-				IsAvailable = true;
-			}
+			PlayAudio(CurrentTime);
+			bPlayed = true;
+		}
 
-			if (IsAvailable)
-			{
-				PlayAudio(CurrentTime);
-			}
+		if (IsReadyToPlay(CurrentAnime, LastAnimePlayTime, 0x2, CurrentTime, NextDeadline))
+		{
+			PlayAnime(CurrentTime);
+			bPlayed = true;
 		}
 
-		if (CurrentAnime.IsSet() && CurrentTime - LastAnimePlayTime >= CurrentAnime.GetValue().DeltaPendingTime)
+		// after playing something, go around again right away: the next package may already be due, or a held fence
+		// may have been released. Otherwise sleep until the next package is due or something new is pushed
+		if (!bPlayed && !ThreadStopping)
 		{
-			if (CurrentAnime.GetValue().BeginFence)
+			if (NextDeadline == TNumericLimits<double>::Max())
 			{
-				Fence &= 0xFD;
+				WakeEvent->Wait();
 			}
-
-			bool IsAvailable = false;
-			if (CurrentAnime.GetValue().EndFence)
+			else
 			{
-				Fence |= 0x2;
-				if (Fence == UINT8_MAX)
+				const double WaitMs = (NextDeadline - FPlatformTime::Seconds()) * 1000.0;
+				if (WaitMs > 0.0)
 				{
-					IsAvailable = true;
+					WakeEvent->Wait(FTimespan::FromMilliseconds(WaitMs));
 				}
 			}
-			else
-			{
-				IsAvailable = true;
-			}
-
-			if (IsAvailable)
-			{
-				PlayAnime(CurrentTime);
-			}
 		}
 	}
 	return 0;
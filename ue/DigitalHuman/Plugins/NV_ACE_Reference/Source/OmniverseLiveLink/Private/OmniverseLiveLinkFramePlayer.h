@@ -24,20 +24,23 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "Containers/Queue.h"
+#include "HAL/CriticalSection.h"
 #include "HAL/Runnable.h"
 #include "HAL/ThreadSafeBool.h"
-#include <string>
 #include <unordered_map>
 
+class FEvent;
 class ILiveLinkSource;
 
 struct FPendBuffer
 {
-	// use std::string to avoid TChar to uint8 conversion
-	std::string Buffer;
+	// taken from FOmniverseLiveLinkFramePlayer's buffer pool, and returned to it once played
+	TArray<uint8> Buffer;
 	double DeltaPendingTime = 0.0;
 	bool BeginFence = false;
 	bool EndFence = false;
+	// when the package was pushed, for measuring release jitter
+	double PushTime = 0.0;
 };
 
 class FOmniverseLiveLinkFramePlayer : public FRunnable
@@ -75,12 +78,35 @@ private:
 	void PlayAudio(double CurrentTime);
 	void PlayAnime(double CurrentTime);
 
+	// Returns true if Current is due and not held back by the fence. Otherwise lowers InOutNextDeadline to the time
+	// it will be due, if that's known
+	bool IsReadyToPlay(const TOptional<FPendBuffer>& Current, double LastPlayTime, uint8 FenceBit, double CurrentTime, double& InOutNextDeadline);
+	void RecordReleaseJitter(const FPendBuffer& Played, double LastPlayTime, double CurrentTime);
+
+	FPendBuffer MakePendBuffer(const uint8* InData, int32 InSize, double DeltaTime, bool bBegin, bool bEnd);
+	void ReleaseBuffer(TArray<uint8>&& Buffer);
+
 	// Thread to run work operations on
 	class FRunnableThread* Thread;
 
 	// Threadsafe Bool for terminating the main thread loop
 	FThreadSafeBool ThreadStopping;
 
+	// Wakes the thread when a package is pushed or the thread is stopped. Between those the thread sleeps until the next
+	// pending package is due
+	FEvent* WakeEvent = nullptr;
+
+	// Recycled package buffers, so pushing a package doesn't allocate once the pool is warm
+	FCriticalSection BufferPoolCS;
+	TArray<TArray<uint8>> BufferPool;
+
+	// How late played packages were released relative to their due time, accumulated over one reporting window.
+	// Published as STAT_OmniverseLiveLinkJitterAvg/Max once per second
+	double JitterWindowStart = 0.0;
+	double JitterSumSeconds = 0.0;
+	double JitterMaxSeconds = 0.0;
+	int32 JitterSamples = 0;
+
 	TQueue<FPendBuffer> AudioPendBuffer;
 	TQueue<FPendBuffer> AnimePendBuffer;
 
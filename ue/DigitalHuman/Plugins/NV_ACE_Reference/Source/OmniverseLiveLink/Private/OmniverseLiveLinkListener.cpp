@@ -30,6 +30,7 @@
 #include "Serialization/JsonSerializer.h"
 
 #include "ACEPrivate.h"
+#include "OmniverseLiveLinkBinaryProtocol.h"
 #include "OmniverseLiveLinkSourceSettings.h"
 
 #define LOCTEXT_NAMESPACE "OmniverseLiveLinkListener"
@@ -46,7 +47,14 @@ FOmniverseLiveLinkListener::~FOmniverseLiveLinkListener()
 
 void FOmniverseLiveLinkListener::OnPackageDataReceived(const uint8* InPackageData, int32 InPackageSize)
 {
-	ParseJSON(InPackageData, InPackageSize);
+	if (OmniverseLiveLinkBinary::IsBinaryPackage(InPackageData, InPackageSize))
+	{
+		ParseBinary(InPackageData, InPackageSize);
+	}
+	else
+	{
+		ParseJSON(InPackageData, InPackageSize);
+	}
 }
 
 void FOmniverseLiveLinkListener::OnPackageDataPushed(const uint8* InPackageData, int32 InPackageSize, double DeltaTime, bool bBegin, bool bEnd)
@@ -96,7 +104,8 @@ bool FOmniverseLiveLinkListener::GetFPSInHeader(const uint8* InPackageData, int3
 	TArray<FString> A2FInfoStrings;
 	HeaderString.ParseIntoArray(A2FInfoStrings, *HeaderSeparator);
 
-	if (A2FInfoStrings.Num() == 2)
+	// an optional third field announces the binary protocol
+	if (A2FInfoStrings.Num() >= 2)
 	{
 		OutFPS = FCString::Atoi(*A2FInfoStrings[1]);
 		return OutFPS > 0;
@@ -125,6 +134,7 @@ void FOmniverseLiveLinkListener::RemoveUnusedSubjects()
 				LiveLinkClient->RemoveSubject_AnyThread(FLiveLinkSubjectKey(SourceGuid, Subject.Key));
 			}
 			UnusedSubjects.Add(Subject.Key);
+			SubjectLayouts.Remove(Subject.Key);
 		}
 	}
 
@@ -153,7 +163,8 @@ bool FOmniverseLiveLinkListener::ParseJSON(const uint8* InPackageData, int32 InP
 	if (IsHeaderPackage(InPackageData, InPackageSize))
 	{
 		//
-		// Nothing to do for blendshape header right now
+		// Nothing to do for blendshape header right now; binary packages are recognized by their magic
+		// in OnPackageDataReceived, so a header announcing them (e.g. "A2F:30:OLB1") needs no state either
 		// 
 		return true;
 	}
@@ -185,142 +196,166 @@ bool FOmniverseLiveLinkListener::ParseJSON(const uint8* InPackageData, int32 InP
 	return false;
 }
 
-void FOmniverseLiveLinkListener::ProcessAnimationData(const TSharedPtr<FJsonObject>& DataObject, const FName& InSubjectName)
+bool FOmniverseLiveLinkListener::ParseBinary(const uint8* InPackageData, int32 InPackageSize)
 {
-	if (LiveLinkClient == nullptr)
+	ResetUsingSubjects();
+	uint32 FrameIndex = 0;
+	const bool bValid = OmniverseLiveLinkBinary::ParsePackage(InPackageData, InPackageSize, FrameIndex,
+		[this](const OmniverseLiveLinkBinary::FSubject& Subject)
+		{
+			if (Subject.SubjectName == TEXT("Disconnect"))
+			{
+				return false;
+			}
+			ProcessBinaryAnimationData(Subject);
+			return true;
+		});
+
+	if (!bValid)
 	{
-		return;
+		UE_LOG(LogACE, Warning, TEXT("Malformed binary animation package %u (%d bytes), ignoring"), FrameIndex, InPackageSize);
+		return false;
 	}
 
-	const TArray<TSharedPtr<FJsonValue>>* BoneArray = nullptr;
-	DataObject->TryGetArrayField(TEXT("Body"), BoneArray);
+	RemoveUnusedSubjects();
+	return true;
+}
 
-	const TSharedPtr<FJsonValue> Facial = DataObject->TryGetField(TEXT("Facial"));
+// Hash of a JSON string value by reference. FJsonValue::AsString returns a copy, which would allocate for every name on
+// every frame. Non-string values hash as an empty name, same as AsString would have returned.
+static uint32 HashJSONString(const FJsonValue& JsonValue)
+{
+	struct FJsonStringAccess : public FJsonValueString
+	{
+		static const FString& Get(const FJsonValueString& StringValue)
+		{
+			return StringValue.*(&FJsonStringAccess::Value);
+		}
+	};
+	return (JsonValue.Type == EJson::String) ? GetTypeHash(FJsonStringAccess::Get(static_cast<const FJsonValueString&>(JsonValue))) : 0;
+}
 
-	bool bCreateSubject = !UsingSubjects.Contains(InSubjectName);
+// Hash of a JSON subject's bone and curve names, so an unchanged layout can be recognized without building FNames.
+// Returns false if a bone is missing its name or parent, same as an invalid JSON format
+static bool HashJSONLayout(const TArray<TSharedPtr<FJsonValue>>* BoneArray, const TArray<TSharedPtr<FJsonValue>>* CurveArray, uint32& OutHash)
+{
+	// keys as FStrings up front, so the per-frame lookups don't build temporaries
+	static const FString NameField(TEXT("Name"));
+	static const FString ParentNameField(TEXT("ParentName"));
 
-	// NOTE: SkeletonData pointer to FrameData, so they must have the same scope
-	FLiveLinkSkeletonStaticData* SkeletonData = nullptr;
-	FLiveLinkSubjectFrameData FrameData;
-	if (!bCreateSubject)
+	OutHash = 0;
+	if (BoneArray)
 	{
-		// check if static data (bones and curve names) is changed, if it was changed, recreate the subject
-		auto AllSubjects = LiveLinkClient->GetSubjects(true, false);
-		for (auto Subject : AllSubjects)
+		for (const TSharedPtr<FJsonValue>& BoneValue : *BoneArray)
 		{
-			if (Subject.SubjectName == InSubjectName)
+			const TSharedPtr<FJsonObject>* BoneObject = nullptr;
+			if (!BoneValue.IsValid() || !BoneValue->TryGetObject(BoneObject) || !BoneObject->IsValid())
 			{
-				auto SubjectRole = LiveLinkClient->GetSubjectRole_AnyThread(Subject);				
-				if (LiveLinkClient->EvaluateFrame_AnyThread(InSubjectName, SubjectRole, FrameData))
-				{
-					SkeletonData = FrameData.StaticData.Cast<FLiveLinkSkeletonStaticData>();
-				}
-				break;
+				return false;
+			}
+			const TSharedPtr<FJsonValue>* BoneName = (*BoneObject)->Values.Find(NameField);
+			const TSharedPtr<FJsonValue>* BoneParent = (*BoneObject)->Values.Find(ParentNameField);
+			if ((BoneName == nullptr) || !BoneName->IsValid() || (BoneParent == nullptr) || !BoneParent->IsValid())
+			{
+				return false;
 			}
+			OutHash = HashCombineFast(OutHash, HashJSONString(**BoneName));
 		}
 	}
 
-	// valid skeleton
-	if (SkeletonData && BoneArray)
+	// separate bones from curves, so moving a name from one list to the other changes the hash
+	OutHash = HashCombineFast(OutHash, BoneArray ? BoneArray->Num() : 0);
+
+	if (CurveArray)
 	{
-		// bone is changed, need to be recreated
-		if (SkeletonData->BoneNames.Num() != BoneArray->Num())
+		for (const TSharedPtr<FJsonValue>& CurveValue : *CurveArray)
 		{
-			bCreateSubject = true;
+			OutHash = HashCombineFast(OutHash, CurveValue.IsValid() ? HashJSONString(*CurveValue) : 0);
 		}
 	}
+	return true;
+}
 
-	TArray< FName > ExpNames;
-	if (Facial) // only facial need to check curve for now
+void FOmniverseLiveLinkListener::ProcessAnimationData(const TSharedPtr<FJsonObject>& DataObject, const FName& InSubjectName)
+{
+	if (LiveLinkClient == nullptr)
 	{
-		auto ExpWeightObject = Facial->AsObject();
-		if (ExpWeightObject.Get())
-		{
-			const TArray<TSharedPtr<FJsonValue>>* ExpData = nullptr;
-			if (ExpWeightObject->TryGetArrayField(TEXT("Names"), ExpData))
-			{
-				for (int32 Index = 0; Index < ExpData->Num(); ++Index)
-				{
-					FString Name = (*ExpData)[Index]->AsString();
-					ExpNames.Add(FName(*Name));
-				}
-			}
-		}
+		return;
+	}
 
-		if (SkeletonData)
+	const TArray<TSharedPtr<FJsonValue>>* BoneArray = nullptr;
+	DataObject->TryGetArrayField(TEXT("Body"), BoneArray);
+
+	const TSharedPtr<FJsonValue> Facial = DataObject->TryGetField(TEXT("Facial"));
+
+	// only facial need to check curve for now
+	const TArray<TSharedPtr<FJsonValue>>* ExpData = nullptr;
+	if (Facial)
+	{
+		const TSharedPtr<FJsonObject>* ExpWeightObject = nullptr;
+		if (Facial->TryGetObject(ExpWeightObject) && ExpWeightObject->IsValid())
 		{
-			// different number of curves
-			if (SkeletonData->PropertyNames.Num() != ExpNames.Num())
-			{
-				bCreateSubject = true;
-			}
+			(*ExpWeightObject)->TryGetArrayField(TEXT("Names"), ExpData);
 		}
 	}
+	const int32 NumBones = BoneArray ? BoneArray->Num() : 0;
+	const int32 NumCurves = ExpData ? ExpData->Num() : 0;
 
-	// Create static data : skeleton and curves
-	if (bCreateSubject)
+	uint32 LayoutHash = 0;
+	if (!HashJSONLayout(BoneArray, ExpData, LayoutHash))
 	{
-		UE_LOG(LogACE, Log, TEXT("Creating subject '%s'"), *InSubjectName.ToString());
+		return; // Invalid Json Format
+	}
 
-		FLiveLinkStaticDataStruct StaticData(FLiveLinkSkeletonStaticData::StaticStruct());
-		FLiveLinkSkeletonStaticData* NewSkeletonData = StaticData.Cast<FLiveLinkSkeletonStaticData>();
+	// static data (bones and curve names) is only pushed again if it really changed
+	const FSubjectLayout* Layout = UsingSubjects.Contains(InSubjectName) ? SubjectLayouts.Find(InSubjectName) : nullptr;
+	if ((Layout == nullptr) || (Layout->LayoutHash != LayoutHash) || (Layout->NumBones != NumBones) || (Layout->NumCurves != NumCurves))
+	{
 		TArray<FName> BoneNames;
-		if (BoneArray)
+		TArray<int32> BoneParents;
+		BoneNames.SetNumUninitialized(NumBones);
+		BoneParents.SetNumUninitialized(NumBones);
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
 		{
-			BoneNames.SetNumUninitialized(BoneArray->Num());
-			TArray<int32> BoneParents;
-			BoneParents.SetNumUninitialized(BoneArray->Num());
-
-			for (int32 BoneIndex = 0; BoneIndex < BoneArray->Num(); ++BoneIndex)
-			{
-				const TSharedPtr<FJsonValue>& BoneValue = (*BoneArray)[BoneIndex];
-				const TSharedPtr<FJsonObject> BoneObject = BoneValue->AsObject();
-
-				FString BoneName;
-				if (BoneObject->TryGetStringField(TEXT("Name"), BoneName))
-				{
-					BoneNames[BoneIndex] = FName(*(BoneName.ToLower()));
-
-					// Get bone index if getting parent
-					FString BoneParentName;
-					if (BoneObject->TryGetStringField(TEXT("ParentName"), BoneParentName))
-					{
-						BoneParents[BoneIndex] = BoneIndex;
-					}
-					else
-					{
-						return; // Invalid Json Format
-					}
-				}
-				else
-				{
-					return; // Invalid Json Format
-				}
-			}
-
-			NewSkeletonData->SetBoneNames(BoneNames);
-			NewSkeletonData->SetBoneParents(BoneParents);
+			// names and parents were validated by HashJSONLayout
+			const TSharedPtr<FJsonObject> BoneObject = (*BoneArray)[BoneIndex]->AsObject();
+			BoneNames[BoneIndex] = FName(*(BoneObject->GetStringField(TEXT("Name")).ToLower()));
+			BoneParents[BoneIndex] = BoneIndex;
 		}
 
-		if (Facial) // Facial need the static curve name
+		TArray<FName> ExpNames;
+		ExpNames.Reserve(NumCurves);
+		for (int32 Index = 0; Index < NumCurves; ++Index)
 		{
-			NewSkeletonData->PropertyNames = ExpNames;
+			FString Name = (*ExpData)[Index]->AsString();
+			ExpNames.Add(FName(*Name));
 		}
-		FLiveLinkSubjectKey Key = FLiveLinkSubjectKey(SourceGuid, InSubjectName);
-		LiveLinkClient->RemoveSubject_AnyThread(Key);
-		LiveLinkClient->PushSubjectStaticData_AnyThread(Key, ULiveLinkAnimationRole::StaticClass(), MoveTemp(StaticData));
+
+		PushStaticData(InSubjectName, LayoutHash, MoveTemp(BoneNames), MoveTemp(BoneParents), MoveTemp(ExpNames));
 	}
 	UsingSubjects.Add(InSubjectName, true);
 
 	FLiveLinkFrameDataStruct AnimationStruct(FLiveLinkAnimationFrameData::StaticStruct());
 	FLiveLinkAnimationFrameData& NewData = *AnimationStruct.Cast<FLiveLinkAnimationFrameData>();
-	TArray<FTransform>& DataTransforms = NewData.Transforms;
+	if (!ReadJSONFrameData(BoneArray, Facial, NumCurves, NewData))
+	{
+		// Invalid Json Format
+		return;
+	}
+
+	FLiveLinkSubjectKey SubjectKey(SourceGuid, InSubjectName);
+	LiveLinkClient->PushSubjectFrameData_AnyThread(SubjectKey, MoveTemp(AnimationStruct));
+}
+
+bool FOmniverseLiveLinkListener::ReadJSONFrameData(const TArray<TSharedPtr<FJsonValue>>* BoneArray, const TSharedPtr<FJsonValue>& Facial, int32 NumCurves, FLiveLinkAnimationFrameData& OutFrame)
+{
+	TArray<FTransform>& DataTransforms = OutFrame.Transforms;
 
 	if (BoneArray) // valid bone need transforms
 	{
 		DataTransforms.SetNumZeroed(BoneArray->Num());
 
-		UE_LOG(LogACE, Log, TEXT("Bone Array '%d'"), BoneArray->Num());
+		UE_LOG(LogACE, VeryVerbose, TEXT("Bone Array '%d'"), BoneArray->Num());
 
 		for (int32 BoneIndex = 0; BoneIndex < BoneArray->Num(); ++BoneIndex)
 		{
@@ -341,7 +376,7 @@ void FOmniverseLiveLinkListener::ProcessAnimationData(const TSharedPtr<FJsonObje
 			else
 			{
 				// Invalid Json Format
-				return;
+				return false;
 			}
 
 			const TArray<TSharedPtr<FJsonValue>>* RotationArray = nullptr;
@@ -360,23 +395,23 @@ void FOmniverseLiveLinkListener::ProcessAnimationData(const TSharedPtr<FJsonObje
 			else
 			{
 				// Invalid Json Format
-				return;
+				return false;
 			}
 			DataTransforms[BoneIndex] = FTransform(BoneQuat, BoneLocation);
 		}
 	}
 
-	if (Facial && ExpNames.Num() > 0)
+	if (Facial && NumCurves > 0)
 	{
-		TArray<float>& PropertyValues = NewData.PropertyValues;
-		PropertyValues.SetNumZeroed(ExpNames.Num());
+		TArray<float>& PropertyValues = OutFrame.PropertyValues;
+		PropertyValues.SetNumZeroed(NumCurves);
 		auto ExpWeightObject = Facial->AsObject();
 		if (ExpWeightObject.Get())
 		{
 			const TArray<TSharedPtr<FJsonValue>>* ExpWeight = nullptr;
 			if (ExpWeightObject->TryGetArrayField(TEXT("Weights"), ExpWeight))
 			{
-				for (int32 Index = 0; Index < ExpWeight->Num(); ++Index)
+				for (int32 Index = 0; Index < FMath::Min(ExpWeight->Num(), NumCurves); ++Index)
 				{
 					double fWeight = (*ExpWeight)[Index]->AsNumber();
 					PropertyValues[Index] = fWeight;
@@ -385,7 +420,67 @@ void FOmniverseLiveLinkListener::ProcessAnimationData(const TSharedPtr<FJsonObje
 		}
 	}
 
-	FLiveLinkSubjectKey SubjectKey(SourceGuid, InSubjectName);
+	return true;
+}
+
+void FOmniverseLiveLinkListener::PushStaticData(const FName& InSubjectName, uint32 LayoutHash, TArray<FName>&& BoneNames, TArray<int32>&& BoneParents, TArray<FName>&& CurveNames)
+{
+	// a subject we already own keeps its LiveLink entry and just gets new static data, anything else starts fresh
+	const bool bKnownSubject = UsingSubjects.Contains(InSubjectName) && SubjectLayouts.Contains(InSubjectName);
+	UE_LOG(LogACE, Log, TEXT("%s subject '%s'"), bKnownSubject ? TEXT("Updating") : TEXT("Creating"), *InSubjectName.ToString());
+
+	SubjectLayouts.Add(InSubjectName, { LayoutHash, BoneNames.Num(), CurveNames.Num() });
+
+	FLiveLinkStaticDataStruct StaticData(FLiveLinkSkeletonStaticData::StaticStruct());
+	FLiveLinkSkeletonStaticData* NewSkeletonData = StaticData.Cast<FLiveLinkSkeletonStaticData>();
+	NewSkeletonData->SetBoneNames(MoveTemp(BoneNames));
+	NewSkeletonData->SetBoneParents(MoveTemp(BoneParents));
+	NewSkeletonData->PropertyNames = MoveTemp(CurveNames);
+
+	FLiveLinkSubjectKey Key = FLiveLinkSubjectKey(SourceGuid, InSubjectName);
+	if (!bKnownSubject)
+	{
+		LiveLinkClient->RemoveSubject_AnyThread(Key);
+	}
+	LiveLinkClient->PushSubjectStaticData_AnyThread(Key, ULiveLinkAnimationRole::StaticClass(), MoveTemp(StaticData));
+}
+
+void FOmniverseLiveLinkListener::ProcessBinaryAnimationData(const OmniverseLiveLinkBinary::FSubject& Subject)
+{
+	if (LiveLinkClient == nullptr)
+	{
+		return;
+	}
+
+	// the layout block is hashed as raw bytes, so a resent but unchanged layout doesn't push static data again
+	const FSubjectLayout* Layout = UsingSubjects.Contains(Subject.SubjectName) ? SubjectLayouts.Find(Subject.SubjectName) : nullptr;
+	const uint32 LayoutHash = Subject.Layout.IsEmpty() ? 0 : FCrc::MemCrc32(Subject.Layout.GetData(), Subject.Layout.Num());
+	const bool bLayoutChanged = (Layout == nullptr) || (Layout->NumBones != Subject.NumBones) || (Layout->NumCurves != Subject.NumCurves)
+		|| (!Subject.Layout.IsEmpty() && (Layout->LayoutHash != LayoutHash));
+	if (bLayoutChanged)
+	{
+		// we can only create the subject if the sender included the names
+		TArray<FName> BoneNames;
+		TArray<int32> BoneParents;
+		TArray<FName> CurveNames;
+		if (Subject.Layout.IsEmpty())
+		{
+			UE_LOG(LogACE, Verbose, TEXT("No layout received yet for subject '%s', skipping frame"), *Subject.SubjectName.ToString());
+			return;
+		}
+		if (!OmniverseLiveLinkBinary::ReadLayout(Subject, BoneNames, BoneParents, CurveNames))
+		{
+			UE_LOG(LogACE, Warning, TEXT("Malformed layout for subject '%s', skipping frame"), *Subject.SubjectName.ToString());
+			return;
+		}
+		PushStaticData(Subject.SubjectName, LayoutHash, MoveTemp(BoneNames), MoveTemp(BoneParents), MoveTemp(CurveNames));
+	}
+	UsingSubjects.Add(Subject.SubjectName, true);
+
+	FLiveLinkFrameDataStruct AnimationStruct(FLiveLinkAnimationFrameData::StaticStruct());
+	OmniverseLiveLinkBinary::ReadFrame(Subject, *AnimationStruct.Cast<FLiveLinkAnimationFrameData>());
+
+	FLiveLinkSubjectKey SubjectKey(SourceGuid, Subject.SubjectName);
 	LiveLinkClient->PushSubjectFrameData_AnyThread(SubjectKey, MoveTemp(AnimationStruct));
 }
 
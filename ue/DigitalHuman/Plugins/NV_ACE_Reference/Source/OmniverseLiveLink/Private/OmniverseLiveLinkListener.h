@@ -25,6 +25,9 @@
 #include "CoreMinimal.h"
 #include "OmniverseBaseListener.h"
 
+struct FLiveLinkAnimationFrameData;
+namespace OmniverseLiveLinkBinary { struct FSubject; }
+
 
 class FOmniverseLiveLinkListener : public FOmniverseBaseListener
 {
@@ -40,14 +43,30 @@ public:
 
 	void ClearAllSubjects();
 
+	// Fill OutFrame with the bone transforms and NumCurves curve weights from a JSON subject. Returns false on invalid JSON
+	static bool ReadJSONFrameData(const TArray<TSharedPtr<class FJsonValue>>* BoneArray, const TSharedPtr<class FJsonValue>& Facial, int32 NumCurves, FLiveLinkAnimationFrameData& OutFrame);
+
 private:
 	void ResetUsingSubjects();
 	void RemoveUnusedSubjects();
 	void ProcessAnimationData(const TSharedPtr<class FJsonObject>& DataObject, const FName& InSubjectName);
+	void ProcessBinaryAnimationData(const OmniverseLiveLinkBinary::FSubject& Subject);
+	void PushStaticData(const FName& InSubjectName, uint32 LayoutHash, TArray<FName>&& BoneNames, TArray<int32>&& BoneParents, TArray<FName>&& CurveNames);
 	bool ParseJSON(const uint8* InPackageData, int32 InPackageSize);
+	bool ParseBinary(const uint8* InPackageData, int32 InPackageSize);
 
 private:
 
 	// List of subjects in using
 	TMap<FName, bool> UsingSubjects;
+
+	// Static data last pushed for each subject. Incoming layouts are compared by hash and counts, so LiveLink static
+	// data is only pushed again when the skeleton or curves really change, and binary frames that omit the layout can be checked
+	struct FSubjectLayout
+	{
+		uint32 LayoutHash = 0;
+		int32 NumBones = 0;
+		int32 NumCurves = 0;
+	};
+	TMap<FName, FSubjectLayout> SubjectLayouts;
 };
@@ -0,0 +1,313 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "OmniverseStreamResampler.h"
+#include "HAL/IConsoleManager.h"
+
+#include "ACEPrivate.h"
+
+
+// Zeroth order modified Bessel function of the first kind, for the Kaiser window
+static double BesselI0(double X)
+{
+	double Sum = 1.0;
+	double Term = 1.0;
+	for (int32 K = 1; K < 32; ++K)
+	{
+		const double Half = X / (2.0 * K);
+		Term *= Half * Half;
+		Sum += Term;
+		if (Term < Sum * 1e-12)
+		{
+			break;
+		}
+	}
+	return Sum;
+}
+
+void FOmniverseStreamResampler::Init(int32 InNumChannels, int32 InSourceRate, int32 InTargetRate, int32 InMaxInputFrames)
+{
+	NumChannels = FMath::Max(InNumChannels, 1);
+	SourceRate = FMath::Max(InSourceRate, 1);
+	TargetRate = FMath::Max(InTargetRate, 1);
+	MaxInputFrames = FMath::Max(InMaxInputFrames, 1);
+
+	if (IsPassthrough())
+	{
+		NumTaps = 0;
+		FilterTable.Empty();
+		Coefficients.Empty();
+		InputBuffer.Empty();
+		NumBufferedFrames = 0;
+		Position = 0;
+		Step = 0;
+		return;
+	}
+
+	// Cut off a little below the lower Nyquist frequency. Downsampling lowers the cutoff, which needs more taps for
+	// the same transition band, up to MaxTaps
+	const double Cutoff = FMath::Min(1.0, static_cast<double>(TargetRate) / SourceRate) * 0.9;
+	NumTaps = FMath::Clamp(FMath::CeilToInt(8.0 / Cutoff) * 2, 16, MaxTaps);
+	const int32 HalfTaps = NumTaps / 2;
+
+	constexpr double KaiserBeta = 8.0;
+	const double WindowScale = 1.0 / BesselI0(KaiserBeta);
+	FilterTable.SetNumUninitialized((NumPhases + 1) * NumTaps);
+	for (int32 Phase = 0; Phase <= NumPhases; ++Phase)
+	{
+		float* Row = &FilterTable[Phase * NumTaps];
+		double RowSum = 0.0;
+		for (int32 Tap = 0; Tap < NumTaps; ++Tap)
+		{
+			// distance of this tap from the output position, in input frames
+			const double X = (HalfTaps - 1) + static_cast<double>(Phase) / NumPhases - Tap;
+			const double SincX = Cutoff * X * UE_DOUBLE_PI;
+			const double Sinc = FMath::IsNearlyZero(SincX) ? 1.0 : FMath::Sin(SincX) / SincX;
+			const double WindowX = X / HalfTaps;
+			const double Window = BesselI0(KaiserBeta * FMath::Sqrt(FMath::Max(0.0, 1.0 - WindowX * WindowX))) * WindowScale;
+			const double Coefficient = Sinc * Window;
+			Row[Tap] = static_cast<float>(Coefficient);
+			RowSum += Coefficient;
+		}
+		// unity gain at DC for every phase
+		for (int32 Tap = 0; Tap < NumTaps; ++Tap)
+		{
+			Row[Tap] = static_cast<float>(Row[Tap] / RowSum);
+		}
+	}
+
+	Step = (static_cast<uint64>(SourceRate) << FractionBits) / static_cast<uint64>(TargetRate);
+	Coefficients.SetNumZeroed(NumTaps);
+	InputBuffer.SetNumZeroed((NumTaps + MaxInputFrames) * NumChannels);
+	Reset();
+}
+
+void FOmniverseStreamResampler::Reset()
+{
+	if (NumTaps == 0)
+	{
+		return;
+	}
+
+	// Start with half a filter of silence, so the first output frame lines up with the first input frame
+	NumBufferedFrames = NumTaps / 2 - 1;
+	FMemory::Memzero(InputBuffer.GetData(), NumBufferedFrames * NumChannels * sizeof(float));
+	Position = 0;
+}
+
+int32 FOmniverseStreamResampler::GetInputFramesNeeded(int32 NumOutputFrames) const
+{
+	if (NumOutputFrames <= 0 || NumTaps == 0)
+	{
+		return FMath::Max(NumOutputFrames, 0);
+	}
+
+	const uint64 LastPosition = Position + static_cast<uint64>(NumOutputFrames - 1) * Step;
+	const int64 RequiredFrames = static_cast<int64>(LastPosition >> FractionBits) + NumTaps;
+	return static_cast<int32>(FMath::Max<int64>(RequiredFrames - NumBufferedFrames, 0));
+}
+
+int32 FOmniverseStreamResampler::Process(const float* InData, int32 NumInputFrames, float* OutData, int32 MaxOutputFrames)
+{
+	if (NumTaps == 0)
+	{
+		return 0;
+	}
+
+	// Append the new input after the history. Callers ask GetInputFramesNeeded first, so this always fits
+	const int32 FreeFrames = NumTaps + MaxInputFrames - NumBufferedFrames;
+	const int32 NumAccepted = FMath::Clamp(NumInputFrames, 0, FreeFrames);
+	if (NumAccepted > 0)
+	{
+		FMemory::Memcpy(InputBuffer.GetData() + NumBufferedFrames * NumChannels, InData, NumAccepted * NumChannels * sizeof(float));
+		NumBufferedFrames += NumAccepted;
+	}
+
+	constexpr int32 AlphaBits = FractionBits - PhaseBits;
+	constexpr uint32 AlphaMask = (1u << AlphaBits) - 1;
+	constexpr float AlphaScale = 1.0f / static_cast<float>(1u << AlphaBits);
+
+	const float* Table = FilterTable.GetData();
+	float* Coeffs = Coefficients.GetData();
+	const float* Buffer = InputBuffer.GetData();
+
+	int32 NumOutput = 0;
+	while (NumOutput < MaxOutputFrames)
+	{
+		const int32 Index = static_cast<int32>(Position >> FractionBits);
+		if (Index + NumTaps > NumBufferedFrames)
+		{
+			break;
+		}
+
+		const uint32 Fraction = static_cast<uint32>(Position);
+		const float* Row0 = Table + (Fraction >> AlphaBits) * NumTaps;
+		const float* Row1 = Row0 + NumTaps;
+		const float Alpha = static_cast<float>(Fraction & AlphaMask) * AlphaScale;
+		for (int32 Tap = 0; Tap < NumTaps; ++Tap)
+		{
+			Coeffs[Tap] = Row0[Tap] + (Row1[Tap] - Row0[Tap]) * Alpha;
+		}
+
+		const float* Src = Buffer + Index * NumChannels;
+		float* Dst = OutData + NumOutput * NumChannels;
+		for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+		{
+			float Sum = 0.0f;
+			for (int32 Tap = 0; Tap < NumTaps; ++Tap)
+			{
+				Sum += Src[Tap * NumChannels + Channel] * Coeffs[Tap];
+			}
+			Dst[Channel] = Sum;
+		}
+
+		Position += Step;
+		++NumOutput;
+	}
+
+	// Drop the frames no later output needs
+	const int32 NumConsumed = FMath::Min(static_cast<int32>(Position >> FractionBits), NumBufferedFrames);
+	if (NumConsumed > 0)
+	{
+		NumBufferedFrames -= NumConsumed;
+		FMemory::Memmove(InputBuffer.GetData(), InputBuffer.GetData() + NumConsumed * NumChannels, NumBufferedFrames * NumChannels * sizeof(float));
+		Position -= static_cast<uint64>(NumConsumed) << FractionBits;
+	}
+
+	return NumOutput;
+}
+
+#if !UE_BUILD_SHIPPING
+
+// Quality and CPU budget check for FOmniverseStreamResampler.
+// Usage: omni.SubmixResamplerTest [SourceRate=16000] [TargetRate=48000]
+namespace
+{
+	static TAutoConsoleVariable<float> CVarOmniverseResamplerBudget(
+		TEXT("omni.SubmixResamplerTest.BudgetPercent"),
+		5.0f,
+		TEXT("omni.SubmixResamplerTest fails if resampling a 256 frame stereo buffer takes more than this percentage of its duration at the 99th percentile (default is 5).\n"),
+		ECVF_Default);
+
+	constexpr double MinSignalToNoiseDb = 70.0;
+
+	void RunResamplerTest(const TArray<FString>& Args)
+	{
+		const int32 SourceRate = FMath::Max((Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 16000, 1000);
+		const int32 TargetRate = FMath::Max((Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 48000, 1000);
+		if (SourceRate == TargetRate)
+		{
+			UE_LOG(LogACE, Display, TEXT("omni.SubmixResamplerTest: rates match, nothing to resample"));
+			return;
+		}
+
+		// Quality: stream a sine in irregular chunk sizes and compare with the ideal sine at the target rate
+		constexpr double ToneFrequency = 997.0;
+		constexpr double Amplitude = 0.5;
+		constexpr int32 MaxChunkFrames = 1024;
+		const int32 ChunkSizes[] = { 1, 37, 160, 441, 1024, 3 };
+
+		FOmniverseStreamResampler Resampler;
+		Resampler.Init(1, SourceRate, TargetRate, MaxChunkFrames);
+
+		TArray<float> Input;
+		Input.SetNumUninitialized(SourceRate);
+		for (int32 Index = 0; Index < Input.Num(); ++Index)
+		{
+			Input[Index] = static_cast<float>(Amplitude * FMath::Sin(2.0 * UE_DOUBLE_PI * ToneFrequency * Index / SourceRate));
+		}
+
+		TArray<float> Output;
+		Output.SetNumZeroed(TargetRate + 16);
+		int32 NumOutput = 0;
+		for (int32 InputIndex = 0, ChunkIndex = 0; InputIndex < Input.Num(); ++ChunkIndex)
+		{
+			const int32 NumInput = FMath::Min(ChunkSizes[ChunkIndex % UE_ARRAY_COUNT(ChunkSizes)], Input.Num() - InputIndex);
+			NumOutput += Resampler.Process(&Input[InputIndex], NumInput, &Output[NumOutput], Output.Num() - NumOutput);
+			InputIndex += NumInput;
+		}
+
+		// skip the filter's warm up from silence
+		const int32 FirstCompared = Resampler.GetNumTaps() * TargetRate / SourceRate + 1;
+		double SignalPower = 0.0;
+		double NoisePower = 0.0;
+		for (int32 Index = FirstCompared; Index < NumOutput; ++Index)
+		{
+			const double Expected = Amplitude * FMath::Sin(2.0 * UE_DOUBLE_PI * ToneFrequency * Index / TargetRate);
+			SignalPower += Expected * Expected;
+			NoisePower += FMath::Square(Output[Index] - Expected);
+		}
+		const double SignalToNoiseDb = 10.0 * FMath::LogX(10.0, SignalPower / FMath::Max(NoisePower, 1e-30));
+		const int32 ExpectedOutput = static_cast<int32>(static_cast<int64>(Input.Num()) * TargetRate / SourceRate);
+		const bool bQualityPassed = SignalToNoiseDb >= MinSignalToNoiseDb && FMath::Abs(NumOutput - ExpectedOutput) <= Resampler.GetNumTaps() * TargetRate / SourceRate + 1;
+
+		// Budget: time each mixer sized buffer of stereo output, the way the submix callback drives it
+		constexpr int32 BufferFrames = 256;
+		constexpr int32 NumBuffers = 4000;
+		FOmniverseStreamResampler StereoResampler;
+		StereoResampler.Init(2, SourceRate, TargetRate, 4096);
+
+		TArray<float> StereoInput;
+		StereoInput.SetNumZeroed(4096 * 2);
+		for (int32 Index = 0; Index < StereoInput.Num(); ++Index)
+		{
+			StereoInput[Index] = FMath::FRandRange(-0.5f, 0.5f);
+		}
+		TArray<float> StereoOutput;
+		StereoOutput.SetNumZeroed(BufferFrames * 2);
+
+		TArray<double> BufferSeconds;
+		BufferSeconds.SetNumUninitialized(NumBuffers);
+		for (int32 Buffer = 0; Buffer < NumBuffers; ++Buffer)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			const int32 NumInput = FMath::Min(StereoResampler.GetInputFramesNeeded(BufferFrames), StereoResampler.GetMaxInputFrames());
+			StereoResampler.Process(StereoInput.GetData(), NumInput, StereoOutput.GetData(), BufferFrames);
+			BufferSeconds[Buffer] = FPlatformTime::Seconds() - StartTime;
+		}
+		BufferSeconds.Sort();
+
+		const double BudgetSeconds = static_cast<double>(BufferFrames) / TargetRate;
+		const double P99Percent = 100.0 * BufferSeconds[NumBuffers * 99 / 100] / BudgetSeconds;
+		const double MaxPercent = 100.0 * BufferSeconds.Last() / BudgetSeconds;
+		const bool bBudgetPassed = P99Percent <= CVarOmniverseResamplerBudget.GetValueOnAnyThread();
+
+		if (bQualityPassed && bBudgetPassed)
+		{
+			UE_LOG(LogACE, Display, TEXT("omni.SubmixResamplerTest PASSED: %d -> %d Hz, %d taps, SNR %.1f dB, %d frames out, buffer cost p99 %.3f%% max %.3f%% of budget"),
+				SourceRate, TargetRate, Resampler.GetNumTaps(), SignalToNoiseDb, NumOutput, P99Percent, MaxPercent);
+		}
+		else
+		{
+			UE_LOG(LogACE, Error, TEXT("omni.SubmixResamplerTest FAILED: %d -> %d Hz, %d taps, SNR %.1f dB (min %.1f), %d frames out (expected %d), buffer cost p99 %.3f%% max %.3f%% of budget (max %.1f%%)"),
+				SourceRate, TargetRate, Resampler.GetNumTaps(), SignalToNoiseDb, MinSignalToNoiseDb, NumOutput, ExpectedOutput, P99Percent, MaxPercent, CVarOmniverseResamplerBudget.GetValueOnAnyThread());
+		}
+	}
+
+	FAutoConsoleCommand CmdOmniverseSubmixResamplerTest(
+		TEXT("omni.SubmixResamplerTest"),
+		TEXT("Check the Omniverse submix resampler's quality with a streamed sine, and its cost per 256 frame buffer against omni.SubmixResamplerTest.BudgetPercent. Args: [SourceRate] [TargetRate]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunResamplerTest));
+}
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+// Streaming resampler for interleaved float audio, used when an incoming wave's rate differs from the submix rate.
+//
+// It's a windowed sinc polyphase filter with linear interpolation between phases. The filter table and buffers are
+// allocated in Init, Process never allocates, and keeps its history and phase between calls so consecutive buffers
+// join up without clicks. Cost per output frame is bounded by the tap count, which is at most MaxTaps.
+class FOmniverseStreamResampler
+{
+public:
+	static constexpr int32 MaxTaps = 64;
+
+	// Allocates the filter table and the input buffer. Not meant for the audio thread
+	void Init(int32 InNumChannels, int32 InSourceRate, int32 InTargetRate, int32 InMaxInputFrames);
+
+	// Drop the history, the next Process starts from silence
+	void Reset();
+
+	bool IsInitialized() const { return NumChannels > 0; }
+	bool IsPassthrough() const { return SourceRate == TargetRate; }
+	int32 GetSourceRate() const { return SourceRate; }
+	int32 GetTargetRate() const { return TargetRate; }
+	int32 GetNumTaps() const { return NumTaps; }
+	int32 GetMaxInputFrames() const { return MaxInputFrames; }
+
+	// Number of input frames to pass to Process before it can produce NumOutputFrames frames
+	int32 GetInputFramesNeeded(int32 NumOutputFrames) const;
+
+	// Take NumInputFrames frames (at most GetMaxInputFrames) and write up to MaxOutputFrames resampled frames to OutData.
+	// Input that isn't needed yet stays buffered for the next call. Returns the number of frames written
+	int32 Process(const float* InData, int32 NumInputFrames, float* OutData, int32 MaxOutputFrames);
+
+private:
+	// 32.32 fixed point, so the read position doesn't drift over long streams
+	static constexpr int32 FractionBits = 32;
+	static constexpr int32 PhaseBits = 7;
+	static constexpr int32 NumPhases = 1 << PhaseBits;
+
+	int32 NumChannels = 0;
+	int32 SourceRate = 0;
+	int32 TargetRate = 0;
+	int32 NumTaps = 0;
+	int32 MaxInputFrames = 0;
+
+	// Input position of the next output frame, relative to the start of InputBuffer
+	uint64 Position = 0;
+	// Input frames per output frame
+	uint64 Step = 0;
+
+	// (NumPhases + 1) rows of NumTaps coefficients, the last row lets the top phase interpolate without wrapping
+	TArray<float> FilterTable;
+	// Coefficients interpolated for the current output frame
+	TArray<float> Coefficients;
+	// Interleaved history followed by new input
+	TArray<float> InputBuffer;
+	int32 NumBufferedFrames = 0;
+};
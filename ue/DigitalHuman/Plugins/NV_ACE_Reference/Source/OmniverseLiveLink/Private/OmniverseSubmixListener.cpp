@@ -24,6 +24,7 @@
 #include "OmniverseSubmixListener.h"
 #include "AudioMixerDevice.h"
 #include "AudioMixerSubmix.h"
+#include "DSP/FloatArrayMath.h"
 #include "Engine/World.h"
 #include "Runtime/Launch/Resources/Version.h"
 
@@ -39,6 +40,14 @@ static TAutoConsoleVariable<int32> CVarOmniverseWaveStreamBufferSize(
 	TEXT("Adjusts the size of the circular audio sample buffer in MB (default is 1).\n"),
 	ECVF_Default);
 
+static TAutoConsoleVariable<int32> CVarOmniverseWaveStreamChunkFrames(
+	TEXT("omni.WaveStreamChunkFrames"),
+	4096,
+	TEXT("Number of frames the submix render callback converts at a time. Scratch buffers of this size are allocated per wave stream (default is 4096).\n"),
+	ECVF_Default);
+
+DECLARE_CYCLE_STAT(TEXT("Omniverse Submix Render"), STAT_OmniverseSubmixRender, STATGROUP_ACE);
+
 
 FOmniverseSubmixListener::FOmniverseSubmixListener()
 {
@@ -145,7 +154,7 @@ void FOmniverseSubmixListener::OnDeviceDestroyed(Audio::FDeviceId InDeviceId)
 void FOmniverseSubmixListener::AddNewWave(const FOmniverseWaveFormatInfo& Format)
 {
 	int32 BufferMB = CVarOmniverseWaveStreamBufferSize.GetValueOnAnyThread();
-	auto NewStream = MakeShareable(new FWaveStream(Format, BufferMB * 1024 * 1024));
+	auto NewStream = MakeShareable(new FWaveStream(Format, BufferMB * 1024 * 1024, SubmixSampleRate));
 	
 	if (!PlayingStream.IsValid())
 	{
@@ -200,253 +209,279 @@ void FOmniverseSubmixListener::TrySwitchToNextStream()
 	}
 }
 
-// ISubmixBufferListener
-// when called, submit samples to audio device in OnNewSubmixBuffer
-void FOmniverseSubmixListener::OnNewSubmixBuffer(const USoundSubmix* OwningSubmix, float* AudioData, int32 NumSamples, int32 NumChannels, const int32 SampleRate, double AudioClock)
+// Format conversion kernels. These are plain loops over contiguous samples, so the compiler vectorizes them, or use the
+// engine's SIMD helpers where there is one
+static void ConvertPcm16ToFloat(const uint8* Src, float* Dst, int32 NumSamples)
+{
+	Audio::ArrayPcm16ToFloat(MakeArrayView(reinterpret_cast<const int16*>(Src), NumSamples), MakeArrayView(Dst, NumSamples));
+}
+
+static void ConvertPcm8ToFloat(const uint8* Src, float* Dst, int32 NumSamples)
+{
+	const int8* Samples = reinterpret_cast<const int8*>(Src);
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		Dst[Index] = static_cast<float>(Samples[Index]) * (1.0f / 128.0f);
+	}
+}
+
+static void ConvertFloat32ToFloat(const uint8* Src, float* Dst, int32 NumSamples)
+{
+	FMemory::Memcpy(Dst, Src, NumSamples * sizeof(float));
+}
+
+static void ConvertFloat64ToFloat(const uint8* Src, float* Dst, int32 NumSamples)
+{
+	const double* Samples = reinterpret_cast<const double*>(Src);
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		Dst[Index] = static_cast<float>(Samples[Index]);
+	}
+}
+
+// unsupported formats are still consumed, but play as silence
+static void ConvertUnsupportedToFloat(const uint8* Src, float* Dst, int32 NumSamples)
 {
-	auto GetFloatSample = [](uint8* Buffer, int32 StartIndex, int32 BufferSize, int32 BitsPerSample, int32 SampleType, float& Out)
+	FMemory::Memzero(Dst, NumSamples * sizeof(float));
+}
+
+static void MixIntoOutput(const float* InData, int32 NumFrames, int32 InChannels, float* OutData, int32 OutChannels)
+{
+	if (InChannels == OutChannels)
+	{
+		Audio::ArrayMixIn(MakeArrayView(InData, NumFrames * InChannels), MakeArrayView(OutData, NumFrames * OutChannels));
+	}
+	else if (InChannels == 1)
 	{
-		if (BitsPerSample == 32 && SampleType == 3)
+		// Mono wave need duplicate the sample
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
 		{
-			if (StartIndex + 3 >= BufferSize)
+			const float Sample = InData[Frame];
+			for (int32 Channel = 0; Channel < OutChannels; ++Channel)
 			{
-				return false;
+				OutData[Frame * OutChannels + Channel] += Sample;
 			}
-			// IEEE Float
-			float* Sample = reinterpret_cast<float*>(Buffer);
-			Out = (*Sample);
-			return true;
 		}
-		else if (BitsPerSample == 64 && SampleType == 3)
+	}
+	else if (OutChannels == 1)
+	{
+		// downmix to mono
+		const float Scale = 1.0f / InChannels;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
 		{
-			if (StartIndex + 7 >= BufferSize)
+			float Sum = 0.0f;
+			for (int32 Channel = 0; Channel < InChannels; ++Channel)
 			{
-				return false;
+				Sum += InData[Frame * InChannels + Channel];
 			}
-
-			// IEEE Float
-			double* Sample = reinterpret_cast<double*>(Buffer);
-			Out = (float)(*Sample);
-			return true;
+			OutData[Frame] += Sum * Scale;
 		}
-		else if (BitsPerSample == 16 && SampleType == 1)
+	}
+	else
+	{
+		// stereo to surround: fill the front channels only
+		const int32 MixChannels = FMath::Min(InChannels, OutChannels);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
 		{
-			if (StartIndex + 1 >= BufferSize)
+			for (int32 Channel = 0; Channel < MixChannels; ++Channel)
 			{
-				return false;
+				OutData[Frame * OutChannels + Channel] += InData[Frame * InChannels + Channel];
 			}
-
-			// convert 16bit pcm to float
-			int16* Sample = reinterpret_cast<int16*>(Buffer);
-			Out = (float)(*Sample) / ((*Sample) >= 0 ? (float)MAX_int16 : ((float)MAX_int16 + 1));
-			return true;
 		}
-		else if (BitsPerSample == 8 && SampleType == 1)
-		{
-			if (StartIndex >= BufferSize)
-			{
-				return false;
-			}
+	}
+}
 
-			// convert 8bit pcm to float
-			int8* Sample = reinterpret_cast<int8*>(Buffer);
-			Out = (float)(*Sample) / ((*Sample) >= 0 ? (float)MAX_int8 : ((float)MAX_int8 + 1));
-			return true;
-		}
+FOmniverseSubmixListener::FWaveStream::FWaveStream(const FOmniverseWaveFormatInfo& NewWaveFormat, uint32 Capacity, int32 OutputSampleRate)
+	: WaveFormat(NewWaveFormat)
+	, NextStream(nullptr)
+{
+	LocklessStreamBuffer.SetCapacity(Capacity);
 
-		return false;
-	};
+	if (WaveFormat.BitsPerSample == 32 && WaveFormat.SampleType == 3)
+	{
+		ConvertToFloat = &ConvertFloat32ToFloat;
+	}
+	else if (WaveFormat.BitsPerSample == 64 && WaveFormat.SampleType == 3)
+	{
+		ConvertToFloat = &ConvertFloat64ToFloat;
+	}
+	else if (WaveFormat.BitsPerSample == 16 && WaveFormat.SampleType == 1)
+	{
+		ConvertToFloat = &ConvertPcm16ToFloat;
+	}
+	else if (WaveFormat.BitsPerSample == 8 && WaveFormat.SampleType == 1)
+	{
+		ConvertToFloat = &ConvertPcm8ToFloat;
+	}
+	else
+	{
+		UE_LOG(LogACE, Warning, TEXT("Unsupported wave format: %d bits, sample type %d. It will play as silence."), WaveFormat.BitsPerSample, WaveFormat.SampleType);
+		ConvertToFloat = &ConvertUnsupportedToFloat;
+	}
 
-	auto CurrentStream = PlayingStream;
-	if (bSubmixActivated && CurrentStream.IsValid())
+	BytesPerFrame = FMath::Max(WaveFormat.BitsPerSample / 8, 1) * FMath::Max(WaveFormat.NumChannels, 1);
+	MaxChunkFrames = FMath::Max(CVarOmniverseWaveStreamChunkFrames.GetValueOnAnyThread(), 64);
+	PopBuffer.SetNumUninitialized(MaxChunkFrames * BytesPerFrame);
+	FloatBuffer.SetNumUninitialized(MaxChunkFrames * FMath::Max(WaveFormat.NumChannels, 1));
+
+	Resampler.Init(WaveFormat.NumChannels, WaveFormat.SamplesPerSecond, OutputSampleRate, MaxChunkFrames);
+	if (!Resampler.IsPassthrough())
 	{
-		if (CurrentStream->HasStream())
-		{
-			// Use WaveFormat struct to do all of the int-float + resampling
-			FOmniverseWaveFormatInfo& WaveFormat = CurrentStream->WaveFormat;
-			int32 Stride = WaveFormat.BitsPerSample / 8;
-			// Sample numbers of steam
+		ResampledBuffer.SetNumUninitialized(MaxChunkFrames * FMath::Max(WaveFormat.NumChannels, 1));
+	}
+}
 
-			int32 StreamSamples = CurrentStream->LocklessStreamBuffer.Num() / Stride;
-			if (WaveFormat.NumChannels == 1)
-			{
-				StreamSamples *= NumChannels;
-			}
-			// if stereo wave didn't contain the even number of wave samples, fix it 
-			else if (StreamSamples % 2 == 1)
-			{
-				StreamSamples++;
-			}
+int32 FOmniverseSubmixListener::PopFrames(FWaveStream& Stream, FWaveStream* NextStream, int32 NumFrames)
+{
+	int32 AvailableBytes = static_cast<int32>(Stream.LocklessStreamBuffer.Num());
+	if (NextStream != nullptr)
+	{
+		AvailableBytes += static_cast<int32>(NextStream->LocklessStreamBuffer.Num());
+	}
 
-			// Get the minimal sample number
-			int32 PlaySamples = FMath::Min(NumSamples, StreamSamples);
-			auto AllocPopBuffer = [Stride, NumChannels](TArray<uint8>& Buffer, int32 AllocSamples, int WaveChannels)
-			{
-				int32 BufferSize = AllocSamples * Stride;
-				// Mono wave just need half samples
-				if (WaveChannels == 1)
-				{
-					BufferSize /= NumChannels;
-				}
-				Buffer.AddUninitialized(BufferSize);
-			};
-			
-			// Check if next stream can fill in
-			int32 NextFetchSamples = 0;
-			if (NumSamples - PlaySamples > 0 && CurrentStream->NextStream.IsValid())
-			{
-				auto NextStream = CurrentStream->NextStream.Get();
-				if (NextStream->WaveFormat == WaveFormat)
-				{
-					int32 NextStreamSamples = NextStream->LocklessStreamBuffer.Num() / Stride;
-					if (WaveFormat.NumChannels == 1)
-					{
-						NextStreamSamples *= NumChannels;
-					}
+	const int32 NumPopFrames = FMath::Min(NumFrames, AvailableBytes / Stream.BytesPerFrame);
+	const int32 PopBytes = NumPopFrames * Stream.BytesPerFrame;
+	if (PopBytes <= 0)
+	{
+		return 0;
+	}
 
-					// Get the size which needs to fetch from next stream
-					NextFetchSamples = FMath::Min(NumSamples - PlaySamples, NextStreamSamples);
-					// New play samples
-					PlaySamples += NextFetchSamples;
-				}
-			}
+	int32 PopSize = Stream.LocklessStreamBuffer.Pop(Stream.PopBuffer.GetData(), PopBytes);
+	// Fill in buffer from next stream if it's available
+	if (PopSize < PopBytes && NextStream != nullptr)
+	{
+		PopSize += NextStream->LocklessStreamBuffer.Pop(Stream.PopBuffer.GetData() + PopSize, PopBytes - PopSize);
+	}
 
-			if (PlaySamples > 0)
-			{
-#if 0
-				if (WaveFormat.SamplesPerSecond != SampleRate)
-				{
-					// To get the real size to resample
-					Audio::FAlignedFloatBuffer PreResamplerInputData;
-					PreResamplerInputData.AddUninitialized(NumSamples);
-					Audio::FResamplingParameters PreResamplerParameters = {
-						Audio::EResamplingMethod::BestSinc,
-						NumChannels,
-						SampleRate,
-						WaveFormat.SamplesPerSecond,
-						PreResamplerInputData
-					};
-					int32 ResamplerSamples = FMath::Min(PlaySamples, Audio::GetOutputBufferSize(PreResamplerParameters));
-
-					// Use this real size to get the buffer to sampler
-					Audio::FAlignedFloatBuffer ResamplerInputData;
-					ResamplerInputData.AddUninitialized(ResamplerSamples);
-
-					TArray<uint8> Buffer;
-					AllocPopBuffer(Buffer, ResamplerSamples, WaveFormat.NumChannels);
-
-					int32 PopSize = CurrentStream->LocklessStreamBuffer.Pop(Buffer.GetData(), Buffer.Num());
-
-					if (PopSize < Buffer.Num() && CurrentStream->NextStream.IsValid())
-					{
-						auto NextStream = CurrentStream->NextStream.Get();
-						if (NextStream->WaveFormat == WaveFormat)
-						{
-							NextStream->LocklessStreamBuffer.Pop(Buffer.GetData() + PopSize, Buffer.Num() - PopSize);
-						}
-					}
+	const int32 PoppedFrames = PopSize / Stream.BytesPerFrame;
+	Stream.ConvertToFloat(Stream.PopBuffer.GetData(), Stream.FloatBuffer.GetData(), PoppedFrames * FMath::Max(Stream.WaveFormat.NumChannels, 1));
+	return PoppedFrames;
+}
 
-					for (int32 SampleIndex = 0, SourceSampleIndex = 0; SampleIndex < ResamplerSamples; SampleIndex += NumChannels)
-					{
-						for (int32 Channel = 0; Channel < NumChannels; ++Channel)
-						{
-							float Out;
-							int32 BufferIdx = SourceSampleIndex * Stride;
-							if (BufferIdx < Buffer.Num() && GetFloatSample(&Buffer[BufferIdx], BufferIdx, Buffer.Num(), WaveFormat.BitsPerSample, WaveFormat.SampleType, Out))
-							{
-								ResamplerInputData[SampleIndex + Channel] = Out;
-							}
-							else
-							{
-								ResamplerInputData[SampleIndex + Channel] = 0.0f;
-							}
-
-							// Mono wave need duplicate the sample
-							if (WaveFormat.NumChannels < NumChannels)
-							{
-								if (Channel == WaveFormat.NumChannels)
-								{
-									SourceSampleIndex++;
-								}
-							}
-							else
-							{
-								SourceSampleIndex++;
-							}
-						}
-					}
+void FOmniverseSubmixListener::MixStream(FWaveStream& Stream, float* AudioData, int32 NumFrames, int32 NumChannels, int32 SampleRate)
+{
+	const int32 WaveChannels = FMath::Max(Stream.WaveFormat.NumChannels, 1);
 
-					Audio::FResamplingParameters ResamplerParameters = {
-						Audio::EResamplingMethod::BestSinc,
-						NumChannels,
-						WaveFormat.SamplesPerSecond,
-						SampleRate,
-						ResamplerInputData
-					};
-
-					Audio::FAlignedFloatBuffer ResamplerOutputData;
-					// This buffer size should be close or equal to NumSamples
-					ResamplerOutputData.AddUninitialized(Audio::GetOutputBufferSize(ResamplerParameters));
-					Audio::FResamplerResults ResamplerResults;
-					ResamplerResults.OutBuffer = &ResamplerOutputData;
-
-					bool bResampleResult = Audio::Resample(ResamplerParameters, ResamplerResults);
-					if (bResampleResult)
-					{
-						int32 NumResamples = FMath::Min(ResamplerOutputData.Num(), NumSamples);
-						for (int32 SampleIndex = 0; SampleIndex < NumResamples; SampleIndex += NumChannels)
-						{
-							for (int32 Channel = 0; Channel < NumChannels; ++Channel)
-							{
-								AudioData[SampleIndex + Channel] += ResamplerOutputData[SampleIndex + Channel];
-							}
-						}
-					}
-				}
-				else
-#endif
-				{
-					TArray<uint8> Buffer;
-					AllocPopBuffer(Buffer, PlaySamples, WaveFormat.NumChannels);
+	// Check if next stream can fill in
+	FWaveStream* NextStream = (Stream.NextStream.IsValid() && (Stream.NextStream->WaveFormat == Stream.WaveFormat)) ? Stream.NextStream.Get() : nullptr;
 
-					int32 PopSize = CurrentStream->LocklessStreamBuffer.Pop(Buffer.GetData(), Buffer.Num());
-					// Fill in buffer from next stream if it's available
-					if (PopSize < Buffer.Num() && CurrentStream->NextStream.IsValid() && NextFetchSamples > 0)
-					{
-						CurrentStream->NextStream.Get()->LocklessStreamBuffer.Pop(Buffer.GetData() + PopSize, Buffer.Num() - PopSize);
-					}
+	FOmniverseStreamResampler& Resampler = Stream.Resampler;
+	if (Resampler.GetTargetRate() != SampleRate)
+	{
+		// The device runs at a different rate than the one it was created with. Rare, so it's fine to allocate here
+		UE_LOG(LogACE, Warning, TEXT("Submix rate changed from %d to %d Hz, reinitializing the wave stream resampler."), Resampler.GetTargetRate(), SampleRate);
+		Resampler.Init(WaveChannels, Stream.WaveFormat.SamplesPerSecond, SampleRate, Stream.MaxChunkFrames);
+		Stream.ResampledBuffer.SetNumUninitialized(Stream.MaxChunkFrames * WaveChannels);
+	}
+	const bool bResample = !Resampler.IsPassthrough();
 
-					for (int32 SampleIndex = 0, SourceSampleIndex = 0; SampleIndex < PlaySamples; SampleIndex += NumChannels)
-					{
-						for (int32 Channel = 0; Channel < NumChannels; ++Channel)
-						{
-							float Out;
-							int32 BufferIdx = SourceSampleIndex * Stride;
-							if (BufferIdx < Buffer.Num() && GetFloatSample(&Buffer[BufferIdx], BufferIdx, Buffer.Num(), WaveFormat.BitsPerSample, WaveFormat.SampleType, Out))
-							{
-								AudioData[SampleIndex + Channel] += Out;
-							}
-
-							// Mono wave need duplicate the sample
-							if (WaveFormat.NumChannels < NumChannels)
-							{
-								if (Channel == WaveFormat.NumChannels)
-								{
-									SourceSampleIndex++;
-								}
-							}
-							else
-							{
-								SourceSampleIndex++;
-							}
-						}
-					}
-				}
-			}
+	int32 FramesLeft = NumFrames;
+	float* OutData = AudioData;
+	while (FramesLeft > 0)
+	{
+		const int32 ChunkFrames = FMath::Min(FramesLeft, Stream.MaxChunkFrames);
+		const int32 InputFrames = bResample ? FMath::Min(Resampler.GetInputFramesNeeded(ChunkFrames), Stream.MaxChunkFrames) : ChunkFrames;
+		const int32 PoppedFrames = PopFrames(Stream, NextStream, InputFrames);
+
+		int32 MixedFrames = PoppedFrames;
+		if (bResample)
+		{
+			MixedFrames = Resampler.Process(Stream.FloatBuffer.GetData(), PoppedFrames, Stream.ResampledBuffer.GetData(), ChunkFrames);
+			MixIntoOutput(Stream.ResampledBuffer.GetData(), MixedFrames, WaveChannels, OutData, NumChannels);
+		}
+		else
+		{
+			MixIntoOutput(Stream.FloatBuffer.GetData(), MixedFrames, WaveChannels, OutData, NumChannels);
+		}
+
+		OutData += MixedFrames * NumChannels;
+		FramesLeft -= MixedFrames;
+		if (PoppedFrames < InputFrames || MixedFrames == 0)
+		{
+			// out of data
+			break;
+		}
+	}
+
+	// The next stream takes over once this one is empty, give it the filter history so the join doesn't click
+	if (NextStream != nullptr && !Stream.HasStream())
+	{
+		Swap(Stream.Resampler, NextStream->Resampler);
+		Swap(Stream.ResampledBuffer, NextStream->ResampledBuffer);
+	}
+}
+
+// ISubmixBufferListener
+// when called, submit samples to audio device in OnNewSubmixBuffer
+void FOmniverseSubmixListener::OnNewSubmixBuffer(const USoundSubmix* OwningSubmix, float* AudioData, int32 NumSamples, int32 NumChannels, const int32 SampleRate, double AudioClock)
+{
+	SCOPE_CYCLE_COUNTER(STAT_OmniverseSubmixRender);
+
+	auto CurrentStream = PlayingStream;
+	if (bSubmixActivated && CurrentStream.IsValid())
+	{
+		if (CurrentStream->HasStream() && NumChannels > 0)
+		{
+			MixStream(*CurrentStream, AudioData, NumSamples / NumChannels, NumChannels, SampleRate);
 		}
 
 		TrySwitchToNextStream();
 	}
 }
 
+#if !UE_BUILD_SHIPPING
+void FOmniverseSubmixListener::RunRenderBenchmark(const TArray<FString>& Args)
+{
+	const int32 BitsPerSample = (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 16;
+	const int32 WaveChannels = FMath::Clamp((Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 1, 1, 2);
+	const int32 Iterations = FMath::Max((Args.Num() > 2) ? FCString::Atoi(*Args[2]) : 10000, 1);
+
+	// typical mixer callback: 48 kHz stereo, 256 frames
+	constexpr int32 SampleRate = 48'000;
+	constexpr int32 NumFrames = 256;
+	constexpr int32 NumChannels = 2;
+	const int32 WaveSampleRate = FMath::Max((Args.Num() > 3) ? FCString::Atoi(*Args[3]) : SampleRate, 1000);
+
+	FOmniverseWaveFormatInfo Format;
+	Format.SamplesPerSecond = WaveSampleRate;
+	Format.NumChannels = WaveChannels;
+	Format.BitsPerSample = BitsPerSample;
+	Format.SampleType = (BitsPerSample >= 32) ? 3 : 1;
+	FWaveStream Stream(Format, 1024 * 1024, SampleRate);
+
+	// enough wave frames for one callback, plus one for the resampler's rounding
+	const int32 InputFrames = FMath::DivideAndRoundUp(NumFrames * WaveSampleRate, SampleRate) + 1;
+	TArray<uint8> Input;
+	Input.SetNumZeroed(InputFrames * Stream.BytesPerFrame);
+	Audio::FAlignedFloatBuffer Output;
+	Output.SetNumZeroed(NumFrames * NumChannels);
+
+	double MixSeconds = 0.0;
+	double MaxSeconds = 0.0;
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		if (Stream.LocklessStreamBuffer.Num() < static_cast<uint32>(Input.Num()))
+		{
+			Stream.LocklessStreamBuffer.Push(Input.GetData(), Input.Num());
+		}
+		const double StartTime = FPlatformTime::Seconds();
+		MixStream(Stream, Output.GetData(), NumFrames, NumChannels, SampleRate);
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		MixSeconds += Elapsed;
+		MaxSeconds = FMath::Max(MaxSeconds, Elapsed);
+	}
+
+	const double BudgetSeconds = static_cast<double>(NumFrames) / SampleRate;
+	const double AvgSeconds = MixSeconds / Iterations;
+	UE_LOG(LogACE, Display, TEXT("omni.SubmixRenderBenchmark: %d-bit %s %d Hz, %d frames @ %d Hz: avg %.2f us (%.3f%% of callback budget), max %.2f us"),
+		BitsPerSample, (WaveChannels == 1) ? TEXT("mono") : TEXT("stereo"), WaveSampleRate, NumFrames, SampleRate,
+		AvgSeconds * 1e6, 100.0 * AvgSeconds / BudgetSeconds, MaxSeconds * 1e6);
+}
+
+static FAutoConsoleCommand CmdOmniverseSubmixRenderBenchmark(
+	TEXT("omni.SubmixRenderBenchmark"),
+	TEXT("Time the Omniverse submix render callback's conversion and mixing at 48 kHz with 256 frame buffers, resampling when WaveSampleRate differs. Args: [BitsPerSample] [WaveChannels] [Iterations] [WaveSampleRate]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FOmniverseSubmixListener::RunRenderBenchmark));
+#endif
+
 #undef LOCTEXT_NAMESPACE
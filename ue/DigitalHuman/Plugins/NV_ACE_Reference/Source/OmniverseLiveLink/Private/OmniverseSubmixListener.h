@@ -25,6 +25,7 @@
 #include "CoreMinimal.h"
 #include "AudioDevice.h"
 #include "ISubmixBufferListener.h"
+#include "OmniverseStreamResampler.h"
 #include "OmniverseWaveDef.h"
 
 class FOmniverseSubmixListener : public ISubmixBufferListener
@@ -49,24 +50,49 @@ protected:
 	// ISubmixBufferListener
 	// when called, submit samples to audio device in OnNewSubmixBuffer
 	virtual void OnNewSubmixBuffer(const USoundSubmix* OwningSubmix, float* AudioData, int32 NumSamples, int32 NumChannels, const int32 SampleRate, double AudioClock) override;
-	
+
+#if !UE_BUILD_SHIPPING
+public:
+	// Times the render callback's mixing work for a given wave format. Args: [BitsPerSample] [WaveChannels] [Iterations] [WaveSampleRate]
+	static void RunRenderBenchmark(const TArray<FString>& Args);
+#endif
+
 private:
+	// Converts NumSamples samples of the stream's format to float
+	using FConvertToFloatFunc = void (*)(const uint8* Src, float* Dst, int32 NumSamples);
+
 	struct FWaveStream
 	{
-		FWaveStream(const FOmniverseWaveFormatInfo& NewWaveFormat, uint32 Capacity)
-			: WaveFormat(NewWaveFormat)
-			, NextStream(nullptr)
-		{
-			LocklessStreamBuffer.SetCapacity(Capacity);
-		}
+		FWaveStream(const FOmniverseWaveFormatInfo& NewWaveFormat, uint32 Capacity, int32 OutputSampleRate);
 
 		bool HasStream() { return LocklessStreamBuffer.Num() > 0; }
 
 		FOmniverseWaveFormatInfo WaveFormat;
 		mutable Audio::TCircularAudioBuffer<uint8> LocklessStreamBuffer;
 		TSharedPtr<FWaveStream> NextStream;
+
+		// Picked once for the stream's format, so the render callback doesn't branch per sample
+		FConvertToFloatFunc ConvertToFloat = nullptr;
+		int32 BytesPerFrame = 0;
+
+		// Scratch buffers for the render callback, allocated with the stream so the callback never allocates.
+		// Callbacks bigger than MaxChunkFrames are mixed in several chunks
+		int32 MaxChunkFrames = 0;
+		TArray<uint8> PopBuffer;
+		Audio::FAlignedFloatBuffer FloatBuffer;
+
+		// Converts the stream to the submix rate when they differ. It's handed on to the next stream together with the
+		// history, when the next stream takes over with the same format
+		FOmniverseStreamResampler Resampler;
+		Audio::FAlignedFloatBuffer ResampledBuffer;
 	};
 
+	// Pop up to NumFrames frames of Stream, or of its next stream once it runs dry, and convert them to FloatBuffer
+	static int32 PopFrames(FWaveStream& Stream, FWaveStream* NextStream, int32 NumFrames);
+
+	// Mix up to NumFrames frames of Stream (and its next stream, if the current one runs dry) into AudioData
+	static void MixStream(FWaveStream& Stream, float* AudioData, int32 NumFrames, int32 NumChannels, int32 SampleRate);
+
 	void OnDeviceDestroyed(Audio::FDeviceId InDeviceId);
 	void TrySwitchToNextStream();
 
@@ -35,8 +35,8 @@ struct FOmniverseWaveFormatInfo
 
 inline bool operator==(const FOmniverseWaveFormatInfo& F1, const FOmniverseWaveFormatInfo& F2)
 {
-	return F1.SamplesPerSecond && F2.SamplesPerSecond 
-		&& F1.NumChannels && F2.NumChannels
-		&& F1.BitsPerSample && F2.BitsPerSample
-		&& F1.SampleType && F2.SampleType;
+	return F1.SamplesPerSecond == F2.SamplesPerSecond
+		&& F1.NumChannels == F2.NumChannels
+		&& F1.BitsPerSample == F2.BitsPerSample
+		&& F1.SampleType == F2.SampleType;
 }
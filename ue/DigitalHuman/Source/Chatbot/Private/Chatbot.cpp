@@ -8,6 +8,182 @@
 #include "Containers/Ticker.h"   // ✅ for FTSTicker
 #include "PromptGenerator.h"  // 新模块头
 #include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/IConsoleManager.h"
+#include "PlatformHttp.h"
+
+static TAutoConsoleVariable<float> CVarChatbotConnectionIdleTimeoutSeconds(
+    TEXT("Chatbot.ConnectionIdleTimeoutSeconds"),
+    60.0f,
+    TEXT("How long the LLM host keeps an idle connection open. Requests within this time of the last completed one count as reused; keep-alive pings at half of it.\n"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarChatbotKeepAliveWindowSeconds(
+    TEXT("Chatbot.KeepAliveWindowSeconds"),
+    300.0f,
+    TEXT("How long after WarmUpConnection (or the last chat request) idle keep-alive pings continue. 0 disables keep-alive.\n"),
+    ECVF_Default);
+
+// 按主机记录最近一次完成的请求，估算连接复用率（UE 的 HTTP 层不暴露 curl 的建连次数）
+namespace ChatbotConnection
+{
+    static FCriticalSection Mutex;
+    static TMap<FString, double> LastCompleted;
+    static int32 NumRequests = 0;
+    static int32 NumReused = 0;
+
+    static bool IsWarm(const FString& Host)
+    {
+        FScopeLock Lock(&Mutex);
+        const double* Last = LastCompleted.Find(Host);
+        return Last && FPlatformTime::Seconds() - *Last < CVarChatbotConnectionIdleTimeoutSeconds.GetValueOnAnyThread();
+    }
+
+    static void NoteRequest(const FString& Host)
+    {
+        const bool bWarm = IsWarm(Host);
+        FScopeLock Lock(&Mutex);
+        ++NumRequests;
+        NumReused += bWarm ? 1 : 0;
+    }
+
+    static void NoteCompleted(const FString& Host, bool bConnected)
+    {
+        FScopeLock Lock(&Mutex);
+        if (bConnected)
+        {
+            LastCompleted.Add(Host, FPlatformTime::Seconds());
+        }
+        else
+        {
+            LastCompleted.Remove(Host);
+        }
+    }
+
+    // 保活按主机共享：多个客户端指向同一主机时只有一个 ticker，同一时刻最多一个 HEAD，失败后退避
+    struct FKeepAlive
+    {
+        FString Url;
+        double Until = 0.0;
+        double NextAttempt = 0.0;
+        double Backoff = 0.0;
+        bool bInFlight = false;
+    };
+
+    static constexpr double MinKeepAliveBackoffSeconds = 5.0;
+    static constexpr double MaxKeepAliveBackoffSeconds = 60.0;
+
+    static TMap<FString, FKeepAlive> KeepAlives;
+    static FTSTicker::FDelegateHandle KeepAliveTicker;
+
+    static void SendKeepAlive(const FString& Host)
+    {
+        FString Url;
+        {
+            FScopeLock Lock(&Mutex);
+            FKeepAlive* State = KeepAlives.Find(Host);
+            if (!State || State->bInFlight) return;
+            State->bInFlight = true;
+            Url = State->Url;
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+
+        // 不带 Authorization，任何状态码都说明连接已建立
+        auto Req = FHttpModule::Get().CreateRequest();
+        Req->SetURL(Url);
+        Req->SetVerb(TEXT("HEAD"));
+        Req->SetTimeout(5.0f);
+        Req->OnProcessRequestComplete().BindLambda([Host, StartTime](FHttpRequestPtr, FHttpResponsePtr Resp, bool bOk)
+        {
+            const bool bConnected = bOk && Resp.IsValid();
+            NoteCompleted(Host, bConnected);
+            {
+                FScopeLock Lock(&Mutex);
+                if (FKeepAlive* State = KeepAlives.Find(Host))
+                {
+                    // 主机不可达时按 5s、10s、20s… 退避，不再每秒发一个 HEAD
+                    State->bInFlight = false;
+                    State->Backoff = bConnected ? 0.0 : FMath::Clamp(State->Backoff * 2.0, MinKeepAliveBackoffSeconds, MaxKeepAliveBackoffSeconds);
+                    State->NextAttempt = FPlatformTime::Seconds() + State->Backoff;
+                }
+            }
+            UE_LOG(LogTemp, Verbose, TEXT("[Chatbot] keep-alive %s: %s in %.0f ms"), *Host,
+                bConnected ? TEXT("ok") : TEXT("failed"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        });
+        Req->ProcessRequest();
+    }
+
+    static bool TickKeepAlive(float DeltaTime)
+    {
+        // 空闲超过一半超时就 ping 一次，连接一直留在池里
+        const double Now = FPlatformTime::Seconds();
+        const double PingAfter = 0.5 * CVarChatbotConnectionIdleTimeoutSeconds.GetValueOnGameThread();
+        TArray<FString, TInlineAllocator<4>> ToPing;
+        {
+            FScopeLock Lock(&Mutex);
+            for (auto It = KeepAlives.CreateIterator(); It; ++It)
+            {
+                const FKeepAlive& State = It.Value();
+                if (State.bInFlight) continue;
+                if (Now > State.Until)
+                {
+                    It.RemoveCurrent();
+                    continue;
+                }
+                if (Now >= State.NextAttempt && Now - LastCompleted.FindRef(It.Key()) > PingAfter)
+                {
+                    ToPing.Add(It.Key());
+                }
+            }
+            if (KeepAlives.Num() == 0)
+            {
+                KeepAliveTicker.Reset();
+                return false;
+            }
+        }
+
+        for (const FString& Host : ToPing)
+        {
+            SendKeepAlive(Host);
+        }
+        return true;
+    }
+
+    // 打开或顺延 Url 所在主机的保活窗口，连接不热时立即 ping 一次（退避中或已有 HEAD 在途时不发）；仅 GameThread
+    static void StartKeepAlive(const FString& Url, float Window)
+    {
+        const FString Host = FPlatformHttp::GetUrlDomain(Url);
+        const bool bWarm = IsWarm(Host);
+        bool bPingNow = false;
+        {
+            FScopeLock Lock(&Mutex);
+            FKeepAlive& State = KeepAlives.FindOrAdd(Host);
+            State.Url = Url;
+            State.Until = FMath::Max(State.Until, FPlatformTime::Seconds() + FMath::Max(0.0f, Window));
+            bPingNow = !bWarm && !State.bInFlight && FPlatformTime::Seconds() >= State.NextAttempt;
+        }
+
+        if (Window > 0.0f && !KeepAliveTicker.IsValid())
+        {
+            KeepAliveTicker = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickKeepAlive), 1.0f);
+        }
+        if (bPingNow)
+        {
+            SendKeepAlive(Host);
+        }
+    }
+
+    // 对话进行中顺延保活窗口，只对已经预热过的主机
+    static void ExtendKeepAlive(const FString& Host, float Window)
+    {
+        FScopeLock Lock(&Mutex);
+        if (FKeepAlive* State = KeepAlives.Find(Host))
+        {
+            State->Until = FMath::Max(State->Until, FPlatformTime::Seconds() + Window);
+        }
+    }
+}
 
 static TSharedPtr<FJsonObject> MakeMsg(const FString& Role, const FString& Content)
 {
@@ -17,6 +193,26 @@ static TSharedPtr<FJsonObject> MakeMsg(const FString& Role, const FString& Conte
     return Obj;
 }
 
+void UChatbotClient::PostInitProperties()
+{
+    Super::PostInitProperties();
+    if (ApiKey.IsEmpty())
+    {
+        ApiKey = FPlatformMisc::GetEnvironmentVariable(TEXT("DEEPSEEK_API_KEY"));
+    }
+}
+
+float UChatbotClient::GetConnectionReuseRate()
+{
+    FScopeLock Lock(&ChatbotConnection::Mutex);
+    return ChatbotConnection::NumRequests > 0 ? float(ChatbotConnection::NumReused) / ChatbotConnection::NumRequests : 0.0f;
+}
+
+void UChatbotClient::WarmUpConnection()
+{
+    ChatbotConnection::StartKeepAlive(BaseUrl, CVarChatbotKeepAliveWindowSeconds.GetValueOnGameThread());
+}
+
 // ======== 你已有的非流式 SendChat 保持原样 ========
 void UChatbotClient::SendChat(const TArray<FString>& Roles, const TArray<FString>& Contents,
                               float Temperature,
@@ -35,6 +231,7 @@ void UChatbotClient::SendChat(const TArray<FString>& Roles, const TArray<FString
     }
 
     const FString Url = BaseUrl + TEXT("/chat/completions");
+    const FString Host = FPlatformHttp::GetUrlDomain(BaseUrl);
 
     auto Req = FHttpModule::Get().CreateRequest();
     Req->SetURL(Url);
@@ -92,8 +289,9 @@ void UChatbotClient::SendChat(const TArray<FString>& Roles, const TArray<FString
     Req->SetContentAsString(Body);
 
     Req->OnProcessRequestComplete().BindLambda(
-        [OnOk, OnFail](FHttpRequestPtr, FHttpResponsePtr Resp, bool bOk)
+        [OnOk, OnFail, Host](FHttpRequestPtr, FHttpResponsePtr Resp, bool bOk)
         {
+            ChatbotConnection::NoteCompleted(Host, bOk && Resp.IsValid());
             if (!bOk || !Resp.IsValid())
             {
                 AsyncTask(ENamedThreads::GameThread, [OnFail]{ OnFail.ExecuteIfBound(TEXT("HTTP failed")); });
@@ -131,6 +329,7 @@ void UChatbotClient::SendChat(const TArray<FString>& Roles, const TArray<FString
         });
 
     Req->SetTimeout(30.0f);
+    ChatbotConnection::NoteRequest(Host);
     Req->ProcessRequest();
 }
 // ======== 新增：流式（SSE）- 使用 Ticker 轮询响应缓冲 ========
@@ -144,6 +343,7 @@ void UChatbotClient::SendChatStream(const TArray<FString>& Roles, const TArray<F
     { AsyncTask(ENamedThreads::GameThread, [OnFail]{ OnFail.ExecuteIfBound(TEXT("Invalid messages")); }); return; }
 
     const FString Url = BaseUrl + TEXT("/chat/completions");
+    const FString Host = FPlatformHttp::GetUrlDomain(BaseUrl);
     TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Req = FHttpModule::Get().CreateRequest();
     Req->SetURL(Url);
     Req->SetVerb(TEXT("POST"));
@@ -271,8 +471,10 @@ void UChatbotClient::SendChatStream(const TArray<FString>& Roles, const TArray<F
     });
 
     // 收尾：移除 Ticker 并可选解析完整体
-    Req->OnProcessRequestComplete().BindLambda([State, OnDone, OnFail](FHttpRequestPtr, FHttpResponsePtr Resp, bool bOk)
+    Req->OnProcessRequestComplete().BindLambda([State, OnDone, OnFail, Host](FHttpRequestPtr, FHttpResponsePtr Resp, bool bOk)
     {
+        ChatbotConnection::NoteCompleted(Host, bOk && Resp.IsValid());
+
         if (State->bTickerActive)
         {
             FTSTicker::GetCoreTicker().RemoveTicker(State->TickHandle);
@@ -305,5 +507,7 @@ void UChatbotClient::SendChatStream(const TArray<FString>& Roles, const TArray<F
     });
 
     Req->SetTimeout(0);
+    ChatbotConnection::NoteRequest(Host);
+    ChatbotConnection::ExtendKeepAlive(Host, CVarChatbotKeepAliveWindowSeconds.GetValueOnGameThread());
     Req->ProcessRequest();
 }
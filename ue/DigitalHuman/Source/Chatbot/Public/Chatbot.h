@@ -20,9 +20,22 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config, Category="Chatbot")
 	FString BaseUrl = TEXT("https://api.deepseek.com");
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Chatbot")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config, Category="Chatbot")
 	FString Model = TEXT("deepseek-chat");
 
+	// Config 里没有 ApiKey 时读环境变量 DEEPSEEK_API_KEY（无界面/服务器部署用）
+	virtual void PostInitProperties() override;
+
+	// 预热到 BaseUrl 的连接（HEAD，建好 DNS/TCP/TLS 留在连接池里），
+	// 之后 Chatbot.KeepAliveWindowSeconds 内空闲时定期再 HEAD 一次，避免第一句对话付握手的钱；
+	// 保活按主机共享，多个客户端指向同一 BaseUrl 也只有一路 HEAD
+	UFUNCTION(BlueprintCallable, Category="Chatbot")
+	void WarmUpConnection();
+
+	// 对话请求里连接仍在空闲超时内（可复用）的比例，0~1；还没有请求时为 0
+	UFUNCTION(BlueprintCallable, Category="Chatbot")
+	static float GetConnectionReuseRate();
+
 	UFUNCTION(BlueprintCallable, Category="Chatbot")
 	void SendChat(const TArray<FString>& Roles, const TArray<FString>& Contents,
 				  float Temperature,
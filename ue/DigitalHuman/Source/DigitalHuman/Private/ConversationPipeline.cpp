@@ -0,0 +1,262 @@
+// ConversationPipeline.cpp
+#include "ConversationPipeline.h"
+
+#include "Chatbot.h"
+#include "ConversationStateSubsystem.h"
+#include "TextToFace.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogConversationPipeline, Log, All);
+
+static TAutoConsoleVariable<float> CVarConversationTurnIdleGraceSeconds(
+	TEXT("Conversation.TurnIdleGraceSeconds"),
+	0.5f,
+	TEXT("How long a pipeline must stay idle (no LLM stream, empty TTS queue, no ACE playback) before its turn counts as finished.\n"),
+	ECVF_Default);
+
+void UConversationPipeline::Init(const FConversationCharacterConfig& InConfig, UChatbotClient* InChatbot, UTextToFaceEngine* InEngine)
+{
+	Config = InConfig;
+
+	// Key / BaseUrl 来自 Config 或环境变量，这里只覆盖角色相关的设置
+	Chatbot = InChatbot ? InChatbot : NewObject<UChatbotClient>(this);
+	if (!InChatbot && !Config.ChatModel.IsEmpty())
+	{
+		Chatbot->Model = Config.ChatModel;
+	}
+
+	Engine = InEngine ? InEngine : NewObject<UTextToFaceEngine>(this);
+	if (!InEngine)
+	{
+		if (!Config.VoiceId.IsEmpty()) Engine->SetVoiceId(Config.VoiceId);
+		if (!Config.TtsModelId.IsEmpty()) Engine->SetModelId(Config.TtsModelId);
+	}
+	Engine->OnSpeakingChanged.AddUniqueDynamic(this, &UConversationPipeline::HandleSpeakingChanged);
+
+	if (UConversationStateSubsystem* States = UConversationStateSubsystem::Get(this))
+	{
+		States->OnStateChanged.AddUniqueDynamic(this, &UConversationPipeline::HandleStateChanged);
+	}
+}
+
+bool UConversationPipeline::Submit(const FString& UserText)
+{
+	if (UserText.IsEmpty() || !Chatbot || !Engine) return false;
+
+	StreamBuffer.Reset();
+	SubmitTimeSec = FPlatformTime::Seconds();
+	bFirstDeltaLogged = false;
+	bFirstSpeechLogged = false;
+	bTurnActive = true;
+	bSpeechStarted = false;
+	bDraining = false;
+	SetStreamingInFlight(true);
+
+	TArray<FString> Roles, Contents;
+	Roles.Add(TEXT("system")); Contents.Add(Config.SystemPrompt);
+	Roles.Add(TEXT("user"));   Contents.Add(UserText);
+
+	FOnChatDelta OnDelta; OnDelta.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UConversationPipeline, HandleChatDelta));
+	FOnChatResponse OnDone; OnDone.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UConversationPipeline, HandleChatDone));
+	FOnChatError OnErr; OnErr.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UConversationPipeline, HandleChatError));
+
+	Chatbot->SendChatStream(Roles, Contents, Config.Temperature, OnDelta, OnDone, OnErr);
+	return true;
+}
+
+void UConversationPipeline::SetAvatar(AActor* InAvatar)
+{
+	Avatar = InAvatar;
+}
+
+AActor* UConversationPipeline::ResolveAvatar()
+{
+	if (AActor* Cached = Avatar.Get()) return Cached;
+	if (Config.AvatarTag.IsNone()) return nullptr;
+
+	TArray<AActor*> Found;
+	UGameplayStatics::GetAllActorsWithTag(this, Config.AvatarTag, Found);
+	if (Found.Num() > 0)
+	{
+		Avatar = Found[0];
+		return Found[0];
+	}
+	return nullptr;
+}
+
+bool UConversationPipeline::IsSpeaking() const
+{
+	return Engine && Engine->IsSpeaking();
+}
+
+void UConversationPipeline::HandleChatDelta(const FString& Delta)
+{
+	if (bDraining) return;
+
+	if (!bFirstDeltaLogged)
+	{
+		bFirstDeltaLogged = true;
+		UE_LOG(LogConversationPipeline, Log, TEXT("[%s] first token after %.0f ms"),
+			*Config.CharacterId.ToString(), (FPlatformTime::Seconds() - SubmitTimeSec) * 1000.0);
+	}
+
+	StreamBuffer += Delta;
+	if (ReachedBoundary())
+	{
+		FlushBuffer();
+	}
+}
+
+void UConversationPipeline::HandleChatDone(const FString& Full)
+{
+	UE_LOG(LogConversationPipeline, Verbose, TEXT("[%s] chat done: %s"), *Config.CharacterId.ToString(), *Full);
+	if (!bDraining)
+	{
+		FlushBuffer();
+	}
+	SetStreamingInFlight(false);
+	OnTurnEvent.Broadcast(this, EConversationTurnEvent::LLMFinished);
+	MaybeFinishTurn();
+}
+
+void UConversationPipeline::HandleChatError(const FString& Error)
+{
+	UE_LOG(LogConversationPipeline, Error, TEXT("[%s] chatbot error: %s"), *Config.CharacterId.ToString(), *Error);
+	if (!bDraining)
+	{
+		FlushBuffer();
+	}
+	SetStreamingInFlight(false);
+	OnTurnEvent.Broadcast(this, EConversationTurnEvent::LLMFinished);
+	MaybeFinishTurn();
+}
+
+void UConversationPipeline::HandleSpeakingChanged(bool bSpeaking)
+{
+	if (bSpeaking && !bFirstSpeechLogged)
+	{
+		bFirstSpeechLogged = true;
+		UE_LOG(LogConversationPipeline, Log, TEXT("[%s] TTS started after %.0f ms"),
+			*Config.CharacterId.ToString(), (FPlatformTime::Seconds() - SubmitTimeSec) * 1000.0);
+	}
+
+	if (UConversationStateSubsystem* States = UConversationStateSubsystem::Get(this))
+	{
+		States->SetSpeaking(ResolveAvatar(), bSpeaking);
+	}
+	if (!bSpeaking)
+	{
+		MaybeFinishTurn();
+	}
+}
+
+void UConversationPipeline::HandleStateChanged(AActor* InAvatar, const FConversationState& State)
+{
+	if ((!bTurnActive && !bDraining) || InAvatar == nullptr || InAvatar != Avatar.Get()) return;
+
+	if (bTurnActive && State.bAnimating && !bSpeechStarted)
+	{
+		bSpeechStarted = true;
+		UE_LOG(LogConversationPipeline, Log, TEXT("[%s] speech started after %.0f ms"),
+			*Config.CharacterId.ToString(), (FPlatformTime::Seconds() - SubmitTimeSec) * 1000.0);
+		OnTurnEvent.Broadcast(this, EConversationTurnEvent::SpeechStarted);
+	}
+	else if (!State.bAnimating)
+	{
+		MaybeFinishTurn();
+	}
+}
+
+bool UConversationPipeline::IsIdle() const
+{
+	if (bStreamingInFlight || IsSpeaking()) return false;
+
+	const UConversationStateSubsystem* States = UConversationStateSubsystem::Get(this);
+	const AActor* A = Avatar.Get();
+	return !(States && A && States->GetState(A).bAnimating);
+}
+
+void UConversationPipeline::MaybeFinishTurn()
+{
+	if ((!bTurnActive && !bDraining) || FinishCheckHandle.IsValid() || !IsIdle()) return;
+
+	const float Grace = FMath::Max(0.0f, CVarConversationTurnIdleGraceSeconds.GetValueOnGameThread());
+	FinishCheckHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+	{
+		FinishCheckHandle.Reset();
+		if ((bTurnActive || bDraining) && IsIdle())
+		{
+			bTurnActive = false;
+			bDraining = false;
+			OnTurnEvent.Broadcast(this, EConversationTurnEvent::Finished);
+		}
+		return false;
+	}), Grace);
+}
+
+void UConversationPipeline::AbortTurn()
+{
+	if (FinishCheckHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(FinishCheckHandle);
+		FinishCheckHandle.Reset();
+	}
+	if (!bTurnActive) return;
+
+	UE_LOG(LogConversationPipeline, Warning, TEXT("[%s] turn aborted after %.0f ms"),
+		*Config.CharacterId.ToString(), (FPlatformTime::Seconds() - SubmitTimeSec) * 1000.0);
+	bTurnActive = false;
+	bSpeechStarted = false;
+	bDraining = true;
+	StreamBuffer.Reset();
+
+	// 还没轮到的句子不再播，正在合成/播放的一句播完为止
+	if (Engine)
+	{
+		Engine->ClearQueue();
+	}
+	MaybeFinishTurn();
+}
+
+bool UConversationPipeline::ReachedBoundary() const
+{
+	if (StreamBuffer.IsEmpty()) return false;
+
+	int32 Index = INDEX_NONE;
+	return Config.SentenceBoundaries.FindChar(StreamBuffer[StreamBuffer.Len() - 1], Index);
+}
+
+void UConversationPipeline::FlushBuffer()
+{
+	FString ToSpeak = StreamBuffer;
+	ToSpeak.TrimStartAndEndInline();
+	StreamBuffer.Reset();
+	if (ToSpeak.IsEmpty())
+	{
+		return;
+	}
+
+	AActor* Target = ResolveAvatar();
+	if (!Target || !Engine)
+	{
+		UE_LOG(LogConversationPipeline, Warning, TEXT("[%s] unable to flush: avatar (tag %s) not found"),
+			*Config.CharacterId.ToString(), *Config.AvatarTag.ToString());
+		return;
+	}
+
+	UE_LOG(LogConversationPipeline, Verbose, TEXT("[%s] flushing to TextToFace: %s"), *Config.CharacterId.ToString(), *ToSpeak);
+	Engine->TextToFaceStreamAppend(ToSpeak, Target);
+	Engine->StartTTSStreamIfStopped();
+}
+
+void UConversationPipeline::SetStreamingInFlight(bool bInFlight)
+{
+	bStreamingInFlight = bInFlight;
+	if (UConversationStateSubsystem* States = UConversationStateSubsystem::Get(this))
+	{
+		States->SetThinking(ResolveAvatar(), bInFlight);
+	}
+}
@@ -0,0 +1,578 @@
+// ConversationPipelineSubsystem.cpp
+#include "ConversationPipelineSubsystem.h"
+
+#include "Chatbot.h"
+#include "ConversationStateSubsystem.h"
+#include "TextToFace.h"
+#include "TextToFaceAdmission.h"
+#include "WebInterfaceSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogConversationPipelineSubsystem, Log, All);
+
+static TAutoConsoleVariable<int32> CVarConversationMaxConcurrentLLMStreams(
+	TEXT("Conversation.MaxConcurrentLLMStreams"),
+	4,
+	TEXT("Maximum number of LLM streams the session scheduler keeps open across all characters.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarConversationMaxQueuedTurnsPerSession(
+	TEXT("Conversation.MaxQueuedTurnsPerSession"),
+	8,
+	TEXT("Inputs beyond this many pending turns in one session are rejected.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarConversationMaxSessions(
+	TEXT("Conversation.MaxSessions"),
+	32,
+	TEXT("Input that would open a session beyond this many is rejected, so one client cannot flood the round-robin with fake sessions.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarConversationTurnTimeoutSeconds(
+	TEXT("Conversation.TurnTimeoutSeconds"),
+	120.0f,
+	TEXT("A turn still running after this long is counted as failed and its LLM slot is released.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarConversationSessionIdleSeconds(
+	TEXT("Conversation.SessionIdleSeconds"),
+	600.0f,
+	TEXT("Sessions with no input for this long are dropped together with their stats.\n"),
+	ECVF_Default);
+
+namespace
+{
+	constexpr int32 MaxLatencySamples = 256;
+
+	float LatencyPercentile(const TArray<float>& Samples, float Percentile)
+	{
+		if (Samples.Num() == 0) return 0.0f;
+
+		TArray<float> Sorted = Samples;
+		Sorted.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Index];
+	}
+}
+
+UConversationPipelineSubsystem* UConversationPipelineSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject) return nullptr;
+
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+	return GI ? GI->GetSubsystem<UConversationPipelineSubsystem>() : nullptr;
+}
+
+void UConversationPipelineSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UConversationStateSubsystem>();
+
+	if (bRouteWebInput || bWarmUpOnConnect)
+	{
+		if (UWebInterfaceSubsystem* Web = Collection.InitializeDependency<UWebInterfaceSubsystem>())
+		{
+			if (bRouteWebInput)
+			{
+				Web->OnSessionInputReceived.AddUniqueDynamic(this, &UConversationPipelineSubsystem::HandleWebInput);
+				Web->OnSessionClosed.AddUniqueDynamic(this, &UConversationPipelineSubsystem::HandleWebSessionClosed);
+			}
+			if (bWarmUpOnConnect)
+			{
+				Web->OnPlayerConnected.AddUniqueDynamic(this, &UConversationPipelineSubsystem::HandlePlayerConnected);
+			}
+		}
+	}
+
+	SessionTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UConversationPipelineSubsystem::TickSessions), 1.0f);
+
+	UE_LOG(LogConversationPipelineSubsystem, Log, TEXT("Conversation pipeline ready: %d configured character(s), default '%s', web input %s"),
+		Characters.Num(), *ResolveCharacterId(NAME_None).ToString(), bRouteWebInput ? TEXT("routed") : TEXT("not routed"));
+}
+
+void UConversationPipelineSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(SessionTickerHandle);
+	SessionTickerHandle.Reset();
+
+	if (UWebInterfaceSubsystem* Web = GetGameInstance()->GetSubsystem<UWebInterfaceSubsystem>())
+	{
+		Web->OnSessionInputReceived.RemoveAll(this);
+		Web->OnSessionClosed.RemoveAll(this);
+		Web->OnPlayerConnected.RemoveAll(this);
+	}
+	for (const TPair<FName, TObjectPtr<UConversationPipeline>>& Pair : Pipelines)
+	{
+		if (Pair.Value) Pair.Value->OnTurnEvent.RemoveAll(this);
+	}
+	Pipelines.Reset();
+	Sessions.Reset();
+	SessionOrder.Reset();
+	ActiveSessionByCharacter.Reset();
+	DrainingLLMSlots.Reset();
+	ActiveLLMStreams = 0;
+	Super::Deinitialize();
+}
+
+FName UConversationPipelineSubsystem::ResolveCharacterId(FName CharacterId) const
+{
+	if (!CharacterId.IsNone()) return CharacterId;
+	if (!DefaultCharacter.IsNone()) return DefaultCharacter;
+	return Characters.Num() > 0 ? Characters[0].CharacterId : FName(TEXT("Default"));
+}
+
+FConversationCharacterConfig UConversationPipelineSubsystem::FindConfig(FName CharacterId) const
+{
+	for (const FConversationCharacterConfig& Character : Characters)
+	{
+		if (Character.CharacterId == CharacterId)
+		{
+			return Character;
+		}
+	}
+
+	FConversationCharacterConfig Fallback;
+	Fallback.CharacterId = CharacterId;
+	return Fallback;
+}
+
+UConversationPipeline* UConversationPipelineSubsystem::GetPipeline(FName CharacterId)
+{
+	const FName Id = ResolveCharacterId(CharacterId);
+	if (TObjectPtr<UConversationPipeline>* Existing = Pipelines.Find(Id))
+	{
+		return *Existing;
+	}
+	return CreatePipeline(Id, nullptr, nullptr);
+}
+
+UConversationPipeline* UConversationPipelineSubsystem::CreatePipeline(FName CharacterId, UChatbotClient* InChatbot, UTextToFaceEngine* InEngine)
+{
+	const FName Id = ResolveCharacterId(CharacterId);
+	UConversationPipeline* Pipeline = NewObject<UConversationPipeline>(this);
+	Pipeline->Init(FindConfig(Id), InChatbot, InEngine);
+	Pipeline->OnTurnEvent.AddUniqueDynamic(this, &UConversationPipelineSubsystem::HandleTurnEvent);
+	if (TObjectPtr<UConversationPipeline>* Existing = Pipelines.Find(Id))
+	{
+		if (*Existing) (*Existing)->OnTurnEvent.RemoveAll(this);
+	}
+	Pipelines.Add(Id, Pipeline);
+	return Pipeline;
+}
+
+bool UConversationPipelineSubsystem::Submit(FName CharacterId, const FString& UserText)
+{
+	const FName Id = ResolveCharacterId(CharacterId);
+	return EnqueueTurn(Id.ToString(), Id, UserText);
+}
+
+bool UConversationPipelineSubsystem::IsKnownCharacter(FName CharacterId) const
+{
+	if (CharacterId.IsNone()) return false;
+	if (Pipelines.Contains(CharacterId) || CharacterId == ResolveCharacterId(NAME_None)) return true;
+	return Characters.ContainsByPredicate([CharacterId](const FConversationCharacterConfig& Character)
+	{
+		return Character.CharacterId == CharacterId;
+	});
+}
+
+FName UConversationPipelineSubsystem::AssignCharacter(FName Hint) const
+{
+	// 角色 Id 可能来自前端，只认配置里有的，避免为任意 Id 创建流水线
+	if (IsKnownCharacter(Hint)) return Hint;
+	if (!Hint.IsNone())
+	{
+		UE_LOG(LogConversationPipelineSubsystem, Warning, TEXT("Unknown character '%s', assigning by load"), *Hint.ToString());
+	}
+	if (Characters.Num() == 0) return ResolveCharacterId(NAME_None);
+
+	// 新会话分给会话数最少的角色，平手时按配置顺序
+	TMap<FName, int32> Load;
+	for (const TPair<FString, FConversationSession>& Pair : Sessions)
+	{
+		++Load.FindOrAdd(Pair.Value.CharacterId);
+	}
+
+	FName Best = ResolveCharacterId(NAME_None);
+	int32 BestLoad = Load.FindRef(Best);
+	for (const FConversationCharacterConfig& Character : Characters)
+	{
+		const int32 CharacterLoad = Load.FindRef(Character.CharacterId);
+		if (CharacterLoad < BestLoad)
+		{
+			Best = Character.CharacterId;
+			BestLoad = CharacterLoad;
+		}
+	}
+	return Best;
+}
+
+bool UConversationPipelineSubsystem::EnqueueTurn(const FString& SessionId, FName CharacterId, const FString& UserText)
+{
+	if (UserText.IsEmpty()) return false;
+
+	FConversationSession* Session = Sessions.Find(SessionId);
+	if (!Session)
+	{
+		const int32 MaxSessions = FMath::Max(1, CVarConversationMaxSessions.GetValueOnGameThread());
+		if (Sessions.Num() >= MaxSessions)
+		{
+			UE_LOG(LogConversationPipelineSubsystem, Warning, TEXT("Too many sessions (%d), rejecting new session '%s'"), Sessions.Num(), *SessionId);
+			return false;
+		}
+		Session = &Sessions.Add(SessionId);
+		Session->CharacterId = AssignCharacter(CharacterId);
+		SessionOrder.Add(SessionId);
+		UE_LOG(LogConversationPipelineSubsystem, Log, TEXT("Session '%s' -> character '%s'"), *SessionId, *Session->CharacterId.ToString());
+	}
+	else if (!CharacterId.IsNone() && Session->CharacterId != CharacterId)
+	{
+		// 前端切换了角色：后续轮次交给新角色，进行中的一轮照常结束；未配置的角色忽略
+		if (IsKnownCharacter(CharacterId))
+		{
+			Session->CharacterId = CharacterId;
+		}
+		else
+		{
+			UE_LOG(LogConversationPipelineSubsystem, Warning, TEXT("Session '%s': ignoring unknown character '%s'"), *SessionId, *CharacterId.ToString());
+		}
+	}
+
+	const int32 MaxQueued = FMath::Max(1, CVarConversationMaxQueuedTurnsPerSession.GetValueOnGameThread());
+	if (Session->Pending.Num() >= MaxQueued)
+	{
+		UE_LOG(LogConversationPipelineSubsystem, Warning, TEXT("Session '%s' queue full (%d), dropping input"), *SessionId, Session->Pending.Num());
+		return false;
+	}
+
+	Session->Pending.Add({ UserText, FPlatformTime::Seconds() });
+	Session->LastActivityTime = FPlatformTime::Seconds();
+	Dispatch();
+	return true;
+}
+
+void UConversationPipelineSubsystem::EndSession(const FString& SessionId)
+{
+	FConversationSession* Session = Sessions.Find(SessionId);
+	if (!Session) return;
+
+	Session->Pending.Reset();
+	if (Session->bActive)
+	{
+		// 进行中的一轮还要回收名额，结束后由 TickSessions 清掉
+		Session->LastActivityTime = 0.0;
+		return;
+	}
+	Sessions.Remove(SessionId);
+	SessionOrder.Remove(SessionId);
+}
+
+void UConversationPipelineSubsystem::Dispatch()
+{
+	if (bDispatching) return;
+	TGuardValue<bool> Guard(bDispatching, true);
+
+	const int32 MaxLLM = FMath::Max(1, CVarConversationMaxConcurrentLLMStreams.GetValueOnGameThread());
+	bool bStarted = true;
+	while (bStarted && ActiveLLMStreams < MaxLLM && SessionOrder.Num() > 0)
+	{
+		bStarted = false;
+		const int32 Num = SessionOrder.Num();
+		for (int32 Offset = 0; Offset < Num; ++Offset)
+		{
+			const int32 Index = (NextSessionIndex + Offset) % Num;
+			const FString& SessionId = SessionOrder[Index];
+			FConversationSession& Session = Sessions.FindChecked(SessionId);
+			if (Session.bActive || Session.Pending.Num() == 0 || ActiveSessionByCharacter.Contains(Session.CharacterId))
+			{
+				continue;
+			}
+
+			// 同一角色的流水线上一轮还没收尾，或超时放弃的一轮还没播完、LLM 流还没结束，也要等
+			const TObjectPtr<UConversationPipeline>* Pipeline = Pipelines.Find(Session.CharacterId);
+			if (Pipeline && *Pipeline && ((*Pipeline)->IsTurnActive() || (*Pipeline)->IsDraining()))
+			{
+				continue;
+			}
+
+			// 下一次从它后面的会话开始，保证轮转公平
+			NextSessionIndex = (Index + 1) % Num;
+			bStarted = true;
+			StartTurn(SessionId, Session);
+			break;
+		}
+	}
+}
+
+bool UConversationPipelineSubsystem::StartTurn(const FString& SessionId, FConversationSession& Session)
+{
+	const FPendingTurn Turn = Session.Pending[0];
+	Session.Pending.RemoveAt(0);
+
+	UConversationPipeline* Pipeline = GetPipeline(Session.CharacterId);
+	Session.bActive = true;
+	Session.bHoldsLLMSlot = true;
+	Session.bSpeechStarted = false;
+	Session.ActiveEnqueueTime = Turn.EnqueueTime;
+	Session.ActiveStartTime = FPlatformTime::Seconds();
+	ActiveSessionByCharacter.Add(Session.CharacterId, SessionId);
+	++ActiveLLMStreams;
+
+	UE_LOG(LogConversationPipelineSubsystem, Verbose, TEXT("Session '%s' turn start on '%s' after %.0f ms queued"),
+		*SessionId, *Session.CharacterId.ToString(), (Session.ActiveStartTime - Turn.EnqueueTime) * 1000.0);
+
+	if (!Pipeline || !Pipeline->Submit(Turn.Text))
+	{
+		UE_LOG(LogConversationPipelineSubsystem, Warning, TEXT("Session '%s': character '%s' rejected the turn"), *SessionId, *Session.CharacterId.ToString());
+		FinishTurn(Session, false);
+		return false;
+	}
+	return true;
+}
+
+void UConversationPipelineSubsystem::FinishTurn(FConversationSession& Session, bool bSucceeded)
+{
+	if (!Session.bActive) return;
+
+	if (Session.bHoldsLLMSlot)
+	{
+		Session.bHoldsLLMSlot = false;
+		--ActiveLLMStreams;
+	}
+	Session.bActive = false;
+	ActiveSessionByCharacter.Remove(Session.CharacterId);
+	if (bSucceeded)
+	{
+		++Session.CompletedTurns;
+	}
+	else
+	{
+		++Session.FailedTurns;
+	}
+}
+
+void UConversationPipelineSubsystem::HandleTurnEvent(UConversationPipeline* Pipeline, EConversationTurnEvent Event)
+{
+	const FName* CharacterId = Pipelines.FindKey(Pipeline);
+	if (CharacterId && Event == EConversationTurnEvent::LLMFinished && DrainingLLMSlots.Remove(*CharacterId) > 0)
+	{
+		// 超时放弃的一轮的 LLM 流到这里才真正关闭
+		--ActiveLLMStreams;
+	}
+
+	const FString* SessionId = CharacterId ? ActiveSessionByCharacter.Find(*CharacterId) : nullptr;
+	FConversationSession* Session = SessionId ? Sessions.Find(*SessionId) : nullptr;
+	if (!Session || !Session->bActive)
+	{
+		// 绕过调度直接调 Pipeline->Submit 的轮次，或已超时释放的轮次；名额或角色可能刚空出来
+		Dispatch();
+		return;
+	}
+
+	switch (Event)
+	{
+	case EConversationTurnEvent::LLMFinished:
+		if (Session->bHoldsLLMSlot)
+		{
+			Session->bHoldsLLMSlot = false;
+			--ActiveLLMStreams;
+		}
+		break;
+
+	case EConversationTurnEvent::SpeechStarted:
+		if (!Session->bSpeechStarted)
+		{
+			Session->bSpeechStarted = true;
+			const float LatencyMs = static_cast<float>((FPlatformTime::Seconds() - Session->ActiveEnqueueTime) * 1000.0);
+			if (Session->LatencyMs.Num() < MaxLatencySamples)
+			{
+				Session->LatencyMs.Add(LatencyMs);
+			}
+			else
+			{
+				Session->LatencyMs[Session->NextLatencySlot] = LatencyMs;
+				Session->NextLatencySlot = (Session->NextLatencySlot + 1) % MaxLatencySamples;
+			}
+		}
+		break;
+
+	case EConversationTurnEvent::Finished:
+		FinishTurn(*Session, Session->bSpeechStarted);
+		break;
+	}
+
+	Dispatch();
+}
+
+bool UConversationPipelineSubsystem::TickSessions(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Timeout = CVarConversationTurnTimeoutSeconds.GetValueOnGameThread();
+	const double IdleLimit = CVarConversationSessionIdleSeconds.GetValueOnGameThread();
+
+	bool bReleased = false;
+	for (int32 Index = SessionOrder.Num() - 1; Index >= 0; --Index)
+	{
+		const FString SessionId = SessionOrder[Index];
+		FConversationSession& Session = Sessions.FindChecked(SessionId);
+
+		if (Session.bActive && Timeout > 0.0 && Now - Session.ActiveStartTime > Timeout)
+		{
+			UE_LOG(LogConversationPipelineSubsystem, Warning, TEXT("Session '%s' turn on '%s' timed out after %.0f s"),
+				*SessionId, *Session.CharacterId.ToString(), Now - Session.ActiveStartTime);
+			if (TObjectPtr<UConversationPipeline>* Pipeline = Pipelines.Find(Session.CharacterId))
+			{
+				if (*Pipeline)
+				{
+					// LLM 流没法取消，名额留到它真正结束（LLMFinished）再还
+					if (Session.bHoldsLLMSlot && (*Pipeline)->IsThinking())
+					{
+						Session.bHoldsLLMSlot = false;
+						DrainingLLMSlots.Add(Session.CharacterId);
+					}
+					(*Pipeline)->AbortTurn();
+				}
+			}
+			FinishTurn(Session, false);
+			bReleased = true;
+		}
+
+		if (!Session.bActive && Session.Pending.Num() == 0 && Now - Session.LastActivityTime > IdleLimit)
+		{
+			Sessions.Remove(SessionId);
+			SessionOrder.RemoveAt(Index);
+		}
+	}
+
+	if (SessionOrder.Num() > 0)
+	{
+		NextSessionIndex %= SessionOrder.Num();
+	}
+	if (bReleased)
+	{
+		Dispatch();
+	}
+	return true;
+}
+
+TArray<FConversationSessionStats> UConversationPipelineSubsystem::GetSessionStats() const
+{
+	TArray<FConversationSessionStats> Result;
+	Result.Reserve(SessionOrder.Num());
+	for (const FString& SessionId : SessionOrder)
+	{
+		const FConversationSession& Session = Sessions.FindChecked(SessionId);
+		FConversationSessionStats& Stats = Result.AddDefaulted_GetRef();
+		Stats.SessionId = SessionId;
+		Stats.CharacterId = Session.CharacterId;
+		Stats.QueueDepth = Session.Pending.Num();
+		Stats.bActive = Session.bActive;
+		Stats.CompletedTurns = Session.CompletedTurns;
+		Stats.FailedTurns = Session.FailedTurns;
+		Stats.P50LatencyMs = LatencyPercentile(Session.LatencyMs, 0.50f);
+		Stats.P99LatencyMs = LatencyPercentile(Session.LatencyMs, 0.99f);
+	}
+	return Result;
+}
+
+void UConversationPipelineSubsystem::WarmUpConnections()
+{
+	TArray<FName> Ids;
+	for (const FConversationCharacterConfig& Character : Characters)
+	{
+		Ids.AddUnique(Character.CharacterId);
+	}
+	if (Ids.Num() == 0)
+	{
+		Ids.Add(ResolveCharacterId(NAME_None));
+	}
+
+	// 多个角色共用主机时只有第一次会真正发 HEAD，其余看到连接已热直接跳过
+	for (const FName& Id : Ids)
+	{
+		if (UConversationPipeline* Pipeline = GetPipeline(Id))
+		{
+			if (UChatbotClient* Chatbot = Pipeline->GetChatbot()) Chatbot->WarmUpConnection();
+			if (UTextToFaceEngine* Engine = Pipeline->GetEngine()) Engine->WarmUpConnection();
+		}
+	}
+}
+
+void UConversationPipelineSubsystem::HandlePlayerConnected(const FString& PlayerId)
+{
+	WarmUpConnections();
+}
+
+void UConversationPipelineSubsystem::HandleWebSessionClosed(const FString& SessionId)
+{
+	// 前端会话租约到期或播放端全部断开：丢掉它的排队输入，进行中的一轮照常结束
+	EndSession(SessionId);
+}
+
+void UConversationPipelineSubsystem::HandleWebInput(const FString& SessionId, const FString& Character, const FString& UserText)
+{
+	// 只查已有的名字，前端随便填的角色不会往 FName 表里加新条目
+	EnqueueTurn(SessionId, Character.IsEmpty() ? NAME_None : FName(*Character, FNAME_Find), UserText);
+}
+
+#if !UE_BUILD_SHIPPING
+// 无界面下直接发起一轮对话，用于服务器/-RenderOffscreen 部署的冒烟和延迟测试
+static FAutoConsoleCommandWithWorldAndArgs CmdConversationSubmit(
+	TEXT("Conversation.Submit"),
+	TEXT("Submit user text to a character's conversation pipeline without any UI. Args: <CharacterId|Default> <Text...>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UConversationPipelineSubsystem* Pipelines = UConversationPipelineSubsystem::Get(World);
+		if (!Pipelines || Args.Num() < 2)
+		{
+			UE_LOG(LogConversationPipelineSubsystem, Warning, TEXT("Usage: Conversation.Submit <CharacterId|Default> <Text...>"));
+			return;
+		}
+
+		const FName CharacterId = Args[0].Equals(TEXT("Default"), ESearchCase::IgnoreCase) ? NAME_None : FName(*Args[0]);
+		const FString Text = FString::Join(TArrayView<const FString>(Args).RightChop(1), TEXT(" "));
+		Pipelines->Submit(CharacterId, Text);
+	}));
+
+// 不等播放端连接，手动预热（配合本地 mock 服务器测连接复用率）
+static FAutoConsoleCommandWithWorldAndArgs CmdConversationWarmUp(
+	TEXT("Conversation.WarmUp"),
+	TEXT("Warm up and keep alive the LLM and TTS connections of every configured character, as done when a Pixel Streaming player connects."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UConversationPipelineSubsystem* Pipelines = UConversationPipelineSubsystem::Get(World))
+		{
+			Pipelines->WarmUpConnections();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs CmdConversationSessions(
+	TEXT("Conversation.Sessions"),
+	TEXT("Log per-session queue depth and end-to-end latency (p50/p99), plus global LLM/TTS/A2F admission usage."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UConversationPipelineSubsystem* Pipelines = UConversationPipelineSubsystem::Get(World);
+		if (!Pipelines) return;
+
+		FTextToFaceSlotGate& TTS = TextToFaceAdmission::TTSRequests();
+		FTextToFaceSlotGate& A2F = TextToFaceAdmission::A2FSessions();
+		UE_LOG(LogConversationPipelineSubsystem, Display, TEXT("LLM streams %d/%d, TTS requests %d active %d waiting, A2F sessions %d active %d waiting"),
+			Pipelines->GetActiveLLMStreams(), CVarConversationMaxConcurrentLLMStreams.GetValueOnGameThread(),
+			TTS.NumActive(), TTS.NumWaiting(), A2F.NumActive(), A2F.NumWaiting());
+		UE_LOG(LogConversationPipelineSubsystem, Display, TEXT("Connection reuse: LLM %.0f%%, TTS %.0f%%"),
+			UChatbotClient::GetConnectionReuseRate() * 100.0f, UTextToFaceEngine::GetConnectionReuseRate() * 100.0f);
+
+		for (const FConversationSessionStats& Stats : Pipelines->GetSessionStats())
+		{
+			UE_LOG(LogConversationPipelineSubsystem, Display, TEXT("  %s -> %s: queue %d%s, %d done, %d failed, p50 %.0f ms, p99 %.0f ms"),
+				*Stats.SessionId, *Stats.CharacterId.ToString(), Stats.QueueDepth, Stats.bActive ? TEXT(" (+1 running)") : TEXT(""),
+				Stats.CompletedTurns, Stats.FailedTurns, Stats.P50LatencyMs, Stats.P99LatencyMs);
+		}
+	}));
+#endif
@@ -0,0 +1,137 @@
+// ConversationStateSubsystem.cpp
+#include "ConversationStateSubsystem.h"
+
+#include "ACEAudioCurveSourceComponent.h"
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogConversationState, Log, All);
+
+void UConversationAnimationListener::HandleAnimationStarted()
+{
+	if (AActor* A = Avatar.Get())
+	{
+		if (UConversationStateSubsystem* States = UConversationStateSubsystem::Get(A))
+		{
+			States->SetAnimating(A, true);
+		}
+	}
+}
+
+void UConversationAnimationListener::HandleAnimationEnded()
+{
+	if (AActor* A = Avatar.Get())
+	{
+		if (UConversationStateSubsystem* States = UConversationStateSubsystem::Get(A))
+		{
+			States->SetAnimating(A, false);
+		}
+	}
+}
+
+UConversationStateSubsystem* UConversationStateSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject) return nullptr;
+
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+	return GI ? GI->GetSubsystem<UConversationStateSubsystem>() : nullptr;
+}
+
+void UConversationStateSubsystem::Deinitialize()
+{
+	for (UConversationAnimationListener* Listener : AnimationListeners)
+	{
+		if (UACEAudioCurveSourceComponent* Source = Listener ? Listener->Source.Get() : nullptr)
+		{
+			Source->OnAnimationStarted.RemoveAll(Listener);
+			Source->OnAnimationEnded.RemoveAll(Listener);
+		}
+	}
+	AnimationListeners.Reset();
+	States.Reset();
+	Super::Deinitialize();
+}
+
+void UConversationStateSubsystem::SetThinking(AActor* Avatar, bool bThinking)
+{
+	UpdateState(Avatar, &FConversationState::bThinking, bThinking);
+}
+
+void UConversationStateSubsystem::SetSpeaking(AActor* Avatar, bool bSpeaking)
+{
+	if (bSpeaking)
+	{
+		// TTS 开始时 ACE 组件已由引擎创建，顺便挂上动画事件
+		WatchAnimation(Avatar);
+	}
+	UpdateState(Avatar, &FConversationState::bSpeaking, bSpeaking);
+}
+
+void UConversationStateSubsystem::SetAnimating(AActor* Avatar, bool bAnimating)
+{
+	UpdateState(Avatar, &FConversationState::bAnimating, bAnimating);
+}
+
+FConversationState UConversationStateSubsystem::GetState(const AActor* Avatar) const
+{
+	const FConversationState* State = States.Find(FObjectKey(Avatar));
+	return State ? *State : FConversationState();
+}
+
+void UConversationStateSubsystem::UpdateState(AActor* Avatar, bool FConversationState::* Field, bool bValue)
+{
+	if (!IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UConversationStateSubsystem>(this), WeakAvatar = TWeakObjectPtr<AActor>(Avatar), Field, bValue]()
+		{
+			UConversationStateSubsystem* This = WeakThis.Get();
+			AActor* A = WeakAvatar.Get();
+			if (This && A)
+			{
+				This->UpdateState(A, Field, bValue);
+			}
+		});
+		return;
+	}
+
+	if (!IsValid(Avatar)) return;
+
+	FConversationState& State = States.FindOrAdd(FObjectKey(Avatar));
+	if (State.*Field == bValue) return;
+
+	State.*Field = bValue;
+	UE_LOG(LogConversationState, Verbose, TEXT("%s: thinking=%d speaking=%d animating=%d"),
+		*Avatar->GetName(), State.bThinking ? 1 : 0, State.bSpeaking ? 1 : 0, State.bAnimating ? 1 : 0);
+
+	const FConversationState Snapshot = State; // 回调里可能再修改 States
+	OnStateChanged.Broadcast(Avatar, Snapshot);
+}
+
+void UConversationStateSubsystem::WatchAnimation(AActor* Avatar)
+{
+	if (!IsValid(Avatar)) return;
+
+	UACEAudioCurveSourceComponent* Source = Avatar->FindComponentByClass<UACEAudioCurveSourceComponent>();
+	if (!Source) return;
+
+	// 清掉失效的监听，顺便判断是否已经挂过
+	bool bAlreadyWatching = false;
+	AnimationListeners.RemoveAll([Source, &bAlreadyWatching](const UConversationAnimationListener* Listener)
+	{
+		if (!Listener || !Listener->Source.IsValid() || !Listener->Avatar.IsValid()) return true;
+		bAlreadyWatching |= (Listener->Source.Get() == Source);
+		return false;
+	});
+	if (bAlreadyWatching) return;
+
+	UConversationAnimationListener* Listener = NewObject<UConversationAnimationListener>(this);
+	Listener->Avatar = Avatar;
+	Listener->Source = Source;
+	Source->OnAnimationStarted.AddDynamic(Listener, &UConversationAnimationListener::HandleAnimationStarted);
+	Source->OnAnimationEnded.AddDynamic(Listener, &UConversationAnimationListener::HandleAnimationEnded);
+	AnimationListeners.Add(Listener);
+}
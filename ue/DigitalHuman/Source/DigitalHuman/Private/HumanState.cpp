@@ -2,17 +2,13 @@
 
 
 #include "HumanState.h"
-#include "Blueprint/WidgetBlueprintLibrary.h"
-#include "Containers/Array.h"
+#include "WebInterfaceSubsystem.h"
 
 // Sets default values for this component's properties
 UHumanState::UHumanState()
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
-
-	// ...
+	// 状态由 UConversationStateSubsystem 事件驱动，不需要 Tick
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
 
@@ -21,40 +17,44 @@ void UHumanState::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// ...
-	
-}
+	if (UConversationStateSubsystem* States = UConversationStateSubsystem::Get(this))
+	{
+		States->OnStateChanged.AddUniqueDynamic(this, &UHumanState::HandleConversationStateChanged);
+		States->WatchAnimation(GetOwner());
+		bIsTalking = States->GetState(GetOwner()).IsBusy();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("HumanState: Can not find ConversationStateSubsystem!"));
+	}
 
-bool const UHumanState::CanReceiveNewMessage()
-{
-	return !bIsTalking;
+	// 前端轮询或订阅是否可以发送新消息
+	if (UWebInterfaceSubsystem* Web = UWebInterfaceSubsystem::Get(this))
+	{
+		Web->AllowWebCall(UHumanState::StaticClass(), GET_FUNCTION_NAME_CHECKED(UHumanState, CanReceiveNewMessage));
+		Web->AllowWebProperty(UHumanState::StaticClass(), GET_MEMBER_NAME_CHECKED(UHumanState, bIsTalking));
+	}
 }
 
-// Called every frame
-void UHumanState::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UHumanState::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	if (TextToFaceWidgetInstance == nullptr)
+	if (UConversationStateSubsystem* States = UConversationStateSubsystem::Get(this))
 	{
-		TArray<UUserWidget*> FoundWidgets;
-		UWidgetBlueprintLibrary::GetAllWidgetsOfClass(GetWorld(), FoundWidgets, UTextToFaceWidget::StaticClass(), false);
-		if (FoundWidgets.Num() > 0)
-		{
-			TextToFaceWidgetInstance = Cast<UTextToFaceWidget>(FoundWidgets[0]);
-		}
+		States->OnStateChanged.RemoveAll(this);
 	}
+	Super::EndPlay(EndPlayReason);
+}
 
-	if (TextToFaceWidgetInstance)
+void UHumanState::HandleConversationStateChanged(AActor* Avatar, const FConversationState& State)
+{
+	if (Avatar == GetOwner())
 	{
-		const FTextToFaceSnapshot Snap = TextToFaceWidgetInstance->GetRuntimeSnapshot();
 		// 正在思考或正在说话都视为“在说话态”，避免打断
-		bIsTalking = (Snap.bThinking || Snap.bSpeaking);
-	}
-	else
-	{
-		UE_LOG(LogTemp, Error, TEXT("HumanState: Can not find TextToFaceWidget Instance!"));
-		bIsTalking = false;
+		bIsTalking = State.IsBusy();
 	}
 }
 
+bool const UHumanState::CanReceiveNewMessage()
+{
+	return !bIsTalking;
+}
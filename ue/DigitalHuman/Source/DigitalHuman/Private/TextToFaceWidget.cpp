@@ -2,7 +2,7 @@
 #include "TextToFaceWidget.h"
 #include "Components/EditableTextBox.h"
 #include "Components/Button.h"
-#include "WebInterfaceSubsystem.h"
+#include "ConversationPipelineSubsystem.h"
 #include "TextToFace.h"
 
 
@@ -10,29 +10,17 @@ void UTextToFaceWidget::NativeConstruct()
 {
 	Super::NativeConstruct();
 
-	if (!EngineClass)
+	// API Key、音色等从 Config 读取；前端输入由 UConversationPipelineSubsystem 直接路由，不再在这里绑定
+	if (UConversationPipelineSubsystem* Pipelines = UConversationPipelineSubsystem::Get(this))
 	{
-		EngineClass = NewObject<UTextToFaceEngine>(this);
-		//TODO: set this via config or env instead of hard-coding
-		EngineClass->SetXiApiKey(TEXT("sk_e30762316d0e7a4a1a7d5937dc468e8d72fde1b13b37e325"));
-		EngineClass->SetVoiceId (TEXT("Q26iPuGVPnOfNa3FzCH6"));
-		EngineClass->SetModelId (TEXT("eleven_v3"));
-		// 不再在 Widget 绑定引擎完成回调，队列内循环在引擎侧处理
-	}
+		Pipeline = (EngineClass || ChatbotClient)
+			? Pipelines->CreatePipeline(NAME_None, ChatbotClient, EngineClass)
+			: Pipelines->GetPipeline();
 
-	if (!ChatbotClient)
-	{
-		ChatbotClient = NewObject<UChatbotClient>(this);
-		//TODO: set this via config or env instead of hard-coding
-		ChatbotClient->ApiKey = TEXT("sk-dd53e4e7cff84456bd554e018dbe2b8c");
-		ChatbotClient->BaseUrl = TEXT("https://api.deepseek.com");
-		ChatbotClient->Model   = TEXT("deepseek-chat");
-	}
-
-	// 绑定 WebInterface 的文本输入事件（最小改动）
-	if (UWebInterfaceSubsystem* Web = UWebInterfaceSubsystem::Get(this))
-	{
-		Web->OnUserInputReceived.AddDynamic(this, &UTextToFaceWidget::HandleUserInputReceived);
+		if (Pipeline && TargetActor)
+		{
+			Pipeline->SetAvatar(TargetActor);
+		}
 	}
 
 	if (SendButton)
@@ -41,161 +29,20 @@ void UTextToFaceWidget::NativeConstruct()
 	}
 }
 
-void UTextToFaceWidget::HandleUserInputReceived(const FString& UserText)
-{
-	if (UserText.IsEmpty() || !ChatbotClient || !EngineClass) return;
-
-	// reset streaming state（与 OnSendClicked 相同）
-	StreamBuffer.Reset();
-	if (UWorld* W = GetWorld())
-	{
-		LastFlushTimeSec = W->GetTimeSeconds();
-	}
-	else
-	{
-		UE_LOG(LogTemp, Warning, TEXT("HandleUserInputReceived() - Can't get world!"));
-	}
-
-	bStreamingInFlight = true;
-
-	// build messages（与 OnSendClicked 相同）
-	TArray<FString> Roles, Contents;
-	Roles.Add(TEXT("system")); Contents.Add(TEXT("You are a helpful assistant."));
-	Roles.Add(TEXT("user"));   Contents.Add(UserText);
-
-	FOnChatDelta OnDelta; OnDelta.BindUFunction(this, FName("HandleChatDelta"));
-	FOnChatResponse OnDone; OnDone.BindUFunction(this, FName("HandleChatDone"));
-	FOnChatError OnErr; OnErr.BindUFunction(this, FName("HandleChatError"));
-
-	ChatbotClient->SendChatStream(Roles, Contents, /*Temperature*/1.0f, OnDelta, OnDone, OnErr);
-}
-
 // UE内置Widget侧的调用
 void UTextToFaceWidget::OnSendClicked()
 {
-	if (!InputTextBox) return;
-	const FString UserText = InputTextBox->GetText().ToString();
-	HandleUserInputReceived(UserText);
-}
+	if (!InputTextBox || !Pipeline) return;
 
-void UTextToFaceWidget::HandleChatResponse(const FString& AIResponse)
-{
-	AActor* UseTarget = TargetActor ? TargetActor : GetOwningPlayerPawn();
-	if (EngineClass && UseTarget)
+	// 和网页输入一样走会话调度，避免与其他会话同时占用这个角色
+	if (UConversationPipelineSubsystem* Pipelines = UConversationPipelineSubsystem::Get(this))
 	{
-		// 非流式一次性也走直接合成
-		EngineClass->SynthesizeAndAnimate(AIResponse, UseTarget);
+		Pipelines->EnqueueTurn(TEXT("local"), Pipeline->GetConfig().CharacterId, InputTextBox->GetText().ToString());
 	}
 }
 
-void UTextToFaceWidget::HandleChatDelta(const FString& Delta)
-{
-	UE_LOG(LogTemp, Display, TEXT("Received delta from chatbot: %s"), *Delta);
-	// 仅做文本分句缓冲
-	StreamBuffer += Delta;
-
-	// 更新时间戳
-	if (UWorld* W = GetWorld())
-	{
-		LastFlushTimeSec = W->GetTimeSeconds();
-		UE_LOG(LogTemp, Display, TEXT("UTextToFaceWidget::HandleChatDelta() - Current delta time is %f"), LastFlushTimeSec);
-	}
-
-	// 命中边界则 flush
-	if (ReachedBoundary())
-	{
-		FlushBuffer(/*bForce*/false);
-	}
-}
-
-void UTextToFaceWidget::HandleChatDone(const FString& Full)
-{
-	UE_LOG(LogTemp, Display, TEXT("Received ChatDone: %s"), *Full);
-	FlushBuffer(/*bForce*/true);
-	if (UWorld* W = GetWorld())
-	{
-		W->GetTimerManager().ClearTimer(FlushTimerHandle);
-	}
-	bStreamingInFlight = false;
-}
-
-void UTextToFaceWidget::HandleChatError(const FString& Error)
-{
-	UE_LOG(LogTemp, Error, TEXT("Chatbot Error: %s"), *Error);
-	FlushBuffer(/*bForce*/true);
-	if (UWorld* W = GetWorld())
-	{
-		W->GetTimerManager().ClearTimer(FlushTimerHandle);
-	}
-	bStreamingInFlight = false;
-}
-
-// === helpers ===
-
-bool UTextToFaceWidget::ReachedBoundary() const
-{
-	// 命中句末标点
-	if (!StreamBuffer.IsEmpty())
-	{
-		const TCHAR LastCh = StreamBuffer[StreamBuffer.Len()-1];
-		if (SentenceBoundaries.Contains(FString(1, &LastCh)))
-		{
-			UE_LOG(LogTemp, Display, TEXT("Reached Boundary because of seeing %s"), *FString(1, &LastCh));
-			return true;
-		}
-	}
-	return false;
-}
-
-void UTextToFaceWidget::FlushBuffer(bool bForce)
-{
-	UE_LOG(LogTemp, Display, TEXT("Received FlushBuffer command"));
-	if (StreamBuffer.IsEmpty())
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Trying to flush a empty buffer!"));
-		return;
-	}
-
-	FString ToSpeak = StreamBuffer;
-	ToSpeak.TrimStartAndEndInline();
-	if (ToSpeak.IsEmpty() && !bForce)
-	{
-		UE_LOG(LogTemp, Display, TEXT("Skipping flush buffer since to speak is '%s' and bForce is %s"),
-			*ToSpeak, bForce ? TEXT("true") : TEXT("false"));
-		return;
-	}
-
-	// 清空本地缓冲
-	StreamBuffer.Reset();
-
-	// 直接交由引擎排队
-	AActor* UseTarget = ResolveTargetActor();
-	if (UseTarget && EngineClass)
-	{
-		// 交给引擎队列
-		UE_LOG(LogTemp, Display, TEXT("Flushing to TextToFace: %s"), *ToSpeak);
-		EngineClass->TextToFaceStreamAppend(ToSpeak, UseTarget);
-		EngineClass->StartTTSStreamIfStopped(); // 若未在播则启动
-	}
-	else
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Unable to flush: either UseTarget can't be resolved or EngineClass not defined"));
-	}
-
-	if (UWorld* W = GetWorld()) { LastFlushTimeSec = W->GetTimeSeconds(); }
-}
-
-AActor* UTextToFaceWidget::ResolveTargetActor() const
-{
-	if (TargetActor) return TargetActor;
-	if (APlayerController* PC = GetOwningPlayer())
-		return PC->GetPawn();
-	return nullptr;
-}
-
 void UTextToFaceWidget::NativeDestruct()
 {
-	// 不再移除引擎事件绑定
 	if (SendButton)
 	{
 		SendButton->OnClicked.RemoveAll(this);
@@ -207,10 +54,9 @@ FTextToFaceSnapshot UTextToFaceWidget::GetRuntimeSnapshot() const
 {
 	FTextToFaceSnapshot Snap;
 
-	Snap.bReady    = (EngineClass != nullptr) && (ChatbotClient != nullptr);
-	Snap.bThinking = bStreamingInFlight;
-	Snap.bSpeaking = (EngineClass && EngineClass->IsSpeaking());
+	Snap.bReady    = Pipeline && Pipeline->GetChatbot() && Pipeline->GetEngine();
+	Snap.bThinking = Pipeline && Pipeline->IsThinking();
+	Snap.bSpeaking = Pipeline && Pipeline->IsSpeaking();
 
 	return Snap;
 }
-
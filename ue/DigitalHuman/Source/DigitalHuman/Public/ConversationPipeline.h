@@ -0,0 +1,148 @@
+// ConversationPipeline.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/Object.h"
+#include "ConversationStateSubsystem.h"
+#include "ConversationPipeline.generated.h"
+
+class UChatbotClient;
+class UTextToFaceEngine;
+class UConversationPipeline;
+
+/** 一轮对话中的节点，供会话调度统计与放行 */
+UENUM(BlueprintType)
+enum class EConversationTurnEvent : uint8
+{
+	LLMFinished,	// LLM 流结束（成功或失败），可以放出 LLM 并发名额
+	SpeechStarted,	// ACE 开始播放本轮第一句
+	Finished,		// LLM、TTS、ACE 都已空闲，本轮结束（AbortTurn 放弃的一轮收尾完毕时也会发）
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnConversationTurnEvent, UConversationPipeline*, Pipeline, EConversationTurnEvent, Event);
+
+/** 一个数字人的对话配置（DefaultGame.ini 的 [/Script/DigitalHuman.ConversationPipelineSubsystem] 里 +Characters=(...)） */
+USTRUCT(BlueprintType)
+struct FConversationCharacterConfig
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Conversation")
+	FName CharacterId;
+
+	/** 带此 Tag 的 Actor 作为驱动对象（需可挂 ACE 组件）；也可用 SetAvatar 直接指定 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Conversation")
+	FName AvatarTag = TEXT("Avatar");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Conversation")
+	FString SystemPrompt = TEXT("You are a helpful assistant.");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Conversation")
+	float Temperature = 1.0f;
+
+	/** 以下为空时使用 UChatbotClient / UTextToFaceEngine 的 Config 默认值 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Conversation")
+	FString ChatModel;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Conversation")
+	FString VoiceId;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Conversation")
+	FString TtsModelId;
+
+	/** 命中这些字符时把已收到的文本交给 TTS */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Conversation")
+	FString SentenceBoundaries = TEXT(".!?。！？\n");
+};
+
+/**
+ * 单个数字人的 LLM -> 分句 -> TTS -> ACE 流水线，不依赖任何 UI。
+ * 状态变化（思考中、TTS 播报中）上报给 UConversationStateSubsystem。
+ */
+UCLASS(BlueprintType)
+class DIGITALHUMAN_API UConversationPipeline : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** InChatbot / InEngine 为空时按配置新建 */
+	void Init(const FConversationCharacterConfig& InConfig, UChatbotClient* InChatbot = nullptr, UTextToFaceEngine* InEngine = nullptr);
+
+	/** 发送一条用户输入，流式回复按句交给 TTS 播报 */
+	UFUNCTION(BlueprintCallable, Category="Conversation")
+	bool Submit(const FString& UserText);
+
+	UFUNCTION(BlueprintCallable, Category="Conversation")
+	void SetAvatar(AActor* InAvatar);
+
+	/** 当前驱动对象；未指定时按 AvatarTag 在关卡里找一次并缓存 */
+	UFUNCTION(BlueprintCallable, Category="Conversation")
+	AActor* ResolveAvatar();
+
+	UFUNCTION(BlueprintCallable, Category="Conversation")
+	bool IsThinking() const { return bStreamingInFlight; }
+
+	UFUNCTION(BlueprintCallable, Category="Conversation")
+	bool IsSpeaking() const;
+
+	/** Submit 之后到本轮 Finished（或 AbortTurn）之前为真 */
+	UFUNCTION(BlueprintCallable, Category="Conversation")
+	bool IsTurnActive() const { return bTurnActive; }
+
+	/** 放弃本轮（会话调度超时用）：清空待播句子，还在进行的 LLM 流剩下的输出直接丢掉；收尾完毕后发 Finished */
+	UFUNCTION(BlueprintCallable, Category="Conversation")
+	void AbortTurn();
+
+	/** AbortTurn 之后到 LLM 流结束、正在播的一句播完之前为真，期间不应开始新一轮 */
+	UFUNCTION(BlueprintCallable, Category="Conversation")
+	bool IsDraining() const { return bDraining; }
+
+	UPROPERTY(BlueprintAssignable, Category="Conversation")
+	FOnConversationTurnEvent OnTurnEvent;
+
+	const FConversationCharacterConfig& GetConfig() const { return Config; }
+	UChatbotClient* GetChatbot() const { return Chatbot; }
+	UTextToFaceEngine* GetEngine() const { return Engine; }
+
+private:
+	UFUNCTION() void HandleChatDelta(const FString& Delta);
+	UFUNCTION() void HandleChatDone(const FString& Full);
+	UFUNCTION() void HandleChatError(const FString& Error);
+	UFUNCTION() void HandleSpeakingChanged(bool bSpeaking);
+	UFUNCTION() void HandleStateChanged(AActor* InAvatar, const FConversationState& State);
+
+	/** LLM 结束、TTS 队列空、ACE 不在播放 */
+	bool IsIdle() const;
+
+	/** 空闲持续 Conversation.TurnIdleGraceSeconds 后才结束本轮，避开句与句之间的空档 */
+	void MaybeFinishTurn();
+
+	void FlushBuffer();
+	bool ReachedBoundary() const;
+	void SetStreamingInFlight(bool bInFlight);
+
+	UPROPERTY()
+	TObjectPtr<UChatbotClient> Chatbot;
+
+	UPROPERTY()
+	TObjectPtr<UTextToFaceEngine> Engine;
+
+	FConversationCharacterConfig Config;
+	TWeakObjectPtr<AActor> Avatar;
+
+	// 纯文本缓冲，按句交给引擎排队
+	FString StreamBuffer;
+	bool bStreamingInFlight = false;
+
+	// 延迟统计：提交 -> 首个 delta / 开始播报
+	double SubmitTimeSec = 0.0;
+	bool bFirstDeltaLogged = false;
+	bool bFirstSpeechLogged = false;
+
+	bool bTurnActive = false;
+	bool bSpeechStarted = false;
+	// AbortTurn 之后等上一轮的 LLM 流和正在播的一句结束，期间收到的 LLM 输出都丢掉
+	bool bDraining = false;
+	FTSTicker::FDelegateHandle FinishCheckHandle;
+};
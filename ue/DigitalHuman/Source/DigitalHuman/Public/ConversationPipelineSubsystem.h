@@ -0,0 +1,180 @@
+// ConversationPipelineSubsystem.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "ConversationPipeline.h"
+#include "ConversationPipelineSubsystem.generated.h"
+
+/** 单个用户会话的排队与延迟统计 */
+USTRUCT(BlueprintType)
+struct FConversationSessionStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="Conversation")
+	FString SessionId;
+
+	UPROPERTY(BlueprintReadOnly, Category="Conversation")
+	FName CharacterId;
+
+	/** 还没开始的轮数（不含正在进行的一轮） */
+	UPROPERTY(BlueprintReadOnly, Category="Conversation")
+	int32 QueueDepth = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Conversation")
+	bool bActive = false;
+
+	UPROPERTY(BlueprintReadOnly, Category="Conversation")
+	int32 CompletedTurns = 0;
+
+	/** 提交失败、超时或没有播出声音的轮数 */
+	UPROPERTY(BlueprintReadOnly, Category="Conversation")
+	int32 FailedTurns = 0;
+
+	/** 端到端延迟：入队 -> ACE 开始播放，最近若干轮 */
+	UPROPERTY(BlueprintReadOnly, Category="Conversation")
+	float P50LatencyMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="Conversation")
+	float P99LatencyMs = 0.0f;
+};
+
+/**
+ * 无界面的对话服务：按角色持有 UConversationPipeline（各自的 UChatbotClient 和 UTextToFaceEngine），
+ * 角色从 Config 读取，不需要创建任何 Widget。
+ *
+ * 同时是多用户的会话调度：WebInterface 消息里的 sessionId 对应一个会话，每个会话一条待处理队列，
+ * 会话绑定到一个角色。按会话轮转放行，每个角色同时只跑一轮，LLM 流总数受 Conversation.MaxConcurrentLLMStreams 限制；
+ * TTS 请求和 A2F 会话的并发由 TextToFaceAdmission 在引擎里统一限制。
+ */
+UCLASS(Config=Game)
+class DIGITALHUMAN_API UConversationPipelineSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "Conversation", meta=(WorldContext="WorldContextObject"))
+	static UConversationPipelineSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** 取角色的流水线，首次使用时按配置创建；None 表示默认角色 */
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	UConversationPipeline* GetPipeline(FName CharacterId = NAME_None);
+
+	/** 交给 CharacterId 对应的默认会话排队 */
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	bool Submit(FName CharacterId, const FString& UserText);
+
+	/**
+	 * 把一轮输入排进会话队列。CharacterId 为 None 时沿用会话已绑定的角色，新会话分给会话数最少的角色。
+	 * 队列满（Conversation.MaxQueuedTurnsPerSession）或会话数已满（Conversation.MaxSessions）时返回 false。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	bool EnqueueTurn(const FString& SessionId, FName CharacterId, const FString& UserText);
+
+	/** 丢弃会话的排队输入和统计；正在进行的一轮会自然结束 */
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	void EndSession(const FString& SessionId);
+
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	TArray<FConversationSessionStats> GetSessionStats() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	int32 GetActiveLLMStreams() const { return ActiveLLMStreams; }
+
+	/** 用外部已有的客户端创建/替换角色流水线（兼容在蓝图里指定 Engine/Chatbot 的旧 Widget） */
+	UConversationPipeline* CreatePipeline(FName CharacterId, class UChatbotClient* InChatbot, class UTextToFaceEngine* InEngine);
+
+	/** 配置的角色；为空时使用一个 AvatarTag=Avatar 的默认角色 */
+	UPROPERTY(Config, EditAnywhere, Category = "Conversation")
+	TArray<FConversationCharacterConfig> Characters;
+
+	/** 前端输入和未指定角色的请求交给它；None 时取 Characters 第一个 */
+	UPROPERTY(Config, EditAnywhere, Category = "Conversation")
+	FName DefaultCharacter;
+
+	/** 是否把 WebInterface 的用户输入按 sessionId 排进会话队列 */
+	UPROPERTY(Config, EditAnywhere, Category = "Conversation")
+	bool bRouteWebInput = true;
+
+	/** Pixel Streaming 有用户连上时创建各角色流水线并预热 LLM / TTS 连接 */
+	UPROPERTY(Config, EditAnywhere, Category = "Conversation")
+	bool bWarmUpOnConnect = true;
+
+	/** 创建（若还没有）各角色流水线，预热并保活它们的 LLM / TTS 连接 */
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	void WarmUpConnections();
+
+private:
+	struct FPendingTurn
+	{
+		FString Text;
+		double EnqueueTime = 0.0;
+	};
+
+	struct FConversationSession
+	{
+		FName CharacterId;
+		TArray<FPendingTurn> Pending;
+
+		bool bActive = false;
+		bool bHoldsLLMSlot = false;
+		bool bSpeechStarted = false;
+		double ActiveEnqueueTime = 0.0;
+		double ActiveStartTime = 0.0;
+		double LastActivityTime = 0.0;
+
+		int32 CompletedTurns = 0;
+		int32 FailedTurns = 0;
+
+		// 最近 MaxLatencySamples 轮的端到端延迟，环形覆盖
+		TArray<float> LatencyMs;
+		int32 NextLatencySlot = 0;
+	};
+
+	UFUNCTION()
+	void HandleWebInput(const FString& SessionId, const FString& Character, const FString& UserText);
+
+	UFUNCTION()
+	void HandleWebSessionClosed(const FString& SessionId);
+
+	UFUNCTION()
+	void HandlePlayerConnected(const FString& PlayerId);
+
+	UFUNCTION()
+	void HandleTurnEvent(UConversationPipeline* Pipeline, EConversationTurnEvent Event);
+
+	/** 按会话轮转，在角色空闲且还有 LLM 名额时开始下一轮 */
+	void Dispatch();
+	bool StartTurn(const FString& SessionId, FConversationSession& Session);
+	void FinishTurn(FConversationSession& Session, bool bSucceeded);
+
+	/** 轮次超时和闲置会话清理 */
+	bool TickSessions(float DeltaTime);
+
+	/** Hint 是配置过的角色（或已创建流水线）时用它，否则分给会话数最少的角色 */
+	FName AssignCharacter(FName Hint) const;
+	bool IsKnownCharacter(FName CharacterId) const;
+	FName ResolveCharacterId(FName CharacterId) const;
+	FConversationCharacterConfig FindConfig(FName CharacterId) const;
+
+	UPROPERTY()
+	TMap<FName, TObjectPtr<UConversationPipeline>> Pipelines;
+
+	TMap<FString, FConversationSession> Sessions;
+	TArray<FString> SessionOrder;
+	int32 NextSessionIndex = 0;
+
+	// 角色 -> 正在占用它的会话
+	TMap<FName, FString> ActiveSessionByCharacter;
+	// 超时放弃后 LLM 流还没关闭的角色，各自仍占一个 LLM 名额
+	TSet<FName> DrainingLLMSlots;
+	int32 ActiveLLMStreams = 0;
+	bool bDispatching = false;
+
+	FTSTicker::FDelegateHandle SessionTickerHandle;
+};
@@ -0,0 +1,88 @@
+// ConversationStateSubsystem.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ConversationStateSubsystem.generated.h"
+
+class UACEAudioCurveSourceComponent;
+
+/** 某个数字人当前的对话状态 */
+USTRUCT(BlueprintType)
+struct FConversationState
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="Conversation") bool bThinking = false;  // LLM 正在流式生成
+	UPROPERTY(BlueprintReadOnly, Category="Conversation") bool bSpeaking = false;  // TTS 队列非空
+	UPROPERTY(BlueprintReadOnly, Category="Conversation") bool bAnimating = false; // ACE 正在播放动画/音频
+
+	/** 任何一项为真都视为忙，不接收新消息 */
+	bool IsBusy() const { return bThinking || bSpeaking || bAnimating; }
+
+	bool operator==(const FConversationState& Other) const
+	{
+		return bThinking == Other.bThinking && bSpeaking == Other.bSpeaking && bAnimating == Other.bAnimating;
+	}
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnConversationStateChanged, AActor*, Avatar, const FConversationState&, State);
+
+/** 把某个 Actor 上 ACE 组件的开始/结束事件转给状态服务（动态委托无参数，需要一个对象记住是哪个 Actor） */
+UCLASS()
+class DIGITALHUMAN_API UConversationAnimationListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	TWeakObjectPtr<AActor> Avatar;
+	TWeakObjectPtr<UACEAudioCurveSourceComponent> Source;
+
+	UFUNCTION() void HandleAnimationStarted();
+	UFUNCTION() void HandleAnimationEnded();
+};
+
+/**
+ * 对话状态服务：流水线（Chatbot 流开始/结束、TTS 队列开始/播完、ACE 动画开始/结束）在状态变化时上报，
+ * 需要状态的一方订阅 OnStateChanged，不再每帧轮询。只在 GameThread 修改，其它线程的上报会转到 GameThread。
+ */
+UCLASS()
+class DIGITALHUMAN_API UConversationStateSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "Conversation", meta=(WorldContext="WorldContextObject"))
+	static UConversationStateSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	void SetThinking(AActor* Avatar, bool bThinking);
+
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	void SetSpeaking(AActor* Avatar, bool bSpeaking);
+
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	void SetAnimating(AActor* Avatar, bool bAnimating);
+
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	FConversationState GetState(const AActor* Avatar) const;
+
+	/** 监听 Avatar 上 ACE 组件的动画开始/结束；组件还没创建时什么也不做，之后再次调用即可 */
+	void WatchAnimation(AActor* Avatar);
+
+	/** 任一数字人的状态变化时广播（仅 GameThread） */
+	UPROPERTY(BlueprintAssignable, Category = "Conversation")
+	FOnConversationStateChanged OnStateChanged;
+
+private:
+	/** 修改某一项并在整体状态变化时广播 */
+	void UpdateState(AActor* Avatar, bool FConversationState::* Field, bool bValue);
+
+	TMap<FObjectKey, FConversationState> States;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UConversationAnimationListener>> AnimationListeners;
+};
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "TextToFaceWidget.h"
+#include "ConversationStateSubsystem.h"
 #include "HumanState.generated.h"
 
 
@@ -20,17 +21,20 @@ public:
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	// 不再使用：状态改由 UConversationStateSubsystem 推送，保留以免破坏已有蓝图
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="HumanState")
 	UTextToFaceWidget* TextToFaceWidgetInstance;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="HumanState")
 	bool bIsTalking = false;
 
-public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// 对话状态变化时更新 bIsTalking（思考、TTS、ACE 动画任一进行中即视为在说话）
+	UFUNCTION()
+	void HandleConversationStateChanged(AActor* Avatar, const FConversationState& State);
 
+public:	
 	UFUNCTION(BlueprintCallable, Category = "HumanState")
 	bool const CanReceiveNewMessage();
 };
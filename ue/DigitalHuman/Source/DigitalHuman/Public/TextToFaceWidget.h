@@ -8,6 +8,7 @@
 class UEditableTextBox;
 class UButton;
 class UTextToFaceEngine;
+class UConversationPipeline;
 
 USTRUCT(BlueprintType)
 struct FTextToFaceSnapshot
@@ -19,18 +20,24 @@ struct FTextToFaceSnapshot
 	UPROPERTY(BlueprintReadOnly) bool bSpeaking = false; // 估计是否在播放TextToFace
 };
 
+/**
+ * 调试用输入框：对话流程已移到 UConversationPipelineSubsystem，这里只把输入交给默认角色的流水线。
+ */
 UCLASS()
 class DIGITALHUMAN_API UTextToFaceWidget : public UUserWidget
 {
 	GENERATED_BODY()
 
 public:
+	/** 若指定，则用它替换默认角色流水线的 TTS 引擎 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="TextToFace")
 	UTextToFaceEngine* EngineClass = nullptr;
 
+	/** 若指定，作为默认角色的驱动对象 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="TextToFace")
 	AActor* TargetActor = nullptr;
 
+	/** 若指定，则用它替换默认角色流水线的 Chatbot */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Chatbot")
 	UChatbotClient* ChatbotClient = nullptr;
 
@@ -46,37 +53,7 @@ protected:
 
 private:
 	UFUNCTION() void OnSendClicked();
-	
-	// Legacy non-streaming callbacks
-	UFUNCTION() void HandleChatResponse(const FString& AIResponse);
-	UFUNCTION() void HandleChatError(const FString& Error);
 
-	// Streaming callbacks（仅从 LLM 收流，交给引擎排队）
-	UFUNCTION() void HandleChatDelta(const FString& Delta);
-	UFUNCTION() void HandleChatDone(const FString& Full);
-
-	// For inputs from PixelStreaming Web Frontend
-	UFUNCTION()
-	void HandleUserInputReceived(const FString& UserText);
-
-	// Chunking / flush helpers
-	void FlushBuffer(bool bForce);
-	bool ReachedBoundary() const;
-	AActor* ResolveTargetActor() const;
-
-	// 纯文本缓冲（不再本地排队语音）
-	FString StreamBuffer;
-	FTimerHandle FlushTimerHandle;
-	double LastFlushTimeSec = 0.0;
-	
-	UPROPERTY(EditAnywhere, Category="Streaming|Chunking")
-	float MaxWaitSeconds = 0.35f;        // flush if no new text for this time
-
-	UPROPERTY(EditAnywhere, Category="Streaming|Chunking")
-	FString SentenceBoundaries = TEXT(".!?。！？\n"); // punctuation boundary
-
-	UPROPERTY(EditAnywhere, Category="TextToFace", meta=(ClampMin="0.1", ClampMax="10.0"))
-	float SpeakWindowSec = 3.0f;
-
-	bool bStreamingInFlight = false;
+	UPROPERTY()
+	TObjectPtr<UConversationPipeline> Pipeline;
 };
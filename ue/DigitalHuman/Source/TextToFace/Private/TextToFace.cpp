@@ -1,5 +1,6 @@
 ﻿// TextToFaceEngine.cpp
 #include "TextToFace.h"
+#include "TextToFaceAdmission.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Interfaces/IHttpResponse.h"
@@ -10,6 +11,10 @@
 #include "Async/Async.h"
 #include "Containers/Ticker.h"  // ✅ FTSTicker
 #include "Misc/Base64.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/IConsoleManager.h"
+#include "PlatformHttp.h"
 
 // ACE
 #include "ACERuntimeModule.h"
@@ -24,6 +29,174 @@ DEFINE_LOG_CATEGORY_STATIC(LogTextToFace, Log, All);
 
 static FName GA2FProvider(TEXT("Default"));
 
+static TAutoConsoleVariable<float> CVarTextToFaceConnectionIdleTimeoutSeconds(
+    TEXT("TextToFace.ConnectionIdleTimeoutSeconds"),
+    60.0f,
+    TEXT("How long the TTS host keeps an idle connection open. Requests within this time of the last completed one count as reused; keep-alive pings at half of it.\n"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarTextToFaceKeepAliveWindowSeconds(
+    TEXT("TextToFace.KeepAliveWindowSeconds"),
+    300.0f,
+    TEXT("How long after WarmUpConnection idle keep-alive pings continue. 0 disables keep-alive.\n"),
+    ECVF_Default);
+
+// 按主机记录最近一次完成的请求，估算连接复用率（UE 的 HTTP 层不暴露 curl 的建连次数）
+namespace TextToFaceConnection
+{
+    static FCriticalSection Mutex;
+    static TMap<FString, double> LastCompleted;
+    static int32 NumRequests = 0;
+    static int32 NumReused = 0;
+
+    static double LastCompletedTime(const FString& Host)
+    {
+        FScopeLock Lock(&Mutex);
+        return LastCompleted.FindRef(Host);
+    }
+
+    static bool IsWarm(const FString& Host)
+    {
+        const double Last = LastCompletedTime(Host);
+        return Last > 0.0 && FPlatformTime::Seconds() - Last < CVarTextToFaceConnectionIdleTimeoutSeconds.GetValueOnAnyThread();
+    }
+
+    static void NoteRequest(const FString& Host)
+    {
+        const bool bWarm = IsWarm(Host);
+        FScopeLock Lock(&Mutex);
+        ++NumRequests;
+        NumReused += bWarm ? 1 : 0;
+    }
+
+    static void NoteCompleted(const FString& Host, bool bConnected)
+    {
+        FScopeLock Lock(&Mutex);
+        if (bConnected)
+        {
+            LastCompleted.Add(Host, FPlatformTime::Seconds());
+        }
+        else
+        {
+            LastCompleted.Remove(Host);
+        }
+    }
+
+    // 保活按主机共享：多个引擎指向同一主机时只有一个 ticker，同一时刻最多一个 HEAD，失败后退避
+    struct FKeepAlive
+    {
+        FString Url;
+        double Until = 0.0;
+        double NextAttempt = 0.0;
+        double Backoff = 0.0;
+        bool bInFlight = false;
+    };
+
+    static constexpr double MinKeepAliveBackoffSeconds = 5.0;
+    static constexpr double MaxKeepAliveBackoffSeconds = 60.0;
+
+    static TMap<FString, FKeepAlive> KeepAlives;
+    static FTSTicker::FDelegateHandle KeepAliveTicker;
+
+    static void SendKeepAlive(const FString& Host)
+    {
+        FString Url;
+        {
+            FScopeLock Lock(&Mutex);
+            FKeepAlive* State = KeepAlives.Find(Host);
+            if (!State || State->bInFlight) return;
+            State->bInFlight = true;
+            Url = State->Url;
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+
+        // 不带 xi-api-key，任何状态码都说明连接已建立
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Req = FHttpModule::Get().CreateRequest();
+        Req->SetURL(Url);
+        Req->SetVerb(TEXT("HEAD"));
+        Req->SetTimeout(5.0f);
+        Req->OnProcessRequestComplete().BindLambda([Host, StartTime](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+        {
+            const bool bConnected = bSucceeded && Response.IsValid();
+            NoteCompleted(Host, bConnected);
+            {
+                FScopeLock Lock(&Mutex);
+                if (FKeepAlive* State = KeepAlives.Find(Host))
+                {
+                    // 主机不可达时按 5s、10s、20s… 退避，不再每秒发一个 HEAD
+                    State->bInFlight = false;
+                    State->Backoff = bConnected ? 0.0 : FMath::Clamp(State->Backoff * 2.0, MinKeepAliveBackoffSeconds, MaxKeepAliveBackoffSeconds);
+                    State->NextAttempt = FPlatformTime::Seconds() + State->Backoff;
+                }
+            }
+            UE_LOG(LogTextToFace, Verbose, TEXT("Keep-alive %s: %s in %.0f ms"), *Host,
+                bConnected ? TEXT("ok") : TEXT("failed"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        });
+        Req->ProcessRequest();
+    }
+
+    static bool TickKeepAlive(float DeltaTime)
+    {
+        // 空闲超过一半超时就 ping 一次，连接一直留在池里
+        const double Now = FPlatformTime::Seconds();
+        const double PingAfter = 0.5 * CVarTextToFaceConnectionIdleTimeoutSeconds.GetValueOnGameThread();
+        TArray<FString, TInlineAllocator<4>> ToPing;
+        {
+            FScopeLock Lock(&Mutex);
+            for (auto It = KeepAlives.CreateIterator(); It; ++It)
+            {
+                const FKeepAlive& State = It.Value();
+                if (State.bInFlight) continue;
+                if (Now > State.Until)
+                {
+                    It.RemoveCurrent();
+                    continue;
+                }
+                if (Now >= State.NextAttempt && Now - LastCompleted.FindRef(It.Key()) > PingAfter)
+                {
+                    ToPing.Add(It.Key());
+                }
+            }
+            if (KeepAlives.Num() == 0)
+            {
+                KeepAliveTicker.Reset();
+                return false;
+            }
+        }
+
+        for (const FString& Host : ToPing)
+        {
+            SendKeepAlive(Host);
+        }
+        return true;
+    }
+
+    // 打开或顺延 Url 所在主机的保活窗口，连接不热时立即 ping 一次（退避中或已有 HEAD 在途时不发）；仅 GameThread
+    static void StartKeepAlive(const FString& Url, float Window)
+    {
+        const FString Host = FPlatformHttp::GetUrlDomain(Url);
+        const bool bWarm = IsWarm(Host);
+        bool bPingNow = false;
+        {
+            FScopeLock Lock(&Mutex);
+            FKeepAlive& State = KeepAlives.FindOrAdd(Host);
+            State.Url = Url;
+            State.Until = FMath::Max(State.Until, FPlatformTime::Seconds() + FMath::Max(0.0f, Window));
+            bPingNow = !bWarm && !State.bInFlight && FPlatformTime::Seconds() >= State.NextAttempt;
+        }
+
+        if (Window > 0.0f && !KeepAliveTicker.IsValid())
+        {
+            KeepAliveTicker = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickKeepAlive), 1.0f);
+        }
+        if (bPingNow)
+        {
+            SendKeepAlive(Host);
+        }
+    }
+}
+
 // === 工具：在 Game Thread 正确创建并注册 ACE 组件（若不存在） ===
 static UACEAudioCurveSourceComponent* EnsureACEConsumerOnGT(AActor* Actor)
 {
@@ -50,6 +223,26 @@ static UACEAudioCurveSourceComponent* EnsureACEConsumerOnGT(AActor* Actor)
     return C;
 }
 
+void UTextToFaceEngine::PostInitProperties()
+{
+    Super::PostInitProperties();
+    if (XiApiKey.IsEmpty())
+    {
+        XiApiKey = FPlatformMisc::GetEnvironmentVariable(TEXT("ELEVENLABS_API_KEY"));
+    }
+}
+
+float UTextToFaceEngine::GetConnectionReuseRate()
+{
+    FScopeLock Lock(&TextToFaceConnection::Mutex);
+    return TextToFaceConnection::NumRequests > 0 ? float(TextToFaceConnection::NumReused) / TextToFaceConnection::NumRequests : 0.0f;
+}
+
+void UTextToFaceEngine::WarmUpConnection()
+{
+    TextToFaceConnection::StartKeepAlive(TtsBaseUrl, CVarTextToFaceKeepAliveWindowSeconds.GetValueOnGameThread());
+}
+
 void UTextToFaceEngine::SynthesizeAndAnimate(const FString& Text, AActor* TargetActor)
 {
     // 保持不变：一次性合成并喂入
@@ -100,6 +293,45 @@ void UTextToFaceEngine::StartTTSStreamIfStopped()
     FScopeLock _(&QueueMtx);
     if (bSpeaking) return; // 已在播
     StartNextLocked();
+    if (bSpeaking)
+    {
+        NotifySpeakingChangedLocked(true);
+    }
+}
+
+void UTextToFaceEngine::ClearQueue()
+{
+    FScopeLock _(&QueueMtx);
+    UE_LOG(LogTextToFace, Verbose, TEXT("[Queue] cleared %d pending"), UtterQueue.Num());
+    UtterQueue.Reset();
+}
+
+// === 私有：当前条结束（成功或放弃），推进队列；队列空了才通知停止 ===
+void UTextToFaceEngine::FinishUtterance()
+{
+    {
+        FScopeLock _(&QueueMtx);
+        bSpeaking = false;
+        StartNextLocked();
+        if (!bSpeaking)
+        {
+            NotifySpeakingChangedLocked(false);
+        }
+    }
+    OnTTSClipFinished.Broadcast();
+}
+
+// 在锁内投递，保证 GameThread 上收到的开始/停止顺序与实际状态变化一致
+void UTextToFaceEngine::NotifySpeakingChangedLocked(bool bNowSpeaking)
+{
+    AsyncTask(ENamedThreads::GameThread, [WeakSelf = TWeakObjectPtr<UTextToFaceEngine>(this), bNowSpeaking]()
+    {
+        UTextToFaceEngine* Self = WeakSelf.Get();
+        if (!Self || Self->bSpeakingBroadcast == bNowSpeaking) return;
+
+        Self->bSpeakingBroadcast = bNowSpeaking;
+        Self->OnSpeakingChanged.Broadcast(bNowSpeaking);
+    });
 }
 
 // === 私有：从队列取下一条并启动 ===
@@ -162,12 +394,29 @@ static void LogHttpFailure(const FString& Context,
     }
 }
 
-// （可留存的旧非流式 StartTTSRequest / AnimateWithACE）
+// 所有引擎共享 TTS 并发名额，超出时排队等待
 void UTextToFaceEngine::StartTTSRequest(const FString& Text, TWeakObjectPtr<AActor> WeakTarget, int32 RetryCount)
+{
+    TextToFaceAdmission::TTSRequests().Run([WeakSelf = TWeakObjectPtr<UTextToFaceEngine>(this), Text, WeakTarget, RetryCount]()
+    {
+        if (UTextToFaceEngine* Self = WeakSelf.Get())
+        {
+            Self->SendTTSRequest(Text, WeakTarget, RetryCount);
+        }
+        else
+        {
+            TextToFaceAdmission::TTSRequests().Release();
+        }
+    });
+}
+
+// （可留存的旧非流式 StartTTSRequest / AnimateWithACE）
+void UTextToFaceEngine::SendTTSRequest(const FString& Text, TWeakObjectPtr<AActor> WeakTarget, int32 RetryCount)
 {
     const FString Url = FString::Printf(
-        TEXT("https://api.elevenlabs.io/v1/text-to-speech/%s?output_format=pcm_16000"),
-        *VoiceId);
+        TEXT("%s/v1/text-to-speech/%s?output_format=pcm_16000"),
+        *TtsBaseUrl, *VoiceId);
+    const FString Host = FPlatformHttp::GetUrlDomain(TtsBaseUrl);
 
     TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Req = FHttpModule::Get().CreateRequest();
     Req->SetURL(Url);
@@ -200,8 +449,12 @@ void UTextToFaceEngine::StartTTSRequest(const FString& Text, TWeakObjectPtr<AAct
     TWeakObjectPtr<UTextToFaceEngine> WeakSelf(this);
 
     Req->OnProcessRequestComplete().BindLambda(
-        [WeakSelf, WeakTarget, Text, RetryCount](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSucceeded)
+        [WeakSelf, WeakTarget, Text, RetryCount, Host](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSucceeded)
         {
+            // 请求结束即归还 TTS 名额（重试会重新排队）
+            TextToFaceAdmission::TTSRequests().Release();
+            TextToFaceConnection::NoteCompleted(Host, bSucceeded && Response.IsValid());
+
             UTextToFaceEngine* Self = WeakSelf.Get();
             if (!IsValid(Self)) { return; } // self 已无效
 
@@ -209,12 +462,7 @@ void UTextToFaceEngine::StartTTSRequest(const FString& Text, TWeakObjectPtr<AAct
             if (!Target)
             {
                 UE_LOG(LogTextToFace, Warning, TEXT("TargetActor destroyed before response."));
-                {
-                    FScopeLock _(&Self->QueueMtx);
-                    Self->bSpeaking = false;
-                    Self->StartNextLocked();
-                }
-                Self->OnTTSClipFinished.Broadcast();
+                Self->FinishUtterance();
                 return;
             }
 
@@ -245,12 +493,7 @@ void UTextToFaceEngine::StartTTSRequest(const FString& Text, TWeakObjectPtr<AAct
                     UE_LOG(LogTextToFace, Error, TEXT("[TTS] Max retries reached. Giving up on this utterance."));
                 }
 
-                {
-                    FScopeLock _(&Self->QueueMtx);
-                    Self->bSpeaking = false;
-                    Self->StartNextLocked();
-                }
-                Self->OnTTSClipFinished.Broadcast();
+                Self->FinishUtterance();
                 return;
             }
 
@@ -278,12 +521,7 @@ void UTextToFaceEngine::StartTTSRequest(const FString& Text, TWeakObjectPtr<AAct
                     return;
                 }
                 
-                {
-                    FScopeLock _(&Self->QueueMtx);
-                    Self->bSpeaking = false;
-                    Self->StartNextLocked();
-                }
-                Self->OnTTSClipFinished.Broadcast();
+                Self->FinishUtterance();
                 return;
             }
 
@@ -292,12 +530,7 @@ void UTextToFaceEngine::StartTTSRequest(const FString& Text, TWeakObjectPtr<AAct
             {
                 const FString Preview = FString(UTF8_TO_TCHAR((const char*)Bytes.GetData())).Left(400);
                 UE_LOG(LogTextToFace, Error, TEXT("Payload not PCM16 (size=%d). First 400 chars: %s"), Bytes.Num(), *Preview);
-                {
-                    FScopeLock _(&Self->QueueMtx);
-                    Self->bSpeaking = false;
-                    Self->StartNextLocked();
-                }
-                Self->OnTTSClipFinished.Broadcast();
+                Self->FinishUtterance();
                 return;
             }
 
@@ -342,78 +575,70 @@ void UTextToFaceEngine::StartTTSRequest(const FString& Text, TWeakObjectPtr<AAct
             TArray<int16> PcmCopy = MoveTemp(Pcm);
             TWeakObjectPtr<AActor> LocalWeakTarget(Target);
 
-            Async(EAsyncExecution::ThreadPool, [WeakSelf, PcmCopy = MoveTemp(PcmCopy), LocalWeakTarget, SampleRate, Channels, Chunk]()
+            // A2F 会话名额：拿到后才开始推流，推完（或失败）归还
+            TextToFaceAdmission::A2FSessions().Run([WeakSelf, PcmCopy = MoveTemp(PcmCopy), LocalWeakTarget, SampleRate, Channels, Chunk]() mutable
             {
-                UTextToFaceEngine* Self2 = WeakSelf.Get();
-                if (!IsValid(Self2)) { return; } // self 再次校验
-
-                AActor* TargetActor = LocalWeakTarget.Get();
-                if (!TargetActor)
+                Async(EAsyncExecution::ThreadPool, [WeakSelf, PcmCopy = MoveTemp(PcmCopy), LocalWeakTarget, SampleRate, Channels, Chunk]()
                 {
-                    UE_LOG(LogTextToFace, Warning, TEXT("TargetActor gone before ACE feeding."));
+                    ON_SCOPE_EXIT { TextToFaceAdmission::A2FSessions().Release(); };
+
+                    UTextToFaceEngine* Self2 = WeakSelf.Get();
+                    if (!IsValid(Self2)) { return; } // self 再次校验
+
+                    AActor* TargetActor = LocalWeakTarget.Get();
+                    if (!TargetActor)
                     {
-                        FScopeLock _(&Self2->QueueMtx);
-                        Self2->bSpeaking = false;
-                        Self2->StartNextLocked();
+                        UE_LOG(LogTextToFace, Warning, TEXT("TargetActor gone before ACE feeding."));
+                        Self2->FinishUtterance();
+                        return;
                     }
-                    Self2->OnTTSClipFinished.Broadcast();
-                    return;
-                }
 
-                UACEAudioCurveSourceComponent* Consumer = TargetActor->FindComponentByClass<UACEAudioCurveSourceComponent>();
-                if (!Consumer)
-                {
-                    UE_LOG(LogTextToFace, Error, TEXT("TargetActor missing UACEAudioCurveSourceComponent."));
+                    UACEAudioCurveSourceComponent* Consumer = TargetActor->FindComponentByClass<UACEAudioCurveSourceComponent>();
+                    if (!Consumer)
                     {
-                        FScopeLock _(&Self2->QueueMtx);
-                        Self2->bSpeaking = false;
-                        Self2->StartNextLocked();
+                        UE_LOG(LogTextToFace, Error, TEXT("TargetActor missing UACEAudioCurveSourceComponent."));
+                        Self2->FinishUtterance();
+                        return;
                     }
-                    Self2->OnTTSClipFinished.Broadcast();
-                    return;
-                }
 
-                bool bAllOK = true;
-                const int32 Num = PcmCopy.Num();
-                for (int32 i = 0; i < Num; i += Chunk)
-                {
-                    const int32 ThisCount = FMath::Min(Chunk, Num - i);
-                    const bool  bLast     = (i + ThisCount) >= Num;
-
-                    const bool bOK = FACERuntimeModule::Get().AnimateFromAudioSamples(
-                        Consumer,
-                        TArrayView<const int16>(PcmCopy.GetData() + i, ThisCount),
-                        Channels,
-                        SampleRate,
-                        /*bEndOfSamples*/ bLast,
-                        TOptional<FAudio2FaceEmotion>(),
-                        nullptr,
-                        GA2FProvider
-                    );
-
-                    if (!bOK)
+                    bool bAllOK = true;
+                    const int32 Num = PcmCopy.Num();
+                    for (int32 i = 0; i < Num; i += Chunk)
                     {
-                        bAllOK = false;
-                        UE_LOG(LogTextToFace, Error, TEXT("ACE chunk failed at %d."), i);
-                        break;
+                        const int32 ThisCount = FMath::Min(Chunk, Num - i);
+                        const bool  bLast     = (i + ThisCount) >= Num;
+
+                        const bool bOK = FACERuntimeModule::Get().AnimateFromAudioSamples(
+                            Consumer,
+                            TArrayView<const int16>(PcmCopy.GetData() + i, ThisCount),
+                            Channels,
+                            SampleRate,
+                            /*bEndOfSamples*/ bLast,
+                            TOptional<FAudio2FaceEmotion>(),
+                            nullptr,
+                            GA2FProvider
+                        );
+
+                        if (!bOK)
+                        {
+                            bAllOK = false;
+                            UE_LOG(LogTextToFace, Error, TEXT("ACE chunk failed at %d."), i);
+                            break;
+                        }
                     }
-                }
 
-                if (bAllOK)
-                {
-                    UE_LOG(LogTextToFace, Log, TEXT("ACE feeding complete."));
-                }
+                    if (bAllOK)
+                    {
+                        UE_LOG(LogTextToFace, Log, TEXT("ACE feeding complete."));
+                    }
 
-                // 本条完成，推进队列
-                {
-                    FScopeLock _(&Self2->QueueMtx);
-                    Self2->bSpeaking = false;
-                    Self2->StartNextLocked();
-                }
-                Self2->OnTTSClipFinished.Broadcast();
+                    // 本条完成，推进队列
+                    Self2->FinishUtterance();
+                });
             });
         });
 
+    TextToFaceConnection::NoteRequest(Host);
     Req->ProcessRequest();
 }
 
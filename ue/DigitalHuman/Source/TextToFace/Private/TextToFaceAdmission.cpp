@@ -0,0 +1,82 @@
+// TextToFaceAdmission.cpp
+#include "TextToFaceAdmission.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<int32> CVarTextToFaceMaxConcurrentTTSRequests(
+	TEXT("TextToFace.MaxConcurrentTTSRequests"),
+	4,
+	TEXT("Max ElevenLabs TTS requests in flight across all TextToFace engines; further utterances wait in FIFO order.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTextToFaceMaxConcurrentA2FSessions(
+	TEXT("TextToFace.MaxConcurrentA2FSessions"),
+	2,
+	TEXT("Max utterances streaming audio into Audio2Face at once across all TextToFace engines.\n"),
+	ECVF_Default);
+
+void FTextToFaceSlotGate::Run(TUniqueFunction<void()>&& Start)
+{
+	{
+		FScopeLock Lock(&Mutex);
+		if (Active >= FMath::Max(1, GetLimit()))
+		{
+			Waiting.Add(MoveTemp(Start));
+			return;
+		}
+		++Active;
+	}
+	Start();
+}
+
+void FTextToFaceSlotGate::Release()
+{
+	TUniqueFunction<void()> Next;
+	{
+		FScopeLock Lock(&Mutex);
+		// 上限调小后先收回多出来的名额
+		if (Waiting.Num() > 0 && Active <= FMath::Max(1, GetLimit()))
+		{
+			Next = MoveTemp(Waiting[0]);
+			Waiting.RemoveAt(0);
+		}
+		else
+		{
+			Active = FMath::Max(0, Active - 1);
+		}
+	}
+
+	// 锁外启动，避免和调用方持有的锁交叉
+	if (Next)
+	{
+		Next();
+	}
+}
+
+int32 FTextToFaceSlotGate::NumActive() const
+{
+	FScopeLock Lock(&Mutex);
+	return Active;
+}
+
+int32 FTextToFaceSlotGate::NumWaiting() const
+{
+	FScopeLock Lock(&Mutex);
+	return Waiting.Num();
+}
+
+namespace TextToFaceAdmission
+{
+	FTextToFaceSlotGate& TTSRequests()
+	{
+		static FTextToFaceSlotGate Gate([]() { return CVarTextToFaceMaxConcurrentTTSRequests.GetValueOnAnyThread(); });
+		return Gate;
+	}
+
+	FTextToFaceSlotGate& A2FSessions()
+	{
+		static FTextToFaceSlotGate Gate([]() { return CVarTextToFaceMaxConcurrentA2FSessions.GetValueOnAnyThread(); });
+		return Gate;
+	}
+}
@@ -10,13 +10,17 @@
  */
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnTTSClipFinished);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTTSSpeakingChanged, bool, bSpeaking);
 
-UCLASS(BlueprintType)
+UCLASS(BlueprintType, Config=Game)
 class TEXTTOFACE_API UTextToFaceEngine : public UObject
 {
     GENERATED_BODY()
 
 public:
+    // Config 里没有 XiApiKey 时读环境变量 ELEVENLABS_API_KEY（无界面/服务器部署用）
+    virtual void PostInitProperties() override;
+
     UFUNCTION(BlueprintCallable, Category="TextToFace")
     void SetXiApiKey(const FString& InKey) { XiApiKey = InKey; }
 
@@ -38,10 +42,18 @@ public:
     UFUNCTION(BlueprintCallable, Category="TextToFace")
     void StartTTSStreamIfStopped();
 
+    // 丢弃还没开始的条目；正在合成/播放的一条照常结束
+    UFUNCTION(BlueprintCallable, Category="TextToFace")
+    void ClearQueue();
+
     // 单条完成时广播（外界可选监听）
     UPROPERTY(BlueprintAssignable, Category="TextToFace")
     FOnTTSClipFinished OnTTSClipFinished;
 
+    // 队列开始播报 / 全部播完时在 GameThread 广播（中间条目衔接不会触发）
+    UPROPERTY(BlueprintAssignable, Category="TextToFace")
+    FOnTTSSpeakingChanged OnSpeakingChanged;
+
     // 是否正在播报TTS（线程安全只读）
     UFUNCTION(BlueprintCallable, Category="TextToFace")
     bool IsSpeaking() const;
@@ -50,11 +62,28 @@ public:
     UFUNCTION(BlueprintCallable, Category="TextToFace")
     int32 PendingUtterCount() const;
 
+    // 预热到 TtsBaseUrl 的连接（HEAD），之后 TextToFace.KeepAliveWindowSeconds 内空闲时定期再 HEAD 一次（按主机共享，失败后退避）
+    UFUNCTION(BlueprintCallable, Category="TextToFace")
+    void WarmUpConnection();
+
+    // TTS 请求里连接仍在空闲超时内（可复用）的比例，0~1；还没有请求时为 0
+    UFUNCTION(BlueprintCallable, Category="TextToFace")
+    static float GetConnectionReuseRate();
+
 private:
+    UPROPERTY(Config)
     FString XiApiKey;
+
+    UPROPERTY(Config)
     FString VoiceId = TEXT("JBFqnCBsd6RMkjVDRZzb");
+
+    UPROPERTY(Config)
     FString ModelId = TEXT("eleven_multilingual_v2");
 
+    // 可指向本地 mock 服务器做测试
+    UPROPERTY(Config)
+    FString TtsBaseUrl = TEXT("https://api.elevenlabs.io");
+
     // 队列项
     struct FUtterItem
     {
@@ -67,13 +96,17 @@ private:
     TArray<FUtterItem> UtterQueue; // 简单顺序数组队列
     mutable FCriticalSection QueueMtx;     // 保护队列
     bool bSpeaking = false;        // 正在消费中
+    bool bSpeakingBroadcast = false; // 最近一次广播的状态（仅 GameThread）
 
     // 重试配置
     static constexpr int32 MaxRetries = 3;      // 最大重试次数
     static constexpr float TimeoutSeconds = 10.0f; // HTTP超时时间（秒）
 
 private:
-    void StartTTSRequest(const FString& Text, TWeakObjectPtr<AActor> WeakTarget, int32 RetryCount = 0); // 旧非流式，保留复用
+    void StartTTSRequest(const FString& Text, TWeakObjectPtr<AActor> WeakTarget, int32 RetryCount = 0); // 等 TTS 并发名额后发请求
+    void SendTTSRequest(const FString& Text, TWeakObjectPtr<AActor> WeakTarget, int32 RetryCount); // 旧非流式，保留复用
     void StartNextLocked(); // 启动下一条（需已持锁）
+    void FinishUtterance(); // 当前条结束：推进队列并广播
+    void NotifySpeakingChangedLocked(bool bNowSpeaking); // 需已持锁
     static bool AnimateWithACE(AActor* TargetActor, const int16* Samples, int32 NumSamples, int32 SampleRate, int32 NumChannels);
 };
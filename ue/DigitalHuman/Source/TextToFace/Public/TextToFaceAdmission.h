@@ -0,0 +1,39 @@
+// TextToFaceAdmission.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+
+/**
+ * 全局并发闸门：所有 UTextToFaceEngine 共享。名额用完时任务按先来先到排队，
+ * 有名额释放时直接在释放它的线程上启动下一个任务（名额原样转交）。
+ */
+class TEXTTOFACE_API FTextToFaceSlotGate
+{
+public:
+	explicit FTextToFaceSlotGate(TFunction<int32()> InGetLimit) : GetLimit(MoveTemp(InGetLimit)) {}
+
+	/** 有名额立即执行 Start，否则排队；Start 完成后必须调用一次 Release */
+	void Run(TUniqueFunction<void()>&& Start);
+	void Release();
+
+	int32 NumActive() const;
+	int32 NumWaiting() const;
+
+private:
+	TFunction<int32()> GetLimit;
+
+	mutable FCriticalSection Mutex;
+	int32 Active = 0;
+	TArray<TUniqueFunction<void()>> Waiting;
+};
+
+namespace TextToFaceAdmission
+{
+	/** 同时进行的 ElevenLabs TTS 请求（TextToFace.MaxConcurrentTTSRequests） */
+	TEXTTOFACE_API FTextToFaceSlotGate& TTSRequests();
+
+	/** 同时向 A2F 推流的会话（TextToFace.MaxConcurrentA2FSessions） */
+	TEXTTOFACE_API FTextToFaceSlotGate& A2FSessions();
+}
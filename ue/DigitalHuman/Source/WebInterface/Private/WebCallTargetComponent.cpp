@@ -0,0 +1,47 @@
+// WebCallTargetComponent.cpp
+#include "WebCallTargetComponent.h"
+#include "WebInterfaceSubsystem.h"
+
+#include "GameFramework/Actor.h"
+
+UWebCallTargetComponent::UWebCallTargetComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UWebCallTargetComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UWebInterfaceSubsystem* Web = UWebInterfaceSubsystem::Get(this))
+	{
+		Web->RegisterCallTarget(GetEffectiveTargetId(), GetOwner());
+		for (const FName& FunctionName : CallableFunctions)
+		{
+			Web->AllowWebCall(GetOwner()->GetClass(), FunctionName);
+		}
+		for (const FName& PropertyName : SubscribableProperties)
+		{
+			Web->AllowWebProperty(GetOwner()->GetClass(), PropertyName);
+		}
+	}
+}
+
+void UWebCallTargetComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWebInterfaceSubsystem* Web = UWebInterfaceSubsystem::Get(this))
+	{
+		Web->UnregisterCallTarget(GetEffectiveTargetId(), GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FName UWebCallTargetComponent::GetEffectiveTargetId() const
+{
+	if (!TargetId.IsNone())
+	{
+		return TargetId;
+	}
+	return GetOwner() ? GetOwner()->GetFName() : NAME_None;
+}
@@ -0,0 +1,183 @@
+// WebInterfaceBenchmark.cpp
+// UI 消息解析吞吐量对比：FWebUIMessage::Parse 与旧的多次解析流程。
+// 用法：WebInterface.ParseBenchmark [Iterations=20000]
+// 出站帧大小与编码耗时：逐条 JSON、合并 JSON。
+// 用法：WebInterface.OutboundBenchmark [MessagesPerFrame=8] [Iterations=5000]
+#include "WebUIMessage.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+#if !UE_BUILD_SHIPPING
+
+DEFINE_LOG_CATEGORY_STATIC(LogWebInterfaceBenchmark, Log, All);
+
+namespace
+{
+	// 旧流程：整条反转义 + 去引号，解析成 FJsonValue，字符串时再解析一次，chat 再由 TryParseChatText 解析第三次
+	bool LegacyParse(const FString& JsonOrText, FString& OutText)
+	{
+		FString Trimmed = JsonOrText.ReplaceEscapedCharWithChar();
+		if (Trimmed.Len() > 0 && Trimmed[0] == TEXT('"') && Trimmed.EndsWith(TEXT("\"")))
+		{
+			Trimmed = Trimmed.Left(Trimmed.Len() - 1);
+			Trimmed.RemoveAt(0, 1);
+		}
+
+		TSharedPtr<FJsonValue> Any;
+		{
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Trimmed);
+			FJsonSerializer::Deserialize(Reader, Any);
+		}
+
+		TSharedPtr<FJsonObject> Root;
+		if (Any.IsValid() && Any->Type == EJson::Object)
+		{
+			Root = Any->AsObject();
+		}
+		else if (Any.IsValid() && Any->Type == EJson::String)
+		{
+			TSharedRef<TJsonReader<>> Reader2 = TJsonReaderFactory<>::Create(Any->AsString());
+			FJsonSerializer::Deserialize(Reader2, Root);
+		}
+		if (!Root.IsValid())
+		{
+			return false;
+		}
+
+		FString Type;
+		if (Root->TryGetStringField(TEXT("type"), Type) && Type.Equals(TEXT("chat"), ESearchCase::IgnoreCase))
+		{
+			TSharedRef<TJsonReader<>> Reader3 = TJsonReaderFactory<>::Create(Trimmed);
+			TSharedPtr<FJsonObject> ChatObj;
+			if (FJsonSerializer::Deserialize(Reader3, ChatObj) && ChatObj.IsValid())
+			{
+				ChatObj->TryGetStringField(TEXT("text"), OutText);
+			}
+		}
+		return true;
+	}
+
+	void RunParseBenchmark(const TArray<FString>& Args)
+	{
+		const int32 Iterations = FMath::Max(1, (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 20000);
+
+		const FString Chat = TEXT("{\"type\":\"chat\",\"requestId\":\"r-1024\",\"text\":\"Hello there, could you tell me a little about yourself?\"}");
+		const FString Call = TEXT("{\"type\":\"call\",\"requestId\":\"r-1025\",\"target\":{\"by\":\"id\",\"value\":\"Human\"},\"component\":\"HumanState\",\"method\":\"CanReceiveNewMessage\"}");
+		FString Stringified = Chat.ReplaceCharWithEscapedChar();
+		Stringified = FString::Printf(TEXT("\"%s\""), *Stringified);
+
+		struct FCase { const TCHAR* Name; const FString* Message; };
+		const FCase Cases[] = { { TEXT("chat"), &Chat }, { TEXT("stringified chat"), &Stringified }, { TEXT("call"), &Call } };
+
+		for (const FCase& Case : Cases)
+		{
+			int32 NumParsed = 0;
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				FWebUIMessage Msg;
+				NumParsed += FWebUIMessage::Parse(*Case.Message, Msg) ? 1 : 0;
+			}
+			const double NewSeconds = FPlatformTime::Seconds() - StartTime;
+
+			int32 NumLegacyParsed = 0;
+			StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				FString Text;
+				NumLegacyParsed += LegacyParse(*Case.Message, Text) ? 1 : 0;
+			}
+			const double LegacySeconds = FPlatformTime::Seconds() - StartTime;
+
+			UE_LOG(LogWebInterfaceBenchmark, Display, TEXT("WebInterface.ParseBenchmark %s: %.0f msg/s (legacy %.0f msg/s, %.2fx), parsed %d/%d (legacy %d/%d)"),
+				Case.Name, Iterations / FMath::Max(NewSeconds, 1e-9), Iterations / FMath::Max(LegacySeconds, 1e-9),
+				LegacySeconds / FMath::Max(NewSeconds, 1e-9), NumParsed, Iterations, NumLegacyParsed, Iterations);
+		}
+	}
+
+	FString SerializeCondensed(const TSharedRef<FJsonObject>& Obj)
+	{
+		FString Out;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> W = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Out);
+		FJsonSerializer::Serialize(Obj, W);
+		return Out;
+	}
+
+	void RunOutboundBenchmark(const TArray<FString>& Args)
+	{
+		const int32 MessagesPerFrame = FMath::Max(1, (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 8);
+		const int32 Iterations = FMath::Max(1, (Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 5000);
+
+		// 典型的一帧：若干状态变化（说话、思考、字幕、口型预览）
+		TArray<TSharedPtr<FJsonValue>> Messages;
+		for (int32 i = 0; i < MessagesPerFrame; ++i)
+		{
+			TSharedRef<FJsonObject> Changes = MakeShared<FJsonObject>();
+			switch (i % 4)
+			{
+			case 0: Changes->SetBoolField(TEXT("speaking"), (i & 1) != 0); break;
+			case 1: Changes->SetBoolField(TEXT("thinking"), (i & 2) != 0); break;
+			case 2: Changes->SetStringField(TEXT("subtitle"), TEXT("Nice to meet you, what would you like to talk about today?")); break;
+			default:
+			{
+				TArray<TSharedPtr<FJsonValue>> Weights;
+				for (int32 w = 0; w < 16; ++w) Weights.Add(MakeShared<FJsonValueNumber>(w / 16.0));
+				Changes->SetArrayField(TEXT("visemes"), Weights);
+				break;
+			}
+			}
+			TSharedRef<FJsonObject> State = MakeShared<FJsonObject>();
+			State->SetStringField(TEXT("type"), TEXT("state"));
+			State->SetObjectField(TEXT("changes"), Changes);
+			Messages.Add(MakeShared<FJsonValueObject>(State));
+		}
+		TSharedRef<FJsonObject> Frame = MakeShared<FJsonObject>();
+		Frame->SetStringField(TEXT("type"), TEXT("frame"));
+		Frame->SetArrayField(TEXT("messages"), Messages);
+
+		// Pixel Streaming 按 UTF-16 发送字符串，字节数按 2 字节/字符计
+		int64 SeparateBytes = 0;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			SeparateBytes = 0;
+			for (const TSharedPtr<FJsonValue>& Message : Messages)
+			{
+				SeparateBytes += SerializeCondensed(Message->AsObject().ToSharedRef()).Len() * 2;
+			}
+		}
+		const double SeparateSeconds = FPlatformTime::Seconds() - StartTime;
+
+		int64 CoalescedBytes = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			CoalescedBytes = SerializeCondensed(Frame).Len() * 2;
+		}
+		const double CoalescedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogWebInterfaceBenchmark, Display, TEXT("WebInterface.OutboundBenchmark %d msgs/frame: separate JSON %d sends %lld B %.2f us, coalesced JSON 1 send %lld B %.2f us"),
+			MessagesPerFrame, MessagesPerFrame, SeparateBytes, 1e6 * SeparateSeconds / Iterations,
+			CoalescedBytes, 1e6 * CoalescedSeconds / Iterations);
+	}
+
+	FAutoConsoleCommand CmdWebInterfaceOutboundBenchmark(
+		TEXT("WebInterface.OutboundBenchmark"),
+		TEXT("Compare outbound bytes and encode time per frame: one JSON message per state change vs one coalesced JSON frame. Args: [MessagesPerFrame] [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunOutboundBenchmark));
+
+	FAutoConsoleCommand CmdWebInterfaceParseBenchmark(
+		TEXT("WebInterface.ParseBenchmark"),
+		TEXT("Compare UI message parsing throughput (messages/sec) of FWebUIMessage::Parse with the previous multi-pass parsing. Args: [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunParseBenchmark));
+}
+
+#endif
@@ -3,15 +3,68 @@
 
 #include "Engine/Engine.h"
 #include "Engine/World.h"
-#include "Kismet/GameplayStatics.h"
 #include "EngineUtils.h"
 
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeExit.h"
+
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
+#include "JsonObjectConverter.h"
+#include "PixelStreaming2Delegates.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogWebInterfaceSubsystem, Log, All);
 
+static TAutoConsoleVariable<int32> CVarWebInterfaceLogLinesPerSecond(
+	TEXT("WebInterface.LogLinesPerSecond"),
+	5,
+	TEXT("Max per-message log lines (payloads, parse warnings) WebInterface writes per second; the rest are counted and summarized.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarWebInterfaceMaxBatchCalls(
+	TEXT("WebInterface.MaxBatchCalls"),
+	64,
+	TEXT("Max number of calls accepted in one {\"type\":\"batch\"} message.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarWebInterfaceCoalesceOutbound(
+	TEXT("WebInterface.CoalesceOutbound"),
+	1,
+	TEXT("1: queue responses and state pushes and send them once per frame; 0: send every response immediately.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarWebInterfaceDefaultSubscribeHz(
+	TEXT("WebInterface.DefaultSubscribeHz"),
+	10.0f,
+	TEXT("Max push rate for subscriptions that do not specify maxHz.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarWebInterfaceMaxSubscribeHz(
+	TEXT("WebInterface.MaxSubscribeHz"),
+	30.0f,
+	TEXT("Upper bound for a subscription's maxHz; maxHz <= 0 also uses this.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarWebInterfaceMaxSubscriptionsPerSession(
+	TEXT("WebInterface.MaxSubscriptionsPerSession"),
+	32,
+	TEXT("Max state subscriptions one frontend session may hold.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarWebInterfaceMaxSessions(
+	TEXT("WebInterface.MaxSessions"),
+	64,
+	TEXT("Max concurrent frontend sessions (sessionId); messages from further new sessions are dropped.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarWebInterfaceSessionLeaseSeconds(
+	TEXT("WebInterface.SessionLeaseSeconds"),
+	30.0f,
+	TEXT("A frontend session that sends nothing (psBridge sends a keepalive every 10 s) for this long is closed. 0 disables expiry.\n"),
+	ECVF_Default);
+
 UWebInterfaceSubsystem* UWebInterfaceSubsystem::Get(UObject* WorldContextObject)
 {
 	if (!WorldContextObject) return nullptr;
@@ -28,6 +81,19 @@ UWebInterfaceSubsystem* UWebInterfaceSubsystem::Get(UObject* WorldContextObject)
 	return GI ? GI->GetSubsystem<UWebInterfaceSubsystem>() : nullptr;
 }
 
+// Class 或其父类登记过 Name 才放行
+static bool IsAllowedForClass(const TSet<TPair<FObjectKey, FName>>& Allowlist, const UClass* Class, FName Name)
+{
+	for (const UClass* It = Class; It; It = It->GetSuperClass())
+	{
+		if (Allowlist.Contains(TPair<FObjectKey, FName>(FObjectKey(It), Name)))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 static UActorComponent* FindComponentByNameOrClass(AActor* Actor, const FString& NameOrClass)
 {
 	// 先按名字匹配
@@ -49,349 +115,974 @@ static UActorComponent* FindComponentByNameOrClass(AActor* Actor, const FString&
 	return nullptr;
 }
 
+static TSharedRef<FJsonObject> MakeResponseObject(bool bOk, const FString& RequestId, const FString& ErrorMsg, const TSharedPtr<FJsonValue>& Result)
+{
+	TSharedRef<FJsonObject> Obj = MakeShared<FJsonObject>();
+	Obj->SetStringField(TEXT("type"), TEXT("response"));
+	if (!RequestId.IsEmpty()) Obj->SetStringField(TEXT("requestId"), RequestId);
+	Obj->SetBoolField(TEXT("ok"), bOk);
+	if (!ErrorMsg.IsEmpty()) Obj->SetStringField(TEXT("error"), ErrorMsg);
+	if (Result.IsValid()) Obj->SetField(TEXT("result"), Result);
+	return Obj;
+}
+
+// 数字数组直接填进全是数字成员的结构体：[x,y,z] -> FVector，[p,y,r] -> FRotator，[r,g,b,a] -> FLinearColor 等
+static bool JsonArrayToNumericStruct(const TArray<TSharedPtr<FJsonValue>>& Values, const FStructProperty* StructProp, void* OutValue)
+{
+	TArray<const FNumericProperty*, TInlineAllocator<4>> Members;
+	for (TFieldIterator<FProperty> It(StructProp->Struct); It; ++It)
+	{
+		const FNumericProperty* Numeric = CastField<FNumericProperty>(*It);
+		if (!Numeric || Numeric->IsEnum()) return false;
+		Members.Add(Numeric);
+	}
+	if (Members.Num() != Values.Num()) return false;
+
+	for (int32 i = 0; i < Members.Num(); ++i)
+	{
+		double Number = 0.0;
+		if (!Values[i].IsValid() || !Values[i]->TryGetNumber(Number)) return false;
+
+		void* MemberValue = Members[i]->ContainerPtrToValuePtr<void>(OutValue);
+		if (Members[i]->IsFloatingPoint())
+		{
+			Members[i]->SetFloatingPointPropertyValue(MemberValue, Number);
+		}
+		else
+		{
+			Members[i]->SetIntPropertyValue(MemberValue, static_cast<int64>(Number));
+		}
+	}
+	return true;
+}
+
+static bool JsonToParam(const TSharedPtr<FJsonValue>& JsonValue, FProperty* Prop, void* OutValue)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+	if (const FStructProperty* StructProp = CastField<FStructProperty>(Prop))
+	{
+		if (JsonValue->TryGetArray(Values) && JsonArrayToNumericStruct(*Values, StructProp, OutValue))
+		{
+			return true;
+		}
+	}
+	return FJsonObjectConverter::JsonValueToUProperty(JsonValue, Prop, OutValue, 0, 0);
+}
+
 void UWebInterfaceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 	UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("UWebInterfaceSubsystem::Initialize"));
+
+	FlushTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UWebInterfaceSubsystem::FlushOutbound));
+
+	if (UPixelStreaming2Delegates* PSDelegates = UPixelStreaming2Delegates::Get())
+	{
+		NewConnectionHandle = PSDelegates->OnNewConnectionNative.AddUObject(this, &UWebInterfaceSubsystem::HandleNewConnection);
+		ClosedConnectionHandle = PSDelegates->OnClosedConnectionNative.AddUObject(this, &UWebInterfaceSubsystem::HandleClosedConnection);
+	}
 }
 
 void UWebInterfaceSubsystem::Deinitialize()
 {
 	UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("UWebInterfaceSubsystem::Deinitialize"));
+	if (UPixelStreaming2Delegates* PSDelegates = UPixelStreaming2Delegates::Get())
+	{
+		PSDelegates->OnNewConnectionNative.Remove(NewConnectionHandle);
+		PSDelegates->OnClosedConnectionNative.Remove(ClosedConnectionHandle);
+	}
+	NewConnectionHandle.Reset();
+	ClosedConnectionHandle.Reset();
+	ConnectedPlayers.Reset();
+	CallTargets.Reset();
+	ActorLookupCache.Reset();
+	ComponentCache.Reset();
+	FunctionCache.Reset();
+	WatchedActors.Reset();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(FlushTickerHandle);
+	FlushTickerHandle.Reset();
+	OutboundQueue.Reset();
+	Subscriptions.Reset();
+	SessionLastSeen.Reset();
+	PublishedState.Reset();
 	Super::Deinitialize();
 }
 
-void UWebInterfaceSubsystem::ReceiveUIMessage(const FString& JsonOrText)
+void UWebInterfaceSubsystem::HandleNewConnection(FString StreamerId, FString PlayerId)
 {
-	OnRawMessage.Broadcast(JsonOrText);
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UWebInterfaceSubsystem>(this), PlayerId]()
+	{
+		if (UWebInterfaceSubsystem* This = WeakThis.Get())
+		{
+			UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("Pixel Streaming player connected: %s"), *PlayerId);
+			This->ConnectedPlayers.Add(PlayerId);
+			This->OnPlayerConnected.Broadcast(PlayerId);
+		}
+	});
+}
 
-	FString TrimmedJsonOrText = JsonOrText.ReplaceEscapedCharWithChar();
-	if (TrimmedJsonOrText.Len() > 0 && TrimmedJsonOrText[0] == TEXT('"') && TrimmedJsonOrText.EndsWith(TEXT("\"")))
+void UWebInterfaceSubsystem::HandleClosedConnection(FString StreamerId, FString PlayerId)
+{
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UWebInterfaceSubsystem>(this), PlayerId]()
 	{
-		TrimmedJsonOrText = TrimmedJsonOrText.Left(TrimmedJsonOrText.Len() - 1);
-		TrimmedJsonOrText.RemoveAt(0, 1);
-	}
+		UWebInterfaceSubsystem* This = WeakThis.Get();
+		if (!This) return;
 
-	UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("Received Request trimmed: %s"), *TrimmedJsonOrText);
+		UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("Pixel Streaming player disconnected: %s"), *PlayerId);
+		This->ConnectedPlayers.Remove(PlayerId);
 
-	// 先尝试把整条消息当成 JSON Value 解析（可能是对象，也可能就是一个字符串）
-	// 测试发现，由于前端原因，可能收到的是double-stringified的json。后续如果第一次解码不成功会尝试第二次解码
-	TSharedPtr<FJsonValue> Any;
-	{
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(TrimmedJsonOrText);
-		FJsonSerializer::Deserialize(Reader, Any);
-	}
+		// 蓝图输入事件不带 PlayerId，单个播放端断开时它的会话靠租约到期关闭；全部断开时立即关闭所有会话
+		if (This->ConnectedPlayers.Num() == 0)
+		{
+			TArray<FString> SessionIds;
+			This->SessionLastSeen.GetKeys(SessionIds);
+			for (const FString& SessionId : SessionIds)
+			{
+				This->CloseSession(SessionId);
+			}
+			This->Subscriptions.Reset();
+		}
+	});
+}
 
-	// 如果直接是对象，拿对象用
-	TSharedPtr<FJsonObject> Root;
-	if (Any.IsValid() && Any->Type == EJson::Object)
+void UWebInterfaceSubsystem::ReceiveUIMessage(const FString& JsonOrText)
+{
+	// 调用、批量调用都在 GameThread 执行；其它线程送进来的消息整条转过去
+	if (!IsInGameThread())
 	{
-		Root = Any->AsObject();
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UWebInterfaceSubsystem>(this), JsonOrText]()
+		{
+			if (UWebInterfaceSubsystem* This = WeakThis.Get())
+			{
+				This->ReceiveUIMessage(JsonOrText);
+			}
+		});
+		return;
 	}
-	else if (Any.IsValid() && Any->Type == EJson::String)
-	{
-		// 收到的是被二次字符串化的 JSON：把字符串再解析一次
-		const FString& Inner = Any->AsString();
 
-		TSharedRef<TJsonReader<>> Reader2 = TJsonReaderFactory<>::Create(Inner);
-		FJsonSerializer::Deserialize(Reader2, Root);
-	}
-	else
+	OnRawMessage.Broadcast(JsonOrText);
+
+	// 完整内容只在 Verbose 下打印，且限速
+	if (UE_LOG_ACTIVE(LogWebInterfaceSubsystem, Verbose) && PayloadLogLimiter.Allow())
 	{
-		// 还可能是数组或其它；按需扩展
-		// 留个调试信息方便定位
-		UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("JSON parse produced non-object type (type=%d)"), Any.IsValid() ? (int32)Any->Type : -1);
+		UE_LOG(LogWebInterfaceSubsystem, Verbose, TEXT("Received UI message (%d chars): %s"), JsonOrText.Len(), *JsonOrText.Left(MaxLoggedPayloadChars));
 	}
 
-	// 不是 JSON 对象 -> 走纯文本兜底
-	if (!Root.IsValid())
+	// 一次解析：同时兼容普通 JSON 与二次字符串化的 JSON
+	FWebUIMessage Msg;
+	if (!FWebUIMessage::Parse(JsonOrText, Msg))
 	{
-		UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Received Non-JSON request!"));
-		FString ChatText;
-		if (!TrimmedJsonOrText.StartsWith(TEXT("{")) && !TrimmedJsonOrText.StartsWith(TEXT("[")))
+		if (WarningLogLimiter.Allow())
 		{
-			ChatText = TrimmedJsonOrText;
+			UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Received unparsable UI message (%d chars)"), JsonOrText.Len());
 		}
-		else
+		return;
+	}
+
+	// 新会话超过 WebInterface.MaxSessions 时整条丢弃，防止单个页面伪造大量会话
+	if (!TouchSession(Msg.SessionId))
+	{
+		if (WarningLogLimiter.Allow())
 		{
-			TryParseChatText(TrimmedJsonOrText, ChatText);
+			UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Too many web sessions (%d), dropping message from new session"), SessionLastSeen.Num());
 		}
-		if (!ChatText.IsEmpty())
+		if (!Msg.RequestId.IsEmpty())
 		{
-			OnUserInputReceived.Broadcast(ChatText);
+			BroadcastResponse(MakeResponseObject(false, Msg.RequestId, TEXT("Too many sessions"), nullptr));
 		}
 		return;
 	}
 
-	FString Type;
-	if (Root->TryGetStringField(TEXT("type"), Type))
+	switch (Msg.Type)
 	{
-		
-		if (Type.Equals(TEXT("chat"), ESearchCase::IgnoreCase))
-		{
-			FString ChatText;
-			if (TryParseChatText(TrimmedJsonOrText, ChatText) && !ChatText.IsEmpty())
-			{
-				OnUserInputReceived.Broadcast(ChatText);
+	case EWebUIMessageType::PlainText:
+		// 不是 JSON 对象 -> 走纯文本兜底
+		OnUserInputReceived.Broadcast(Msg.Text);
+		OnSessionInputReceived.Broadcast(Msg.SessionId, Msg.Character, Msg.Text);
+		break;
 
-				// Extract requestId if present
-				FString RequestId;
-				Root->TryGetStringField(TEXT("requestId"), RequestId);
+	case EWebUIMessageType::Chat:
+		if (!Msg.Text.IsEmpty())
+		{
+			OnUserInputReceived.Broadcast(Msg.Text);
+			OnSessionInputReceived.Broadcast(Msg.SessionId, Msg.Character, Msg.Text);
 
-				// Send ACK response
-				SendPS2Response(true, RequestId, TEXT("Chat received"), false);
-			}
-			return;
+			// Send ACK response
+			SendPS2Response(true, Msg.RequestId, TEXT("Chat received"), false);
 		}
-		else if (Type.Equals(TEXT("call"), ESearchCase::IgnoreCase))
+		break;
+
+	case EWebUIMessageType::Call:
+		HandleCallRequest(Msg);
+		break;
+
+	case EWebUIMessageType::Batch:
+		HandleBatchRequest(Msg);
+		break;
+
+	case EWebUIMessageType::Subscribe:
+		HandleSubscribeRequest(Msg);
+		break;
+
+	case EWebUIMessageType::Unsubscribe:
+		HandleUnsubscribeRequest(Msg);
+		break;
+
+	default:
+		// 其它类型：按需扩展
+		if (Msg.TypeName.IsEmpty() && WarningLogLimiter.Allow())
 		{
-			HandleCallRequest(Root.ToSharedRef());
-			return;
+			UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Can not get type of from json"));
 		}
-	}else
-	{
-		UE_LOG(LogWebInterfaceSubsystem, Error, TEXT("Can not get type of from json"));
+		break;
 	}
-
-	// 其它类型：按需扩展
 }
 
-
-bool UWebInterfaceSubsystem::TryParseChatText(const FString& JsonString, FString& OutText) const
+bool UWebInterfaceSubsystem::FLogRateLimiter::Allow()
 {
-	UE_LOG(LogWebInterfaceSubsystem, Verbose, TEXT("Parsing Text Steam: %s"), *JsonString);
-	
-	OutText.Reset();
-
-	UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("TryParseChatText: %s"), *JsonString);
-
-	if (!JsonString.StartsWith(TEXT("{")) && !JsonString.StartsWith(TEXT("[")))
+	const double Now = FPlatformTime::Seconds();
+	if (Now - WindowStart >= 1.0)
 	{
-		return false;
+		if (NumSuppressed > 0)
+		{
+			UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("Suppressed %d log lines in the last second"), NumSuppressed);
+		}
+		WindowStart = Now;
+		NumLogged = 0;
+		NumSuppressed = 0;
 	}
 
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
-	TSharedPtr<FJsonObject> RootObj;
-	if (!FJsonSerializer::Deserialize(Reader, RootObj) || !RootObj.IsValid())
+	if (NumLogged < CVarWebInterfaceLogLinesPerSecond.GetValueOnGameThread())
 	{
-		UE_LOG(LogWebInterfaceSubsystem, Verbose, TEXT("JSON deserialize failed."));
-		return false;
+		++NumLogged;
+		return true;
 	}
-
-	FString Type;
-	if (!RootObj->TryGetStringField(TEXT("type"), Type)) return false;
-	if (!Type.Equals(TEXT("chat"), ESearchCase::IgnoreCase)) return false;
-
-	FString Text;
-	if (!RootObj->TryGetStringField(TEXT("text"), Text)) return false;
-
-	Text.TrimStartAndEndInline();
-	OutText = MoveTemp(Text);
-	return true;
+	++NumSuppressed;
+	return false;
 }
 
-void UWebInterfaceSubsystem::HandleCallRequest(const TSharedRef<FJsonObject>& Root)
+bool UWebInterfaceSubsystem::ExecuteCall(const FWebUIMessage& Call, TSharedPtr<FJsonValue>& OutResult, FString& OutError)
 {
-    // requestId 可选，用于前端对应
-    FString RequestId;
-    Root->TryGetStringField(TEXT("requestId"), RequestId);
-
-    const TSharedPtr<FJsonObject>* TargetObj = nullptr;
-    if (!Root->TryGetObjectField(TEXT("target"), TargetObj) || !TargetObj) { return; }
+    OutResult.Reset();
+    OutError.Reset();
 
-    FString By, Value;
-    (*TargetObj)->TryGetStringField(TEXT("by"), By);
-    (*TargetObj)->TryGetStringField(TEXT("value"), Value);
+    const FString& RequestId = Call.RequestId;
+    const FString& By = Call.TargetBy;
+    const FString& Value = Call.TargetValue;
+    const FString& ComponentName = Call.Component;
+    const FString& MethodName = Call.Method;
 
-    FString ComponentName, MethodName;
-    Root->TryGetStringField(TEXT("component"), ComponentName);
-    Root->TryGetStringField(TEXT("method"), MethodName);
+    if (By.IsEmpty())
+    {
+        OutError = TEXT("Target missing");
+        return false;
+    }
 
-	UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("Call %s: by=%s, Value=%s, component=%s, method=%s"),
+	UE_LOG(LogWebInterfaceSubsystem, Verbose, TEXT("Call %s: by=%s, Value=%s, component=%s, method=%s"),
 		*RequestId, *By, *Value, *ComponentName, *MethodName);
 
-    // 1) 找 Actor
-    AActor* TargetActor = nullptr;
-    if (By.Equals(TEXT("tag"), ESearchCase::IgnoreCase))
+    // 1) 找目标：id 查注册表，tag/name 查缓存，不再每次遍历关卡
+    UObject* Target = ResolveCallTarget(By, Value);
+    if (!Target)
     {
-        for (TActorIterator<AActor> It(GetWorld()); It; ++It)
-        {
-            if (It->ActorHasTag(*Value))
-            {
-                TargetActor = *It;
-                break;
-            }
-        }
+    	UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Request %s: Can not find actor %s"), *RequestId, *Value);
+        OutError = TEXT("Actor not found");
+        return false;
     }
-    else if (By.Equals(TEXT("name"), ESearchCase::IgnoreCase))
+
+    // 2) 找 Component；注册的目标本身是组件时直接用，Actor 目标未指定组件时调用 Actor 自身
+    UObject* Comp = Target;
+    if (AActor* TargetActor = Cast<AActor>(Target))
     {
-        for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+        if (!ComponentName.IsEmpty())
         {
-            if (It->GetName().Equals(Value, ESearchCase::IgnoreCase))
-            {
-                TargetActor = *It;
-                break;
-            }
+            Comp = ResolveComponent(TargetActor, ComponentName);
         }
     }
+    if (!Comp)
+    {
+    	UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Request %s: Can not find component %s"), *RequestId, *ComponentName);
+        OutError = TEXT("Component not found");
+        return false;
+    }
 
-    if (!TargetActor)
+    // 3) 找函数
+    UFunction* Func = ResolveFunction(Comp, MethodName);
+    if (!Func)
     {
-    	UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Request %s: Can not find actor %s"), *RequestId, *Value);
-        SendPS2Response(false, RequestId, TEXT("Actor not found"), false);
-        return;
+    	UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Request %s: Can not find web-callable function %s"), *RequestId, *MethodName);
+        OutError = TEXT("Method not found or not web-callable");
+        return false;
     }
 
-    // 2) 找 Component
-    UActorComponent* Comp = FindComponentByNameOrClass(TargetActor, ComponentName);
-    if (!Comp)
+    // 4) 转换参数、调用、取返回值
+    if (!InvokeUFunctionReturn(Comp, Func, Call.Args, OutResult, OutError))
     {
-    	UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Request %s: Can not find component %s"), *RequestId, *Value);
-        SendPS2Response(false, RequestId, TEXT("Component not found"), false);
-        return;
+    	UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Request %s: Call %s failed: %s"), *RequestId, *MethodName, *OutError);
+        return false;
     }
 
-    // 3) 反射调用无参函数（返回 bool/float/int/FString 都行；这里以 bool 为例）
-    const FName FuncName(*MethodName);
-    UFunction* Func = Comp->FindFunction(FuncName);
-    if (!Func)
+    if (!OutResult.IsValid())
     {
-    	UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Request %s: Can not find function %s"), *RequestId, *MethodName);
-        SendPS2Response(false, RequestId, TEXT("Method not found"), false);
-        return;
+        // 与旧版前端约定保持一致：无返回值时 result=false 并附说明
+        OutResult = MakeShared<FJsonValueBoolean>(false);
+        OutError = TEXT("OK (no return)");
     }
+    return true;
+}
 
-    // 调用并尝试取得返回值
-    struct FNoParams { }; FNoParams Params;
-    Comp->ProcessEvent(Func, &Params);
+void UWebInterfaceSubsystem::HandleCallRequest(const FWebUIMessage& Msg)
+{
+    TSharedPtr<FJsonValue> Result;
+    FString Error;
+    const bool bOk = ExecuteCall(Msg, Result, Error);
 
-    // 取返回值（如果函数有 ReturnValue 属性，UE 会生成同名 pin）
-    bool bHasReturn = false;
-    bool bReturnBool = false;
-    for (TFieldIterator<FProperty> It(Func); It; ++It)
+	UE_LOG(LogWebInterfaceSubsystem, Verbose, TEXT("Request %s: Responding ok=%d"), *Msg.RequestId, bOk ? 1 : 0);
+    BroadcastResponse(MakeResponseObject(bOk, Msg.RequestId, Error, Result));
+}
+
+void UWebInterfaceSubsystem::HandleBatchRequest(const FWebUIMessage& Msg)
+{
+    const TArray<TSharedPtr<FJsonValue>>* Calls = nullptr;
+    if (!Msg.Json.IsValid() || !Msg.Json->TryGetArrayField(TEXT("calls"), Calls) || !Calls)
     {
-        if (It->HasAnyPropertyFlags(CPF_ReturnParm))
-        {
-            if (FBoolProperty* BP = CastField<FBoolProperty>(*It))
-            {
-                bHasReturn = true;
-                bReturnBool = BP->GetPropertyValue_InContainer(&Params);
-            }
-            // 你也可以扩展 FString/float/int 等类型
-            break;
-        }
+        BroadcastResponse(MakeResponseObject(false, Msg.RequestId, TEXT("Batch has no calls"), nullptr));
+        return;
     }
 
-    if (bHasReturn)
+    const int32 MaxCalls = CVarWebInterfaceMaxBatchCalls.GetValueOnGameThread();
+    if (Calls->Num() > MaxCalls)
     {
-    	FString returnBoolString = bReturnBool ? TEXT("true") : TEXT("false");
-    	UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("Request %s: Responding result as %s"), *RequestId, *returnBoolString);
-        SendPS2Response(true, RequestId, FString(), TOptional<bool>(bReturnBool));
+        BroadcastResponse(MakeResponseObject(false, Msg.RequestId, FString::Printf(TEXT("Batch too large (%d > %d)"), Calls->Num(), MaxCalls), nullptr));
+        return;
     }
-    else
+
+    // 依次执行，每条结果按顺序放进 results，前端用下标或各自的 requestId 对应
+    TArray<TSharedPtr<FJsonValue>> Results;
+    Results.Reserve(Calls->Num());
+    int32 NumFailed = 0;
+    for (const TSharedPtr<FJsonValue>& CallValue : *Calls)
     {
-    	
-    	UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("Request %s: Responding empty response"), *RequestId);
-        SendPS2Response(true, RequestId, TEXT("OK (no return)"), false);
+        FWebUIMessage Call;
+        TSharedPtr<FJsonValue> Result;
+        FString Error;
+        bool bOk = false;
+
+        const TSharedPtr<FJsonObject>* CallObj = nullptr;
+        if (CallValue.IsValid() && CallValue->TryGetObject(CallObj) && FWebUIMessage::FromJsonObject(*CallObj, Call, EWebUIMessageType::Call)
+            && Call.Type == EWebUIMessageType::Call)
+        {
+            bOk = ExecuteCall(Call, Result, Error);
+        }
+        else
+        {
+            Error = TEXT("Invalid call");
+        }
+
+        NumFailed += bOk ? 0 : 1;
+        Results.Add(MakeShared<FJsonValueObject>(MakeResponseObject(bOk, Call.RequestId, Error, Result)));
     }
+
+    TSharedRef<FJsonObject> Response = MakeResponseObject(NumFailed == 0, Msg.RequestId,
+        NumFailed > 0 ? FString::Printf(TEXT("%d of %d calls failed"), NumFailed, Calls->Num()) : FString(), nullptr);
+    Response->SetArrayField(TEXT("results"), Results);
+    BroadcastResponse(Response);
 }
 
 // 在 Subsystem 里，把要发的 JSON 串好并广播
 void UWebInterfaceSubsystem::SendPS2Response(bool bOk, const FString& RequestId, const FString& ErrorMsg, TOptional<bool> BoolResult)
 {
-	TSharedPtr<FJsonObject> Obj = MakeShared<FJsonObject>();
-	Obj->SetStringField(TEXT("type"), TEXT("response"));
-	if (!RequestId.IsEmpty()) Obj->SetStringField(TEXT("requestId"), RequestId);
-	Obj->SetBoolField(TEXT("ok"), bOk);
-	if (!ErrorMsg.IsEmpty()) Obj->SetStringField(TEXT("error"), ErrorMsg);
-	if (BoolResult.IsSet()) Obj->SetBoolField(TEXT("result"), BoolResult.GetValue());
+	TSharedPtr<FJsonValue> Result;
+	if (BoolResult.IsSet()) Result = MakeShared<FJsonValueBoolean>(BoolResult.GetValue());
+	BroadcastResponse(MakeResponseObject(bOk, RequestId, ErrorMsg, Result));
+}
+
+void UWebInterfaceSubsystem::BroadcastResponse(const TSharedRef<FJsonObject>& Response)
+{
+	OutboundQueue.Add(MakeShared<FJsonValueObject>(Response));
+	if (!CVarWebInterfaceCoalesceOutbound.GetValueOnGameThread())
+	{
+		SendFrame(OutboundQueue);
+	}
+}
+
+void UWebInterfaceSubsystem::SendFrame(TArray<TSharedPtr<FJsonValue>>& Messages)
+{
+	if (Messages.Num() == 0) return;
+
+	// 单条消息保持原格式，旧前端可以直接按 requestId 匹配
+	TSharedPtr<FJsonObject> Frame;
+	if (Messages.Num() == 1)
+	{
+		Frame = Messages[0]->AsObject();
+	}
+	else
+	{
+		Frame = MakeShared<FJsonObject>();
+		Frame->SetStringField(TEXT("type"), TEXT("frame"));
+		Frame->SetArrayField(TEXT("messages"), Messages);
+	}
+	Messages.Reset();
 
 	FString Out;
-	TSharedRef<TJsonWriter<>> W = TJsonWriterFactory<>::Create(&Out);
-	FJsonSerializer::Serialize(Obj.ToSharedRef(), W);
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> W = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Out);
+	FJsonSerializer::Serialize(Frame.ToSharedRef(), W);
 
 	// 交给蓝图层去“Send Pixel Streaming Response”
 	OnSendPS2Response.Broadcast(Out);
 }
 
+bool UWebInterfaceSubsystem::FlushOutbound(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	if (Now >= NextSessionSweepTime)
+	{
+		NextSessionSweepTime = Now + 1.0;
+		ExpireSessions(Now);
+	}
+
+	// 订阅：到了各自的最小间隔才采样，和上次发出的值不同才放进本帧的 state 消息；每个会话一条，带上 sessionId 由前端过滤
+	for (TPair<FString, TMap<FString, FStateSubscription>>& Session : Subscriptions)
+	{
+		TSharedPtr<FJsonObject> Changes;
+		for (TPair<FString, FStateSubscription>& Pair : Session.Value)
+		{
+			FStateSubscription& Sub = Pair.Value;
+			if (Now - Sub.LastSentTime < Sub.MinInterval) continue;
+
+			TSharedPtr<FJsonValue> Value = SampleSubscription(Sub);
+			if (Sub.LastSent.IsValid() && FJsonValue::CompareEqual(*Sub.LastSent, *Value)) continue;
+
+			if (!Changes.IsValid()) Changes = MakeShared<FJsonObject>();
+			Changes->SetField(Pair.Key, Value);
+			Sub.LastSent = Value;
+			Sub.LastSentTime = Now;
+		}
+
+		if (Changes.IsValid())
+		{
+			TSharedRef<FJsonObject> State = MakeShared<FJsonObject>();
+			State->SetStringField(TEXT("type"), TEXT("state"));
+			if (!Session.Key.IsEmpty()) State->SetStringField(TEXT("sessionId"), Session.Key);
+			State->SetObjectField(TEXT("changes"), Changes);
+			OutboundQueue.Add(MakeShared<FJsonValueObject>(State));
+		}
+	}
 
-AActor* UWebInterfaceSubsystem::FindTargetActor(const FString& By, const FString& Value) const
+	SendFrame(OutboundQueue);
+	return true;
+}
+
+bool UWebInterfaceSubsystem::TouchSession(const FString& SessionId)
 {
-	UWorld* World = GetWorld();
-	if (!World) return nullptr;
+	// 空 sessionId 是默认会话（蓝图、旧前端），不计数也不过期
+	if (SessionId.IsEmpty()) return true;
+
+	const double Now = FPlatformTime::Seconds();
+	if (double* LastSeen = SessionLastSeen.Find(SessionId))
+	{
+		*LastSeen = Now;
+		return true;
+	}
+	if (SessionLastSeen.Num() >= FMath::Max(1, CVarWebInterfaceMaxSessions.GetValueOnGameThread()))
+	{
+		return false;
+	}
+	SessionLastSeen.Add(SessionId, Now);
+	return true;
+}
 
-	if (By.Equals(TEXT("tag"), ESearchCase::IgnoreCase))
+void UWebInterfaceSubsystem::CloseSession(const FString& SessionId)
+{
+	Subscriptions.Remove(SessionId);
+	if (SessionLastSeen.Remove(SessionId) > 0)
 	{
-		TArray<AActor*> Found;
-		UGameplayStatics::GetAllActorsWithTag(World, FName(*Value), Found);
-		return Found.Num() > 0 ? Found[0] : nullptr;
+		UE_LOG(LogWebInterfaceSubsystem, Log, TEXT("Web session closed: %s"), *SessionId);
+		OnSessionClosed.Broadcast(SessionId);
 	}
-	else if (By.Equals(TEXT("name"), ESearchCase::IgnoreCase))
+}
+
+void UWebInterfaceSubsystem::ExpireSessions(double Now)
+{
+	const double Lease = CVarWebInterfaceSessionLeaseSeconds.GetValueOnGameThread();
+	if (Lease <= 0.0) return;
+
+	TArray<FString, TInlineAllocator<8>> Expired;
+	for (const TPair<FString, double>& Pair : SessionLastSeen)
 	{
-		for (TActorIterator<AActor> It(World); It; ++It)
+		if (Now - Pair.Value > Lease)
 		{
-			AActor* A = *It;
-			// 兼容精确名与包含匹配（避免 PIE 后缀、_C 等差异）
-			if (A->GetName().Equals(Value, ESearchCase::IgnoreCase) || A->GetName().Contains(Value))
+			Expired.Add(Pair.Key);
+		}
+	}
+	for (const FString& SessionId : Expired)
+	{
+		CloseSession(SessionId);
+	}
+}
+
+TSharedPtr<FJsonValue> UWebInterfaceSubsystem::SampleSubscription(FStateSubscription& Sub, FString* OutError)
+{
+	if (Sub.Property.IsNone())
+	{
+		const TSharedPtr<FJsonValue>* Published = PublishedState.Find(Sub.PublishedKey);
+		return Published ? *Published : TSharedPtr<FJsonValue>(MakeShared<FJsonValueNull>());
+	}
+
+	UObject* Owner = Sub.Owner.Get();
+	if (!Owner || !Sub.CachedProperty)
+	{
+		Sub.CachedProperty = nullptr;
+		Owner = ResolveCallTarget(Sub.TargetBy, Sub.TargetValue);
+		if (AActor* OwnerActor = Cast<AActor>(Owner))
+		{
+			if (!Sub.Component.IsEmpty())
 			{
-				return A;
+				Owner = ResolveComponent(OwnerActor, Sub.Component);
 			}
 		}
+		if (!Owner)
+		{
+			if (OutError) *OutError = TEXT("Target not found");
+			return MakeShared<FJsonValueNull>();
+		}
+
+		// 和 call 一样只开放蓝图可见、且经 AllowWebProperty 登记过的属性
+		const FProperty* Property = FindFProperty<FProperty>(Owner->GetClass(), Sub.Property);
+		if (!Property || !Property->HasAnyPropertyFlags(CPF_BlueprintVisible) || !IsAllowedForClass(WebPropertyAllowlist, Owner->GetClass(), Sub.Property))
+		{
+			if (OutError) *OutError = TEXT("Property not found or not web-visible");
+			return MakeShared<FJsonValueNull>();
+		}
+		Sub.CachedProperty = Property;
+		Sub.Owner = Owner;
+	}
+
+	TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(const_cast<FProperty*>(Sub.CachedProperty), Sub.CachedProperty->ContainerPtrToValuePtr<void>(Owner));
+	return Value.IsValid() ? Value : TSharedPtr<FJsonValue>(MakeShared<FJsonValueNull>());
+}
+
+void UWebInterfaceSubsystem::HandleSubscribeRequest(const FWebUIMessage& Msg)
+{
+	FString Key;
+	if (!Msg.Json->TryGetStringField(TEXT("key"), Key))
+	{
+		Key = Msg.Property;
+	}
+	if (Key.IsEmpty())
+	{
+		BroadcastResponse(MakeResponseObject(false, Msg.RequestId, TEXT("Subscription key missing"), nullptr));
+		return;
+	}
+	if (!Msg.Property.IsEmpty() && Msg.TargetBy.IsEmpty())
+	{
+		BroadcastResponse(MakeResponseObject(false, Msg.RequestId, TEXT("Target missing"), nullptr));
+		return;
+	}
+
+	const TMap<FString, FStateSubscription>* SessionSubs = Subscriptions.Find(Msg.SessionId);
+	if (SessionSubs && !SessionSubs->Contains(Key) && SessionSubs->Num() >= FMath::Max(1, CVarWebInterfaceMaxSubscriptionsPerSession.GetValueOnGameThread()))
+	{
+		BroadcastResponse(MakeResponseObject(false, Msg.RequestId, TEXT("Too many subscriptions"), nullptr));
+		return;
+	}
+
+	// 名字只查不建：前端填的 key / property 不在 FName 表里就不可能是已发布的 key 或反射属性
+	FStateSubscription Sub;
+	if (Msg.Property.IsEmpty())
+	{
+		Sub.PublishedKey = FName(*Key, FNAME_Find);
+		if (Sub.PublishedKey.IsNone())
+		{
+			BroadcastResponse(MakeResponseObject(false, Msg.RequestId, TEXT("Unknown state key"), nullptr));
+			return;
+		}
+	}
+	else
+	{
+		Sub.Property = FName(*Msg.Property, FNAME_Find);
+		if (Sub.Property.IsNone())
+		{
+			BroadcastResponse(MakeResponseObject(false, Msg.RequestId, TEXT("Property not found or not web-visible"), nullptr));
+			return;
+		}
+	}
+
+	// maxHz 缺省或不大于 0 时分别取默认值和上限，超过上限的按上限
+	const double HzLimit = FMath::Max(0.1f, CVarWebInterfaceMaxSubscribeHz.GetValueOnGameThread());
+	double MaxHz = CVarWebInterfaceDefaultSubscribeHz.GetValueOnGameThread();
+	Msg.Json->TryGetNumberField(TEXT("maxHz"), MaxHz);
+	MaxHz = MaxHz > 0.0 ? FMath::Min(MaxHz, HzLimit) : HzLimit;
+
+	Sub.TargetBy = Msg.TargetBy;
+	Sub.TargetValue = Msg.TargetValue;
+	Sub.Component = Msg.Component;
+	Sub.MinInterval = 1.0 / MaxHz;
+
+	// 订阅时直接回当前值，之后只推送变化
+	FString Error;
+	TSharedPtr<FJsonValue> Current = SampleSubscription(Sub, &Error);
+	if (!Error.IsEmpty())
+	{
+		BroadcastResponse(MakeResponseObject(false, Msg.RequestId, Error, nullptr));
+		return;
+	}
+
+	Sub.LastSent = Current;
+	Sub.LastSentTime = FPlatformTime::Seconds();
+	Subscriptions.FindOrAdd(Msg.SessionId).Add(Key, MoveTemp(Sub));
+
+	BroadcastResponse(MakeResponseObject(true, Msg.RequestId, FString(), Current));
+}
+
+void UWebInterfaceSubsystem::HandleUnsubscribeRequest(const FWebUIMessage& Msg)
+{
+	FString Key;
+	Msg.Json->TryGetStringField(TEXT("key"), Key);
+	if (Key == TEXT("*"))
+	{
+		Subscriptions.Remove(Msg.SessionId);
+	}
+	else if (TMap<FString, FStateSubscription>* SessionSubs = Subscriptions.Find(Msg.SessionId))
+	{
+		SessionSubs->Remove(Key);
+		if (SessionSubs->Num() == 0)
+		{
+			Subscriptions.Remove(Msg.SessionId);
+		}
+	}
+	BroadcastResponse(MakeResponseObject(true, Msg.RequestId, FString(), nullptr));
+}
+
+void UWebInterfaceSubsystem::PublishState(FName Key, const TSharedPtr<FJsonValue>& Value)
+{
+	PublishedState.Add(Key, Value.IsValid() ? Value : TSharedPtr<FJsonValue>(MakeShared<FJsonValueNull>()));
+}
+
+void UWebInterfaceSubsystem::PublishStateBool(FName Key, bool bValue)
+{
+	PublishState(Key, MakeShared<FJsonValueBoolean>(bValue));
+}
+
+void UWebInterfaceSubsystem::PublishStateNumber(FName Key, float Value)
+{
+	PublishState(Key, MakeShared<FJsonValueNumber>(Value));
+}
+
+void UWebInterfaceSubsystem::PublishStateString(FName Key, const FString& Value)
+{
+	PublishState(Key, MakeShared<FJsonValueString>(Value));
+}
+
+void UWebInterfaceSubsystem::RegisterCallTarget(FName TargetId, UObject* Target)
+{
+	if (TargetId.IsNone() || !IsValid(Target))
+	{
+		UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("RegisterCallTarget: invalid id or target"));
+		return;
+	}
+
+	if (const TWeakObjectPtr<UObject>* Existing = CallTargets.Find(TargetId))
+	{
+		if (Existing->IsValid() && Existing->Get() != Target)
+		{
+			UE_LOG(LogWebInterfaceSubsystem, Warning, TEXT("Call target %s re-registered: %s replaces %s"),
+				*TargetId.ToString(), *Target->GetName(), *Existing->Get()->GetName());
+		}
+	}
+	CallTargets.Add(TargetId, Target);
+
+	AActor* OwnerActor = Cast<AActor>(Target);
+	if (!OwnerActor)
+	{
+		OwnerActor = Target->GetTypedOuter<AActor>();
+	}
+	if (OwnerActor)
+	{
+		WatchActor(OwnerActor);
+	}
+}
+
+void UWebInterfaceSubsystem::UnregisterCallTarget(FName TargetId, UObject* Target)
+{
+	const TWeakObjectPtr<UObject>* Existing = CallTargets.Find(TargetId);
+	if (Existing && (Target == nullptr || Existing->Get(/*bEvenIfGarbage*/ true) == Target))
+	{
+		CallTargets.Remove(TargetId);
+	}
+}
+
+UObject* UWebInterfaceSubsystem::ResolveCallTarget(const FString& By, const FString& Value)
+{
+	if (By.Equals(TEXT("id"), ESearchCase::IgnoreCase))
+	{
+		// 注册过的 Id 一定已在 FName 表里，查不到就不用建新名字
+		const FName TargetId(*Value, FNAME_Find);
+		const TWeakObjectPtr<UObject>* Found = TargetId.IsNone() ? nullptr : CallTargets.Find(TargetId);
+		return Found ? Found->Get() : nullptr;
+	}
+
+	const bool bByTag = By.Equals(TEXT("tag"), ESearchCase::IgnoreCase);
+	if (!bByTag && !By.Equals(TEXT("name"), ESearchCase::IgnoreCase))
+	{
+		return nullptr;
+	}
+
+	UWorld* World = GetWorld();
+	if (!World) return nullptr;
+
+	const FName Tag = bByTag ? FName(*Value, FNAME_Find) : NAME_None;
+	if (bByTag && Tag.IsNone()) return nullptr;
+
+	auto Matches = [bByTag, &Tag, &Value](AActor* Actor)
+	{
+		return bByTag ? Actor->ActorHasTag(Tag) : Actor->GetName().Equals(Value, ESearchCase::IgnoreCase);
+	};
+
+	const FString CacheKey = FString::Printf(TEXT("%s:%s"), bByTag ? TEXT("tag") : TEXT("name"), *Value.ToLower());
+	if (const TWeakObjectPtr<AActor>* Cached = ActorLookupCache.Find(CacheKey))
+	{
+		// 命中后仍校验一次：tag 可能在运行时被改，关卡也可能已切换
+		AActor* Actor = Cached->Get();
+		if (IsValid(Actor) && Actor->GetWorld() == World && Matches(Actor))
+		{
+			return Actor;
+		}
+		ActorLookupCache.Remove(CacheKey);
+	}
+
+	// 未命中才遍历一次，并写回缓存
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		if (Matches(*It))
+		{
+			ActorLookupCache.Add(CacheKey, *It);
+			WatchActor(*It);
+			return *It;
+		}
 	}
 	return nullptr;
 }
 
-bool UWebInterfaceSubsystem::InvokeUFunctionReturn(UObject* Target, const FString& MethodName, TSharedPtr<FJsonValue>& ResultOut, FString& ErrorOut) const
+UActorComponent* UWebInterfaceSubsystem::ResolveComponent(AActor* Actor, const FString& NameOrClass)
+{
+	// 组件名和类名都已在 FName 表里，查不到说明不存在
+	const FName Name(*NameOrClass, FNAME_Find);
+	if (Name.IsNone()) return nullptr;
+
+	const TPair<FObjectKey, FName> Key(FObjectKey(Actor), Name);
+	if (const TWeakObjectPtr<UActorComponent>* Cached = ComponentCache.Find(Key))
+	{
+		UActorComponent* Comp = Cached->Get();
+		if (IsValid(Comp) && Comp->GetOwner() == Actor)
+		{
+			return Comp;
+		}
+		ComponentCache.Remove(Key);
+	}
+
+	UActorComponent* Comp = FindComponentByNameOrClass(Actor, NameOrClass);
+	if (Comp)
+	{
+		ComponentCache.Add(Key, Comp);
+		WatchActor(Actor);
+	}
+	return Comp;
+}
+
+UFunction* UWebInterfaceSubsystem::ResolveFunction(UObject* Target, const FString& MethodName)
+{
+	const FName FuncName(*MethodName, FNAME_Find);
+	if (FuncName.IsNone()) return nullptr;
+
+	const TPair<FObjectKey, FName> Key(FObjectKey(Target->GetClass()), FuncName);
+	if (const TWeakObjectPtr<UFunction>* Cached = FunctionCache.Find(Key))
+	{
+		if (UFunction* Func = Cached->Get())
+		{
+			return Func;
+		}
+	}
+
+	// 前端能调用的只有蓝图可调用、且显式登记过的函数，其余（包括 Exec、网络 RPC、内部函数）一律拒绝，也不进缓存
+	UFunction* Func = Target->FindFunction(FuncName);
+	if (!Func || !Func->HasAnyFunctionFlags(FUNC_BlueprintCallable) || !IsAllowedForClass(WebCallAllowlist, Target->GetClass(), FuncName))
+	{
+		return nullptr;
+	}
+	FunctionCache.Add(Key, Func);
+	return Func;
+}
+
+void UWebInterfaceSubsystem::AllowWebCall(UClass* Class, FName FunctionName)
+{
+	if (Class && !FunctionName.IsNone())
+	{
+		WebCallAllowlist.Add(TPair<FObjectKey, FName>(FObjectKey(Class), FunctionName));
+	}
+}
+
+void UWebInterfaceSubsystem::AllowWebProperty(UClass* Class, FName PropertyName)
+{
+	if (Class && !PropertyName.IsNone())
+	{
+		WebPropertyAllowlist.Add(TPair<FObjectKey, FName>(FObjectKey(Class), PropertyName));
+	}
+}
+
+void UWebInterfaceSubsystem::WatchActor(AActor* Actor)
+{
+	bool bAlreadyWatched = false;
+	WatchedActors.Add(FObjectKey(Actor), &bAlreadyWatched);
+	if (!bAlreadyWatched)
+	{
+		Actor->OnDestroyed.AddDynamic(this, &UWebInterfaceSubsystem::HandleCallTargetDestroyed);
+	}
+}
+
+void UWebInterfaceSubsystem::HandleCallTargetDestroyed(AActor* DestroyedActor)
+{
+	const FObjectKey ActorKey(DestroyedActor);
+	WatchedActors.Remove(ActorKey);
+
+	// Actor 此时已标记销毁，用 bEvenIfGarbage 取出来比较
+	for (auto It = CallTargets.CreateIterator(); It; ++It)
+	{
+		UObject* Target = It->Value.Get(/*bEvenIfGarbage*/ true);
+		if (!Target || Target == DestroyedActor || Target->GetTypedOuter<AActor>() == DestroyedActor)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	for (auto It = ActorLookupCache.CreateIterator(); It; ++It)
+	{
+		AActor* Actor = It->Value.Get(/*bEvenIfGarbage*/ true);
+		if (!Actor || Actor == DestroyedActor)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	for (auto It = ComponentCache.CreateIterator(); It; ++It)
+	{
+		if (It->Key.Key == ActorKey || !It->Value.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UWebInterfaceSubsystem::InvokeUFunctionReturn(UObject* Target, UFunction* Func, const TSharedPtr<FJsonValue>& Args, TSharedPtr<FJsonValue>& ResultOut, FString& ErrorOut) const
 {
 	ResultOut.Reset();
 	ErrorOut.Reset();
 
-	if (!Target)
+	if (!Target || !Func)
 	{
 		ErrorOut = TEXT("Target is null");
 		return false;
 	}
 
-	UFunction* Func = Target->FindFunction(FName(*MethodName));
-	if (!Func)
+	// args 为对象时按参数名匹配（不区分大小写），为数组时按参数顺序匹配
+	const TSharedPtr<FJsonObject>* NamedArgs = nullptr;
+	const TArray<TSharedPtr<FJsonValue>>* PositionalArgs = nullptr;
+	if (Args.IsValid() && !Args->IsNull() && !Args->TryGetObject(NamedArgs) && !Args->TryGetArray(PositionalArgs))
 	{
-		ErrorOut = FString::Printf(TEXT("Method '%s' not found"), *MethodName);
+		ErrorOut = TEXT("args must be an object or an array");
 		return false;
 	}
 
-	// 目前示例方法没有参数；如需支持参数，可从 RootObj->GetObjectField("args") 解析并填充 Params
-	TArray<uint8> Params;
-	Params.SetNumZeroed(Func->ParmsSize);
-
-	Target->ProcessEvent(Func, Params.GetData());
+	// 参数缓冲区按 ProcessEvent 的方式对齐并构造，结束时析构
+	uint8* Params = Func->ParmsSize > 0 ? static_cast<uint8*>(FMemory_Alloca_Aligned(Func->ParmsSize, Func->GetMinAlignment())) : nullptr;
+	if (Params)
+	{
+		FMemory::Memzero(Params, Func->ParmsSize);
+	}
+	for (TFieldIterator<FProperty> It(Func); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+	{
+		It->InitializeValue_InContainer(Params);
+	}
+	ON_SCOPE_EXIT
+	{
+		for (TFieldIterator<FProperty> It(Func); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			It->DestroyValue_InContainer(Params);
+		}
+	};
 
-	// 读取返回值（支持常见基础类型；当前示例为 bool）
-	if (FProperty* RetProp = Func->GetReturnProperty())
+	// 填输入参数：普通参数和 const 引用
+	int32 ArgIndex = 0;
+	for (TFieldIterator<FProperty> It(Func); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
 	{
-		if (FBoolProperty* BP = CastField<FBoolProperty>(RetProp))
+		FProperty* Prop = *It;
+		const bool bIsInput = !Prop->HasAnyPropertyFlags(CPF_ReturnParm)
+			&& (!Prop->HasAnyPropertyFlags(CPF_OutParm) || Prop->HasAnyPropertyFlags(CPF_ReferenceParm));
+		if (!bIsInput) continue;
+
+		TSharedPtr<FJsonValue> ArgValue;
+		if (NamedArgs)
 		{
-			const bool b = BP->GetPropertyValue_InContainer(Params.GetData());
-			ResultOut = MakeShared<FJsonValueBoolean>(b);
-			return true;
+			ArgValue = (*NamedArgs)->TryGetField(Prop->GetName());
 		}
-		else if (FIntProperty* IP = CastField<FIntProperty>(RetProp))
+		else if (PositionalArgs && PositionalArgs->IsValidIndex(ArgIndex))
 		{
-			ResultOut = MakeShared<FJsonValueNumber>(IP->GetPropertyValue_InContainer(Params.GetData()));
-			return true;
+			ArgValue = (*PositionalArgs)[ArgIndex];
 		}
-		else if (FFloatProperty* FP = CastField<FFloatProperty>(RetProp))
+		++ArgIndex;
+
+		if (!ArgValue.IsValid())
 		{
-			ResultOut = MakeShared<FJsonValueNumber>(FP->GetPropertyValue_InContainer(Params.GetData()));
-			return true;
+			ErrorOut = FString::Printf(TEXT("Missing argument '%s'"), *Prop->GetName());
+			return false;
 		}
-		else if (FStrProperty* SP = CastField<FStrProperty>(RetProp))
+		if (!JsonToParam(ArgValue, Prop, Prop->ContainerPtrToValuePtr<void>(Params)))
 		{
-			ResultOut = MakeShared<FJsonValueString>(SP->GetPropertyValue_InContainer(Params.GetData()));
-			return true;
+			ErrorOut = FString::Printf(TEXT("Invalid value for argument '%s' (%s)"), *Prop->GetName(), *Prop->GetCPPType());
+			return false;
+		}
+	}
+
+	Target->ProcessEvent(Func, Params);
+
+	// 读取返回值与输出参数
+	TSharedPtr<FJsonObject> Outputs;
+	TSharedPtr<FJsonValue> ReturnValue;
+	for (TFieldIterator<FProperty> It(Func); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+	{
+		FProperty* Prop = *It;
+		const bool bIsReturn = Prop->HasAnyPropertyFlags(CPF_ReturnParm);
+		const bool bIsOutput = bIsReturn || (Prop->HasAnyPropertyFlags(CPF_OutParm) && !Prop->HasAnyPropertyFlags(CPF_ConstParm));
+		if (!bIsOutput) continue;
+
+		TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(Prop, Prop->ContainerPtrToValuePtr<void>(Params));
+		if (!Value.IsValid())
+		{
+			Value = MakeShared<FJsonValueNull>();
+		}
+
+		if (bIsReturn)
+		{
+			ReturnValue = Value;
+		}
+		if (!bIsReturn || Outputs.IsValid())
+		{
+			if (!Outputs.IsValid())
+			{
+				Outputs = MakeShared<FJsonObject>();
+				if (ReturnValue.IsValid()) Outputs->SetField(TEXT("ReturnValue"), ReturnValue);
+			}
+			Outputs->SetField(Prop->GetName(), Value);
 		}
-		// 可按需扩展更多类型（FName、FVector 等转 JSON）
 	}
 
-	// 没有返回值也算成功
+	// 只有返回值时直接给值；有输出参数时给对象
+	if (Outputs.IsValid())
+	{
+		ResultOut = MakeShared<FJsonValueObject>(Outputs);
+	}
+	else
+	{
+		ResultOut = ReturnValue;
+	}
 	return true;
 }
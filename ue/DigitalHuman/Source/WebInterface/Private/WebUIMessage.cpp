@@ -0,0 +1,220 @@
+// WebUIMessage.cpp
+#include "WebUIMessage.h"
+
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+static int32 HexDigitValue(TCHAR C)
+{
+	if (C >= TEXT('0') && C <= TEXT('9')) return C - TEXT('0');
+	if (C >= TEXT('a') && C <= TEXT('f')) return C - TEXT('a') + 10;
+	if (C >= TEXT('A') && C <= TEXT('F')) return C - TEXT('A') + 10;
+	return -1;
+}
+
+static bool ReadHex4(const FString& In, int32 Index, uint32& OutCode)
+{
+	if (Index + 4 > In.Len()) return false;
+	OutCode = 0;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		const int32 Digit = HexDigitValue(In[Index + i]);
+		if (Digit < 0) return false;
+		OutCode = (OutCode << 4) | static_cast<uint32>(Digit);
+	}
+	return true;
+}
+
+static void AppendCodePoint(FString& Out, uint32 CodePoint)
+{
+	if (sizeof(TCHAR) == 2 && CodePoint > 0xFFFF)
+	{
+		CodePoint -= 0x10000;
+		Out.AppendChar(static_cast<TCHAR>(0xD800 + (CodePoint >> 10)));
+		Out.AppendChar(static_cast<TCHAR>(0xDC00 + (CodePoint & 0x3FF)));
+	}
+	else
+	{
+		Out.AppendChar(static_cast<TCHAR>(CodePoint));
+	}
+}
+
+/** 把 JSON 字符串字面量的内容（不含两端引号）还原，一次线性扫描 */
+static bool UnescapeJsonString(const FString& In, FString& Out)
+{
+	Out.Reset(In.Len());
+	for (int32 i = 0; i < In.Len(); ++i)
+	{
+		const TCHAR C = In[i];
+		if (C != TEXT('\\'))
+		{
+			Out.AppendChar(C);
+			continue;
+		}
+
+		if (++i >= In.Len()) return false;
+		switch (In[i])
+		{
+		case TEXT('"'):  Out.AppendChar(TEXT('"'));  break;
+		case TEXT('\\'): Out.AppendChar(TEXT('\\')); break;
+		case TEXT('/'):  Out.AppendChar(TEXT('/'));  break;
+		case TEXT('b'):  Out.AppendChar(TEXT('\b')); break;
+		case TEXT('f'):  Out.AppendChar(TEXT('\f')); break;
+		case TEXT('n'):  Out.AppendChar(TEXT('\n')); break;
+		case TEXT('r'):  Out.AppendChar(TEXT('\r')); break;
+		case TEXT('t'):  Out.AppendChar(TEXT('\t')); break;
+		case TEXT('u'):
+		{
+			uint32 Code = 0;
+			if (!ReadHex4(In, i + 1, Code)) return false;
+			i += 4;
+
+			// 代理对合成一个码点
+			uint32 Low = 0;
+			if (Code >= 0xD800 && Code < 0xDC00 && i + 2 < In.Len() && In[i + 1] == TEXT('\\') && In[i + 2] == TEXT('u')
+				&& ReadHex4(In, i + 3, Low) && Low >= 0xDC00 && Low < 0xE000)
+			{
+				Code = 0x10000 + ((Code - 0xD800) << 10) + (Low - 0xDC00);
+				i += 6;
+			}
+			AppendCodePoint(Out, Code);
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+static TSharedPtr<FJsonObject> DeserializeObject(const FString& JsonString)
+{
+	TSharedPtr<FJsonObject> Obj;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+	if (!FJsonSerializer::Deserialize(Reader, Obj))
+	{
+		return nullptr;
+	}
+	return Obj;
+}
+
+bool FWebUIMessage::Parse(const FString& Raw, FWebUIMessage& Out)
+{
+	Out = FWebUIMessage();
+
+	FString Body = Raw.TrimStartAndEnd();
+
+	// 前端可能把 JSON 再字符串化一次："{\"type\":\"chat\",...}"，先去掉这一层
+	if (Body.Len() >= 2 && Body[0] == TEXT('"') && Body[Body.Len() - 1] == TEXT('"'))
+	{
+		FString Inner;
+		if (UnescapeJsonString(Body.Mid(1, Body.Len() - 2), Inner))
+		{
+			Body = MoveTemp(Inner);
+		}
+		else
+		{
+			Body.MidInline(1, Body.Len() - 2);
+		}
+		Body.TrimStartAndEndInline();
+	}
+
+	if (Body.IsEmpty())
+	{
+		return false;
+	}
+
+	// 非 JSON：整条当作聊天文本
+	if (Body[0] != TEXT('{'))
+	{
+		if (Body[0] == TEXT('['))
+		{
+			return false;
+		}
+		Out.Type = EWebUIMessageType::PlainText;
+		Out.Text = MoveTemp(Body);
+		return true;
+	}
+
+	TSharedPtr<FJsonObject> Root = DeserializeObject(Body);
+	if (!Root.IsValid() && Body.Contains(TEXT("\\\"")))
+	{
+		// 兜底：转义过但没有外层引号的消息
+		FString Unescaped;
+		if (UnescapeJsonString(Body, Unescaped))
+		{
+			Root = DeserializeObject(Unescaped);
+		}
+	}
+	if (!Root.IsValid())
+	{
+		return false;
+	}
+
+	return FromJsonObject(Root, Out);
+}
+
+/** call / subscribe 共用的 target + component */
+static void ReadTarget(const TSharedPtr<FJsonObject>& Root, FWebUIMessage& Out)
+{
+	const TSharedPtr<FJsonObject>* TargetObj = nullptr;
+	if (Root->TryGetObjectField(TEXT("target"), TargetObj) && TargetObj && TargetObj->IsValid())
+	{
+		(*TargetObj)->TryGetStringField(TEXT("by"), Out.TargetBy);
+		(*TargetObj)->TryGetStringField(TEXT("value"), Out.TargetValue);
+	}
+	Root->TryGetStringField(TEXT("component"), Out.Component);
+}
+
+bool FWebUIMessage::FromJsonObject(const TSharedPtr<FJsonObject>& Root, FWebUIMessage& Out, EWebUIMessageType DefaultType)
+{
+	Out = FWebUIMessage();
+	if (!Root.IsValid())
+	{
+		return false;
+	}
+
+	Root->TryGetStringField(TEXT("type"), Out.TypeName);
+	Root->TryGetStringField(TEXT("requestId"), Out.RequestId);
+	if (!Root->TryGetStringField(TEXT("sessionId"), Out.SessionId))
+	{
+		Root->TryGetStringField(TEXT("playerId"), Out.SessionId);
+	}
+
+	if (Out.TypeName.Equals(TEXT("chat"), ESearchCase::IgnoreCase))
+	{
+		Out.Type = EWebUIMessageType::Chat;
+		Root->TryGetStringField(TEXT("text"), Out.Text);
+		Out.Text.TrimStartAndEndInline();
+		Root->TryGetStringField(TEXT("character"), Out.Character);
+	}
+	else if (Out.TypeName.Equals(TEXT("call"), ESearchCase::IgnoreCase) || (Out.TypeName.IsEmpty() && DefaultType == EWebUIMessageType::Call))
+	{
+		Out.Type = EWebUIMessageType::Call;
+		ReadTarget(Root, Out);
+		Root->TryGetStringField(TEXT("method"), Out.Method);
+		Out.Args = Root->TryGetField(TEXT("args"));
+	}
+	else if (Out.TypeName.Equals(TEXT("batch"), ESearchCase::IgnoreCase))
+	{
+		Out.Type = EWebUIMessageType::Batch;
+	}
+	else if (Out.TypeName.Equals(TEXT("subscribe"), ESearchCase::IgnoreCase))
+	{
+		Out.Type = EWebUIMessageType::Subscribe;
+		ReadTarget(Root, Out);
+		Root->TryGetStringField(TEXT("property"), Out.Property);
+	}
+	else if (Out.TypeName.Equals(TEXT("unsubscribe"), ESearchCase::IgnoreCase))
+	{
+		Out.Type = EWebUIMessageType::Unsubscribe;
+	}
+	else
+	{
+		Out.Type = DefaultType;
+	}
+
+	Out.Json = Root;
+	return true;
+}
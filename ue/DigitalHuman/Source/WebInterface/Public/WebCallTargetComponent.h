@@ -0,0 +1,38 @@
+// WebCallTargetComponent.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WebCallTargetComponent.generated.h"
+
+/**
+ * 挂在 Actor 上，把 Owner 以稳定 Id 注册到 UWebInterfaceSubsystem，
+ * 前端即可用 {"target":{"by":"id","value":"<TargetId>"}} 直接定位，不用遍历关卡。
+ */
+UCLASS(ClassGroup=(WebInterface), meta=(BlueprintSpawnableComponent))
+class WEBINTERFACE_API UWebCallTargetComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UWebCallTargetComponent();
+
+	/** 前端使用的 Id；为空时使用 Owner 的名字 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "WebInterface")
+	FName TargetId;
+
+	/** 允许前端调用的 Owner 上的函数（须为 BlueprintCallable），BeginPlay 时登记到 Owner 的类 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "WebInterface")
+	TArray<FName> CallableFunctions;
+
+	/** 允许前端订阅的 Owner 上的属性（须对蓝图可见），BeginPlay 时登记到 Owner 的类 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "WebInterface")
+	TArray<FName> SubscribableProperties;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	FName GetEffectiveTargetId() const;
+};
@@ -2,11 +2,20 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "WebUIMessage.h"
 #include "WebInterfaceSubsystem.generated.h"
 
 /** 收到用户文本输入（前端发来的 chat 文本） */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUserInputReceived, const FString&, Text);
+/** 收到带会话的用户文本输入：SessionId 为空表示默认会话，Character 为空表示由调度决定 */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnSessionInputReceived, const FString&, SessionId, const FString&, Character, const FString&, Text);
+/** Pixel Streaming 有新的播放端连上（GameThread 广播），可以在这里预热 LLM / TTS 连接 */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayerConnected, const FString&, PlayerId);
+/** 前端会话关闭（租约到期或所有播放端都已断开，GameThread 广播），可以在这里丢弃该会话的排队输入 */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSessionClosed, const FString&, SessionId);
 /** 收到原始 UI 消息（原样 JSON 字符串，便于调试或扩展） */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRawMessage, const FString&, JsonString);
 
@@ -31,15 +40,131 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "WebInterface")
 	FOnUserInputReceived OnUserInputReceived;
 
+	UPROPERTY(BlueprintAssignable, Category = "WebInterface")
+	FOnSessionInputReceived OnSessionInputReceived;
+
 	UPROPERTY(BlueprintAssignable, Category = "WebInterface")
 	FOnRawMessage OnRawMessage;
 
+	UPROPERTY(BlueprintAssignable, Category = "WebInterface")
+	FOnPlayerConnected OnPlayerConnected;
+
+	UPROPERTY(BlueprintAssignable, Category = "WebInterface")
+	FOnSessionClosed OnSessionClosed;
+
+	/** 注册 call 目标（Actor 或 Component），前端用 {"by":"id","value":TargetId} O(1) 定位；Actor 销毁时自动注销 */
+	UFUNCTION(BlueprintCallable, Category = "WebInterface")
+	void RegisterCallTarget(FName TargetId, UObject* Target);
+
+	/** 注销 call 目标；Target 非空时只在 Id 仍指向它时注销 */
+	UFUNCTION(BlueprintCallable, Category = "WebInterface")
+	void UnregisterCallTarget(FName TargetId, UObject* Target = nullptr);
+
+	/** 允许前端 call Class（含子类）上的 FunctionName；函数还必须是 BlueprintCallable，未登记的一律拒绝 */
+	UFUNCTION(BlueprintCallable, Category = "WebInterface")
+	void AllowWebCall(UClass* Class, FName FunctionName);
+
+	/** 允许前端订阅 Class（含子类）上的 PropertyName；属性还必须对蓝图可见，未登记的一律拒绝 */
+	UFUNCTION(BlueprintCallable, Category = "WebInterface")
+	void AllowWebProperty(UClass* Class, FName PropertyName);
+
+	/** 发布状态值（说话中、思考中、字幕等）；订阅了该 key 的前端按各自的 maxHz 收到变化，同一帧内多次发布只发最后一次；仅 GameThread */
+	void PublishState(FName Key, const TSharedPtr<class FJsonValue>& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "WebInterface|State")
+	void PublishStateBool(FName Key, bool bValue);
+
+	UFUNCTION(BlueprintCallable, Category = "WebInterface|State")
+	void PublishStateNumber(FName Key, float Value);
+
+	UFUNCTION(BlueprintCallable, Category = "WebInterface|State")
+	void PublishStateString(FName Key, const FString& Value);
+
+
 private:
-	/** 解析 {"type":"chat","text":"..."}；成功返回 true 并输出 Text */
-	bool TryParseChatText(const FString& JsonString, FString& OutText) const;
+	/** 处理 {"type":"call", ...} 请求；无论成功与否都会回响应 */
+	void HandleCallRequest(const FWebUIMessage& Msg);
+
+	/** 处理 {"type":"batch","calls":[...]}：同一个 GameThread 任务里依次执行，合并成一个响应 */
+	void HandleBatchRequest(const FWebUIMessage& Msg);
+
+	/** 定位目标并调用；失败时 OutError 说明原因 */
+	bool ExecuteCall(const FWebUIMessage& Call, TSharedPtr<class FJsonValue>& OutResult, FString& OutError);
+
+	/** 处理 {"type":"subscribe"} / {"type":"unsubscribe"} */
+	void HandleSubscribeRequest(const FWebUIMessage& Msg);
+	void HandleUnsubscribeRequest(const FWebUIMessage& Msg);
+
+	/** 放进出站队列，本帧末尾和状态变化一起合并发送（WebInterface.CoalesceOutbound=0 时立即发送） */
+	void BroadcastResponse(const TSharedRef<class FJsonObject>& Response);
+
+	/** 每帧一次：采样订阅、收集变化，把队列里的消息合并成一帧发出 */
+	bool FlushOutbound(float DeltaTime);
 
-	/** 处理 {"type":"call", ...} 请求；返回是否已处理（无论成功与否都会回响应） */
-	void HandleCallRequest(const TSharedRef<FJsonObject>& Root);
+	/** 单条消息原样发送，多条时包成 {"type":"frame","messages":[...]} */
+	void SendFrame(TArray<TSharedPtr<class FJsonValue>>& Messages);
+
+	/** 状态订阅：Property 为空时订阅 PublishState 发布的 PublishedKey，否则订阅目标对象上的反射属性 */
+	struct FStateSubscription
+	{
+		FName PublishedKey;
+		FString TargetBy;
+		FString TargetValue;
+		FString Component;
+		FName Property;
+
+		double MinInterval = 0.0;
+		double LastSentTime = 0.0;
+		TSharedPtr<class FJsonValue> LastSent;
+
+		/** 解析出的属性所在对象和属性，对象失效后重新解析 */
+		TWeakObjectPtr<UObject> Owner;
+		const class FProperty* CachedProperty = nullptr;
+	};
+
+	/** 读取订阅的当前值；目标或属性不存在时返回 null 并写 OutError */
+	TSharedPtr<class FJsonValue> SampleSubscription(FStateSubscription& Sub, FString* OutError = nullptr);
+
+	/** 按会话（前端 sessionId）分开保存，取消订阅只影响发起的会话；内层 key 为前端取的名字 */
+	TMap<FString, TMap<FString, FStateSubscription>> Subscriptions;
+
+	/** 记录会话最近一次来消息的时间；已达 WebInterface.MaxSessions 时拒绝新会话并返回 false */
+	bool TouchSession(const FString& SessionId);
+
+	/** 丢弃会话的订阅并广播 OnSessionClosed */
+	void CloseSession(const FString& SessionId);
+
+	/** 关闭超过 WebInterface.SessionLeaseSeconds 没有消息的会话 */
+	void ExpireSessions(double Now);
+
+	TMap<FString, double> SessionLastSeen;
+	double NextSessionSweepTime = 0.0;
+	TMap<FName, TSharedPtr<class FJsonValue>> PublishedState;
+
+	TArray<TSharedPtr<class FJsonValue>> OutboundQueue;
+	FTSTicker::FDelegateHandle FlushTickerHandle;
+
+	/** PixelStreaming2 的新连接回调，可能在信令线程上 */
+	void HandleNewConnection(FString StreamerId, FString PlayerId);
+	void HandleClosedConnection(FString StreamerId, FString PlayerId);
+	FDelegateHandle NewConnectionHandle;
+	FDelegateHandle ClosedConnectionHandle;
+	TSet<FString> ConnectedPlayers;
+
+	/** 按秒限制日志条数，防止前端高频消息刷屏 */
+	struct FLogRateLimiter
+	{
+		bool Allow();
+
+		double WindowStart = 0.0;
+		int32 NumLogged = 0;
+		int32 NumSuppressed = 0;
+	};
+
+	FLogRateLimiter PayloadLogLimiter;
+	FLogRateLimiter WarningLogLimiter;
+
+	static constexpr int32 MaxLoggedPayloadChars = 512;
 
 	UPROPERTY(BlueprintAssignable, Category="WebInterface")
 	FOnSendPS2Response OnSendPS2Response;
@@ -47,9 +172,39 @@ private:
 	UFUNCTION(BlueprintCallable, Category = "WebInterface")
 	void SendPS2Response(bool bOk, const FString& RequestId, const FString& ErrorMsg, TOptional<bool> BoolResult);
 
-	/** 工具：按 tag/name 定位 Actor */
-	class AActor* FindTargetActor(const FString& By, const FString& Value) const;
+	/** 解析 call 目标：id 查注册表；tag/name 先查缓存，未命中才遍历关卡并写回缓存 */
+	UObject* ResolveCallTarget(const FString& By, const FString& Value);
+
+	/** 按名字或类名找组件，结果按 (Actor, 名字) 缓存 */
+	class UActorComponent* ResolveComponent(class AActor* Actor, const FString& NameOrClass);
+
+	/** FindFunction 结果按 (Class, 方法名) 缓存；只返回 BlueprintCallable 且经 AllowWebCall 登记过的函数 */
+	class UFunction* ResolveFunction(UObject* Target, const FString& MethodName);
+
+	/** 缓存过的 Actor 销毁时清掉相关条目 */
+	void WatchActor(class AActor* Actor);
+
+	UFUNCTION()
+	void HandleCallTargetDestroyed(class AActor* DestroyedActor);
+
+	TMap<FName, TWeakObjectPtr<UObject>> CallTargets;
+
+	/** tag/name 查询缓存，key 为 "tag:value" / "name:value"（小写） */
+	TMap<FString, TWeakObjectPtr<class AActor>> ActorLookupCache;
+
+	TMap<TPair<FObjectKey, FName>, TWeakObjectPtr<class UActorComponent>> ComponentCache;
+	TMap<TPair<FObjectKey, FName>, TWeakObjectPtr<class UFunction>> FunctionCache;
+
+	/** AllowWebCall / AllowWebProperty 登记的 (Class, 名字) */
+	TSet<TPair<FObjectKey, FName>> WebCallAllowlist;
+	TSet<TPair<FObjectKey, FName>> WebPropertyAllowlist;
+
+	/** 已绑定 OnDestroyed 的 Actor */
+	TSet<FObjectKey> WatchedActors;
 	
-	/** 工具：反射调用 UFUNCTION（可有返回值）并把返回值塞进 ResultOut（仅支持基础返回，示例覆盖 bool） */
-	bool InvokeUFunctionReturn(UObject* Target, const FString& MethodName, TSharedPtr<class FJsonValue>& ResultOut, FString& ErrorOut) const;
+	/**
+	 * 工具：反射调用 UFUNCTION。Args 为对象时按参数名、为数组时按顺序转换成参数（数字、字符串、FName、枚举、结构体、数组等）；
+	 * 只有返回值时 ResultOut 就是返回值，有输出参数时 ResultOut 为 {"ReturnValue":..., "<参数名>":...}
+	 */
+	bool InvokeUFunctionReturn(UObject* Target, class UFunction* Func, const TSharedPtr<class FJsonValue>& Args, TSharedPtr<class FJsonValue>& ResultOut, FString& ErrorOut) const;
 };
@@ -0,0 +1,57 @@
+// WebUIMessage.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+class FJsonValue;
+
+enum class EWebUIMessageType : uint8
+{
+	Invalid,	// 无法解析
+	PlainText,	// 非 JSON，整条当作聊天文本
+	Chat,		// {"type":"chat","text":"..."}
+	Call,		// {"type":"call","target":{...},"component":"...","method":"...","args":{...}|[...]}
+	Batch,		// {"type":"batch","calls":[{call}, ...]}，一次执行、一次回包
+	Subscribe,	// {"type":"subscribe","key":"...","maxHz":10[,"target":{...},"component":"...","property":"..."]}
+	Unsubscribe,// {"type":"unsubscribe","key":"..."}
+	Other,		// 其它 type（如 {"type":"keepalive"}，只用来续会话租约），按需扩展
+};
+
+/**
+ * 前端发来的 UI 消息，一次解析得到所有常用字段。
+ * 同时兼容普通 JSON 和被前端二次字符串化的 JSON（"{\"type\":...}"）。
+ */
+struct WEBINTERFACE_API FWebUIMessage
+{
+	EWebUIMessageType Type = EWebUIMessageType::Invalid;
+
+	/** 原始 type 字段 */
+	FString TypeName;
+	/** chat 文本（已去首尾空白），PlainText 时为整条消息 */
+	FString Text;
+	FString RequestId;
+	/** 用户会话（"sessionId"，没有时取 "playerId"）；为空表示默认会话 */
+	FString SessionId;
+	/** chat 指定的角色（"character"），为空时由会话调度决定 */
+	FString Character;
+
+	/** call 目标 */
+	FString TargetBy;
+	FString TargetValue;
+	FString Component;
+	FString Method;
+	/** subscribe 的属性名；为空时订阅 PublishState 发布的同名 key */
+	FString Property;
+	/** 参数：对象按参数名匹配，数组按参数顺序匹配；可为空 */
+	TSharedPtr<FJsonValue> Args;
+
+	/** 解析出的 JSON 对象，其它字段（args 等）从这里按需读取；PlainText 时为空 */
+	TSharedPtr<FJsonObject> Json;
+
+	/** 解析一条消息；返回 false 时 Out.Type 为 Invalid */
+	static bool Parse(const FString& Raw, FWebUIMessage& Out);
+
+	/** 从已解析的对象取字段；DefaultType 用于没有 type 字段的对象（如 batch 里的 call） */
+	static bool FromJsonObject(const TSharedPtr<FJsonObject>& Root, FWebUIMessage& Out, EWebUIMessageType DefaultType = EWebUIMessageType::Other);
+};
@@ -7,9 +7,44 @@ type PSAdapter = {
   onResponse: (cb: (msg: any) => void) => void;
 };
 
+// UE 端按帧合并回包：{"type":"frame","messages":[...]}；订阅推送：{"type":"state","changes":{key:value}}
+const isBridgeMessage = (msg: any) =>
+  !!msg?.requestId || msg?.type === 'frame' || msg?.type === 'state';
+
+// 每个浏览器标签页一个会话：UE 端按 sessionId 排队、分配数字人并统计延迟
+const SESSION_KEY = 'psBridge.sessionId';
+const sessionId: string = (() => {
+  try {
+    const existing = sessionStorage.getItem(SESSION_KEY);
+    if (existing) return existing;
+    const created = `${Date.now().toString(36)}-${Math.random().toString(36).slice(2)}`;
+    sessionStorage.setItem(SESSION_KEY, created);
+    return created;
+  } catch {
+    return `${Date.now().toString(36)}-${Math.random().toString(36).slice(2)}`;
+  }
+})();
+
+// 必须小于 UE 端 WebInterface.SessionLeaseSeconds
+const KEEPALIVE_INTERVAL_MS = 10000;
+
+const withSession = (data: any) =>
+  data && typeof data === 'object' && !Array.isArray(data) && data.sessionId === undefined
+    ? { ...data, sessionId }
+    : data;
+
+type SubscribeOptions = {
+  maxHz?: number;
+  // 订阅反射属性时填写；不填则订阅 UE 端 PublishState 发布的同名 key
+  target?: { by: string; value: string };
+  component?: string;
+  property?: string;
+};
+
 class PSBridge {
   private adapter: PSAdapter;
   private pending = new Map<string, (m: any) => void>();
+  private subscribers = new Map<string, Set<(value: any) => void>>();
 
   constructor(adapter: PSAdapter) {
     this.adapter = adapter;
@@ -21,21 +56,83 @@ class PSBridge {
       try {
         const msg = typeof raw === 'string' ? JSON.parse(raw) : raw;
         console.log('[PSBridge] ⬇️ Parsed response object:', msg);
-        const id = msg?.requestId;
-        if (id && this.pending.has(id)) {
-          console.log(`[PSBridge] ✅ Matched pending requestId=${id}`);
-          this.pending.get(id)!(msg);
-          this.pending.delete(id);
-        } else {
-          console.warn(`[PSBridge] ❌ No pending request found for requestId=${id}`);
-        }
+        this.dispatch(msg);
       } catch (err) {
         console.warn('[PSBridge] ⚠️ Failed to parse response:', err, raw);
       }
     });
+
+    // 页面关闭时清掉本会话在 UE 端的全部订阅
+    window.addEventListener('pagehide', () => {
+      if (this.subscribers.size > 0) this.adapter.emit(withSession({ type: 'unsubscribe', key: '*' }));
+    });
+
+    // UE 端会话有租约（WebInterface.SessionLeaseSeconds），定期续约；不打日志，避免刷屏
+    window.setInterval(() => {
+      try {
+        this.adapter.emit(withSession({ type: 'keepalive' }));
+      } catch {
+        // 流还没连上时忽略
+      }
+    }, KEEPALIVE_INTERVAL_MS);
+  }
+
+  private dispatch(msg: any) {
+    if (msg?.type === 'frame' && Array.isArray(msg.messages)) {
+      msg.messages.forEach((m: any) => this.dispatch(m));
+      return;
+    }
+
+    if (msg?.type === 'state' && msg.changes) {
+      // 推送发给所有连接，只处理本会话的订阅
+      if (msg.sessionId && msg.sessionId !== sessionId) return;
+      for (const [key, value] of Object.entries(msg.changes)) {
+        this.subscribers.get(key)?.forEach((cb) => cb(value));
+      }
+      return;
+    }
+
+    const id = msg?.requestId;
+    if (id && this.pending.has(id)) {
+      console.log(`[PSBridge] ✅ Matched pending requestId=${id}`);
+      this.pending.get(id)!(msg);
+      this.pending.delete(id);
+    } else {
+      console.warn(`[PSBridge] ❌ No pending request found for requestId=${id}`);
+    }
+  }
+
+  /**
+   * 订阅 UE 端状态：先回一次当前值，之后只在值变化时推送（不超过 maxHz）。
+   * 返回取消订阅函数；UE 端不支持订阅时 Promise 被 reject，调用方可退回轮询。
+   */
+  async subscribe<T = any>(key: string, cb: (value: T) => void, options: SubscribeOptions = {}) {
+    const initial = await this.request<T>({ type: 'subscribe', key, ...options });
+
+    let set = this.subscribers.get(key);
+    if (!set) {
+      set = new Set();
+      this.subscribers.set(key, set);
+    }
+    set.add(cb);
+    cb(initial);
+
+    return () => {
+      const current = this.subscribers.get(key);
+      current?.delete(cb);
+      if (current && current.size === 0) {
+        this.subscribers.delete(key);
+        this.send({ type: 'unsubscribe', key });
+      }
+    };
+  }
+
+  get sessionId() {
+    return sessionId;
   }
 
   send(data: any) {
+    data = withSession(data);
     const pretty = JSON.stringify(data, null, 2);
     console.log(`[PSBridge] ⬆️ Sending raw message @${new Date().toISOString()}:\n${pretty}`);
     this.adapter.emit(data);
@@ -43,7 +140,7 @@ class PSBridge {
 
   request<T = any>(payload: Record<string, any>) {
     const requestId = `${Date.now()}-${Math.random().toString(36).slice(2)}`;
-    const msg = { ...payload, requestId };
+    const msg = withSession({ ...payload, requestId });
     const pretty = JSON.stringify(msg, null, 2);
     console.log(`[PSBridge] ⬆️ Sending request @${new Date().toISOString()}:\n${pretty}`);
 
@@ -138,7 +235,7 @@ function pixelStreaming2Adapter(stream: any): PSAdapter {
       responseController.addResponseEventListener(listenerName, (response: string) => {
         console.log(`[⚡PSBridge] ⬇️ responseController received:`, response);
         const msg = safeParse(response, 'responseController');
-        if (msg?.requestId) {
+        if (isBridgeMessage(msg)) {
           console.log(`[⚡PSBridge] 📨 Forwarding responseController msg with requestId=${msg.requestId}`);
           cb(msg);
         } else {
@@ -155,7 +252,7 @@ function pixelStreaming2Adapter(stream: any): PSAdapter {
       inputHandler.addListener((type: string, payload: any) => {
         console.log(`[⚡PSBridge] ⬇️ inputHandler event "${type}" payload:`, payload);
         const msg = safeParse(payload, 'inputHandler');
-        if (msg?.requestId) cb(msg);
+        if (isBridgeMessage(msg)) cb(msg);
       });
     } else {
       console.warn('[⚡PSBridge] ❌ inputHandler.addListener not found');
@@ -167,7 +264,7 @@ function pixelStreaming2Adapter(stream: any): PSAdapter {
       messageRouter.addResponseHandler((payload: any) => {
         console.log('[⚡PSBridge] ⬇️ messageRouter received payload:', payload);
         const msg = safeParse(payload, 'messageRouter');
-        if (msg?.requestId) cb(msg);
+        if (isBridgeMessage(msg)) cb(msg);
       });
     } else {
       console.warn('[⚡PSBridge] ❌ messageRouter.addResponseHandler not found');
@@ -192,7 +289,7 @@ function pixelStreaming2Adapter(stream: any): PSAdapter {
           // 尝试解析消息
           if (typeof event.data === 'string') {
             const msg = safeParse(event.data, 'Global-DataChannel-String');
-            if (msg?.requestId) {
+            if (isBridgeMessage(msg)) {
               console.log(`[⚡PSBridge] 📨 Global intercept found requestId=${msg.requestId}`);
               cb(msg);
             }
@@ -203,7 +300,7 @@ function pixelStreaming2Adapter(stream: any): PSAdapter {
               const utf16Text = new TextDecoder('utf-16').decode(event.data.slice(1));
               console.log('[⚡PSBridge] 🔍 ArrayBuffer UTF-16 decoded:', utf16Text);
               const msg = safeParse(utf16Text, 'Global-DataChannel-UTF16');
-              if (msg?.requestId) {
+              if (isBridgeMessage(msg)) {
                 console.log(`[⚡PSBridge] 📨 Global UTF-16 found requestId=${msg.requestId}`);
                 cb(msg);
               }
@@ -213,7 +310,7 @@ function pixelStreaming2Adapter(stream: any): PSAdapter {
                 const utf8Text = new TextDecoder('utf-8').decode(event.data);
                 console.log('[⚡PSBridge] 🔍 ArrayBuffer UTF-8 decoded:', utf8Text);
                 const msg = safeParse(utf8Text, 'Global-DataChannel-UTF8');
-                if (msg?.requestId) {
+                if (isBridgeMessage(msg)) {
                   console.log(`[⚡PSBridge] 📨 Global UTF-8 found requestId=${msg.requestId}`);
                   cb(msg);
                 }
@@ -254,7 +351,7 @@ function pixelStreaming2Adapter(stream: any): PSAdapter {
         const messageHandler = (evt: MessageEvent) => {
           console.log(`[⚡PSBridge] ⬇️ Direct hook message from DataChannel "${dc.label}":`, evt.data);
           const msg = safeParse(evt.data, `DataChannel(${dc.label})`);
-          if (msg?.requestId) {
+          if (isBridgeMessage(msg)) {
             console.log(`[⚡PSBridge] 📨 Direct hook forwarding msg with requestId=${msg.requestId}`);
             cb(msg);
           }
@@ -346,7 +443,7 @@ export function arcwareAdapter(Application: any): PSAdapter {
           
           // Arcware 响应可能是字符串或对象
           const msg = safeParse(response, 'ArcwareApplication');
-          if (msg?.requestId) {
+          if (isBridgeMessage(msg)) {
             console.log(`[⚡PSBridge] 📨 Forwarding Arcware response with requestId=${msg.requestId}`);
             cb(msg);
           } else {
@@ -22,6 +22,7 @@ class GlobalStateChecker {
   private intervalId: NodeJS.Timeout | null = null;
   private nextCheckTime: number = 0;
   private isChecking: boolean = false;
+  private unsubscribe: (() => void) | null = null;
 
   // 私有构造函数，防止外部直接创建实例
   private constructor() {}
@@ -36,16 +37,44 @@ class GlobalStateChecker {
 
   init(bridge: PSBridge, setSendEnabled: (enabled: boolean) => void) {
     // 如果已经初始化过，先停止之前的检查
-    if (this.intervalId) {
+    if (this.intervalId || this.unsubscribe) {
       this.stop();
     }
     
     this.bridge = bridge;
     this.setSendEnabled = setSendEnabled;
     this.startPeriodicCheck();
+    this.trySubscribe(bridge);
     console.log('[GlobalStateChecker] 🔄 Initialized with new bridge and callback');
   }
 
+  // UE 端支持订阅时改为推送，停止轮询；不支持时继续轮询
+  private async trySubscribe(bridge: PSBridge) {
+    try {
+      const unsubscribe = await bridge.subscribe<boolean>('humanTalking', (isTalking) => {
+        this.setSendEnabled?.(!isTalking);
+      }, {
+        target: { by:'tag', value:'Avatar' },
+        component: 'HumanState',
+        property: 'bIsTalking',
+        maxHz: 10
+      });
+
+      if (this.bridge !== bridge) {
+        unsubscribe();
+        return;
+      }
+      this.unsubscribe = unsubscribe;
+      if (this.intervalId) {
+        clearInterval(this.intervalId);
+        this.intervalId = null;
+      }
+      console.log('[GlobalStateChecker] 📡 Subscribed to HumanState.bIsTalking, polling stopped');
+    } catch (error) {
+      console.warn('[GlobalStateChecker] ⚠️ Subscribe failed, keep polling:', error);
+    }
+  }
+
   private async doCheck(): Promise<boolean> {
     if (!this.bridge || !this.setSendEnabled) {
       console.warn('[GlobalStateChecker] ❌ Not initialized');
@@ -106,6 +135,10 @@ class GlobalStateChecker {
   }
 
   stop() {
+    if (this.unsubscribe) {
+      this.unsubscribe();
+      this.unsubscribe = null;
+    }
     if (this.intervalId) {
       clearInterval(this.intervalId);
       this.intervalId = null;